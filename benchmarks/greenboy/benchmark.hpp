@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace greenboy::benchmark {
+template <class Body>
+double measure(const std::string &name, std::size_t iterations, Body body) {
+  for (std::size_t i = 0; i < iterations / 10; ++i) {
+    body();
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    body();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+
+  const auto elapsed =
+      std::chrono::duration<double, std::nano>(stop - start).count();
+  const auto per_iteration = elapsed / static_cast<double>(iterations);
+  std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(2)
+            << per_iteration << " ns/op\n";
+  return per_iteration;
+}
+} // namespace greenboy::benchmark
@@ -0,0 +1,67 @@
+#include "greenboy/benchmark.hpp"
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "greenboy/data_access/byte_register.hpp"
+#include "greenboy/instructions/byte_arithmetic_operation.hpp"
+#include "greenboy/memory_bus.hpp"
+
+namespace {
+using namespace greenboy;
+using namespace instructions;
+using data_access::ByteRegister;
+
+class Memory final : public MemoryBus {
+  std::array<byte, 0x10000> m_data{};
+
+public:
+  byte read(word address) const override { return m_data[address]; }
+  void write(word address, byte value) override { m_data[address] = value; }
+};
+
+template <ByteOperation Operation>
+std::pair<double, double> compare(const std::string &name) {
+  constexpr std::size_t iterations = 20'000'000;
+  Memory memory;
+  CPU::RegisterSet registers{};
+  registers.b = byte{0x3b};
+
+  const std::unique_ptr<const Instruction> dynamic =
+      std::make_unique<ByteArithmeticOperation>(ByteRegister::a(),
+                                                ByteRegister::b(), Operation);
+  const std::unique_ptr<const Instruction> fixed =
+      std::make_unique<StaticByteArithmeticOperation<Operation>>(
+          ByteRegister::a(), ByteRegister::b());
+
+  const auto before = benchmark::measure(name + " (std::function)", iterations,
+                                         [&] {
+                                           dynamic->execute(registers, memory);
+                                           registers.b = registers.a;
+                                         });
+  const auto after = benchmark::measure(name + " (template)", iterations, [&] {
+    fixed->execute(registers, memory);
+    registers.b = registers.a;
+  });
+  return {before, after};
+}
+} // namespace
+
+int main() {
+  std::vector<std::pair<double, double>> results{
+      compare<operations::add>("ADD A,B"),
+      compare<operations::subtract>("SUB A,B"),
+      compare<operations::bitwise_and>("AND A,B"),
+      compare<operations::compare>("CP A,B"),
+      compare<operations::increment>("INC A")};
+
+  double before = 0;
+  double after = 0;
+  for (const auto &[dynamic, fixed] : results) {
+    before += dynamic;
+    after += fixed;
+  }
+  std::cout << "speedup: " << before / after << "x\n";
+}
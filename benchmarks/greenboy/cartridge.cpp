@@ -0,0 +1,108 @@
+#include "greenboy/benchmark.hpp"
+
+#include <vector>
+
+#include "greenboy/cartridge.hpp"
+#include "greenboy/memory_bus.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+
+namespace {
+using namespace greenboy;
+
+constexpr std::size_t rom_banks = 64;
+
+std::vector<byte> rom_image() {
+  std::vector<byte> image(rom_banks * 0x4000);
+  for (std::size_t i = 0; i < image.size(); ++i) {
+    image[i] = static_cast<byte>(i * 7u);
+  }
+  image[0x0147] = byte{0x01};
+  return image;
+}
+
+// An MBC1 which adds the bank offset to every read of the switchable window,
+// as a bus without a page table has to
+class OffsetMBC1 final : public MemoryBus {
+  std::vector<byte> m_rom;
+  std::vector<byte> m_ram = std::vector<byte>(0x2000);
+  std::size_t m_bank = 1;
+
+public:
+  explicit OffsetMBC1(std::vector<byte> rom) : m_rom(std::move(rom)) {}
+
+  byte read(word address) const override {
+    if (address < 0x4000) {
+      return m_rom[address];
+    }
+    if (address < 0x8000) {
+      return m_rom[m_bank * 0x4000 + (address - 0x4000u)];
+    }
+    if (address >= 0xc000 && address < 0xe000) {
+      return m_ram[address - 0xc000u];
+    }
+    return byte{0xff};
+  }
+
+  void write(word address, byte value) override {
+    if (address >= 0x2000 && address < 0x4000) {
+      const auto bank = to_integer<std::size_t>(value) & 0x1fu;
+      m_bank = (bank == 0 ? 1 : bank) % rom_banks;
+    } else if (address >= 0xc000 && address < 0xe000) {
+      m_ram[address - 0xc000u] = value;
+    }
+  }
+};
+
+// A music driver style loop: switch bank, read a few bytes, switch back
+template <class Bus> void switch_and_read(Bus &bus, unsigned &bank) {
+  bank = (bank + 1) % rom_banks;
+  bus.write(0x2000, static_cast<byte>(bank));
+  unsigned sum = 0;
+  for (word address = 0x4000; address < 0x4010; ++address) {
+    sum += to_integer<unsigned>(bus.read(address));
+  }
+  bus.write(0xc000, static_cast<byte>(sum));
+}
+
+// Reads spread over both ROM windows and WRAM through the virtual interface,
+// as a CPU which only knows a MemoryBus does
+void scattered_reads(MemoryBus &bus, const std::vector<word> &addresses) {
+  unsigned sum = 0;
+  for (const auto address : addresses) {
+    sum += to_integer<unsigned>(bus.read(address));
+  }
+  bus.write(0xc000, static_cast<byte>(sum));
+}
+
+std::vector<word> scattered_addresses() {
+  std::vector<word> addresses(256);
+  unsigned state = 1;
+  for (auto &address : addresses) {
+    state = state * 1103515245u + 12345u;
+    const auto offset = state >> 16u;
+    address = static_cast<word>(state & 0x100u ? 0xc000u + (offset & 0x1fffu)
+                                               : offset & 0x7fffu);
+  }
+  return addresses;
+}
+
+template <class Bus> void compare(const std::string &name, Bus &bus) {
+  unsigned bank = 0;
+  benchmark::measure(name + ": switch + 16 reads", 2'000'000,
+                     [&] { switch_and_read(bus, bank); });
+  const auto addresses = scattered_addresses();
+  benchmark::measure(name + ": 256 scattered reads", 1'000'000,
+                     [&] { scattered_reads(bus, addresses); });
+}
+} // namespace
+
+int main() {
+  OffsetMBC1 offset{rom_image()};
+  compare("offset", offset);
+
+  std::vector<byte> wram(0x2000);
+  PageTableMemoryBus paged;
+  paged.map(0xc000, wram.size(), wram.data());
+  cartridge::Controller::install(paged, cartridge::Rom::from(rom_image()));
+  compare("page table", paged);
+}
@@ -0,0 +1,79 @@
+#include "greenboy/benchmark.hpp"
+
+#include <array>
+#include <memory>
+
+#include "greenboy/fetch_execute_cpu.hpp"
+#include "greenboy/fusing_opcode_translator.hpp"
+#include "greenboy/memory_bus.hpp"
+#include "greenboy/table_opcode_translator.hpp"
+
+namespace {
+using namespace greenboy;
+using Idiom = FusingOpcodeTranslator::Idiom;
+
+class Memory final : public MemoryBus {
+  std::array<byte, 0x10000> m_data{};
+
+public:
+  Memory() noexcept {
+    // Copies 256 bytes and waits for LY to reach 0x90, forever
+    constexpr std::array<unsigned, 23> program{
+        0x21, 0x00, 0xd0, // LD HL,0xd000
+        0x11, 0x00, 0xd8, // LD DE,0xd800
+        0x06, 0x00,       // LD B,0
+        0x2a,             // copy: LD A,(HL+)
+        0x12,             // LD (DE),A
+        0x13,             // INC DE
+        0x05,             // DEC B
+        0x20, 0xfa,       // JR NZ,copy
+        0xf0, 0x44,       // poll: LDH A,(0x44)
+        0xfe, 0x90,       // CP 0x90
+        0x20, 0xfa,       // JR NZ,poll
+        0xc3, 0x00, 0xc0, // JP 0xc000
+    };
+    for (std::size_t i = 0; i < program.size(); ++i) {
+      m_data[0xc000 + i] = static_cast<byte>(program[i]);
+    }
+    m_data[0xff44] = byte{0x90};
+  }
+
+  byte read(word address) const override { return m_data[address]; }
+  void write(word address, byte value) override { m_data[address] = value; }
+};
+
+double run(const std::string &name,
+           std::unique_ptr<OpcodeTranslator> translator) {
+  FetchExecuteCPU cpu{std::make_unique<Memory>(), std::move(translator)};
+  cpu.registers().pc = 0xc000;
+  return benchmark::measure(name, 20'000, [&] {
+    cycles elapsed{};
+    while (elapsed < cycles{10'000}) {
+      elapsed += cpu.update();
+    }
+  });
+}
+} // namespace
+
+int main() {
+  const auto before = run("10000 cycles (unfused)",
+                          std::make_unique<TableOpcodeTranslator>());
+
+  auto fusing = std::make_unique<FusingOpcodeTranslator>(
+      std::make_unique<TableOpcodeTranslator>());
+  auto &translator = *fusing;
+  const auto after = run("10000 cycles (fused)", std::move(fusing));
+
+  std::cout << "speedup: " << before / after << "x\n";
+  constexpr std::array<std::pair<Idiom, const char *>, 5> idioms{{
+      {Idiom::CopyByte, "CopyByte"},
+      {Idiom::CopyByteAndAdvance, "CopyByteAndAdvance"},
+      {Idiom::DecrementAndBranch, "DecrementAndBranch"},
+      {Idiom::CompareAndBranch, "CompareAndBranch"},
+      {Idiom::PollAndBranch, "PollAndBranch"},
+  }};
+  for (const auto &[idiom, name] : idioms) {
+    std::cout << std::left << std::setw(40) << name << translator.hits(idiom)
+              << " hits\n";
+  }
+}
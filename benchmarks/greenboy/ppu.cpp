@@ -0,0 +1,43 @@
+#include "greenboy/benchmark.hpp"
+
+#include "greenboy/fifo_ppu.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/io_registers.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+#include "greenboy/scanline_ppu.hpp"
+
+namespace {
+using namespace greenboy;
+
+// A frame advanced one machine cycle at a time, as Gameboy::step does for
+// short instructions, with tiles and sprites all over the screen
+template <class Type> void frames(const std::string &name) {
+  PageTableMemoryBus bus;
+  auto &io = IoRegisters::install(bus);
+  Interrupts interrupts;
+  Type ppu{bus, io, interrupts};
+  unsigned state = 1;
+  for (word address = 0x8000; address < 0xa000; ++address) {
+    state = state * 1103515245u + 12345u;
+    bus.write(address, static_cast<byte>(state >> 16u));
+  }
+  for (std::size_t i = 0; i < 0xa0; ++i) {
+    ppu.oam()[i] = static_cast<byte>(i * 37u);
+  }
+  ppu.registers().lcdc = byte{0xe3};
+  ppu.registers().wx = byte{87};
+  ppu.registers().wy = byte{72};
+
+  benchmark::measure(name + ": frame", 500, [&] {
+    for (auto i = 0; i < 70224 / 4; ++i) {
+      ppu.advance(cycles{4});
+    }
+  });
+}
+} // namespace
+
+int main() {
+  frames<FifoPpu>("pixel FIFO");
+  frames<ScanlinePpu>("scanline");
+  frames<TimingPpu>("timing only");
+}
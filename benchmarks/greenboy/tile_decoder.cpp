@@ -0,0 +1,57 @@
+#include "greenboy/benchmark.hpp"
+
+#include <array>
+#include <vector>
+
+#include "greenboy/tile_decoder.hpp"
+
+namespace {
+using namespace greenboy;
+using tiles::Kernel;
+
+// The tile data of a VRAM bank
+constexpr std::size_t rows = 384 * 8;
+
+// Extracts each pixel on its own, as the renderers used to
+void decode_bit_by_bit(const byte *planes, std::uint8_t *colours,
+                       std::size_t count) {
+  for (std::size_t row = 0; row < count; ++row) {
+    const auto low = to_integer<unsigned>(planes[row * 2]);
+    const auto high = to_integer<unsigned>(planes[row * 2 + 1]);
+    for (unsigned pixel = 0; pixel < 8; ++pixel) {
+      const auto bit = 7u - pixel;
+      colours[row * 8 + pixel] = static_cast<std::uint8_t>(
+          (high >> bit & 1u) << 1u | (low >> bit & 1u));
+    }
+  }
+}
+} // namespace
+
+int main() {
+  std::vector<byte> planes(rows * 2);
+  unsigned state = 1;
+  for (auto &plane : planes) {
+    state = state * 1103515245u + 12345u;
+    plane = static_cast<byte>(state >> 16u);
+  }
+  std::vector<std::uint8_t> colours(rows * 8);
+
+  benchmark::measure("bit by bit: 384 tiles", 20'000, [&] {
+    decode_bit_by_bit(planes.data(), colours.data(), rows);
+  });
+  const std::array<std::pair<Kernel, const char *>, 3> kernels{
+      {{Kernel::Scalar, "scalar"}, {Kernel::SSE2, "SSE2"},
+       {Kernel::AVX2, "AVX2"}}};
+  for (const auto &[kernel, name] : kernels) {
+    if (!tiles::supported(kernel)) {
+      continue;
+    }
+    const auto decode = tiles::decoder(kernel);
+    benchmark::measure(std::string{name} + ": 384 tiles", 20'000,
+                       [&] { decode(planes.data(), colours.data(), rows); });
+  }
+  // A line of background, the most the scanline renderer decodes at once
+  const auto decode = tiles::decoder(tiles::fastest());
+  benchmark::measure("fastest: 21 rows", 2'000'000,
+                     [&] { decode(planes.data(), colours.data(), 21); });
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "timing.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace greenboy {
+class MemoryBus;
+
+// Straight-line blocks of instructions which have been read and decoded once.
+// A block ends at the first instruction which may transfer control, or
+// before one naming an I/O register, and is dropped again when memory it was
+// decoded from is written.
+class BlockCache {
+public:
+  struct DecodedInstruction {
+    byte opcode;
+    std::array<byte, 2> operands;
+  };
+
+  // Native code covering a run of instructions of a block
+  struct Translation {
+    void *code = nullptr;
+    std::size_t first = 0;
+    std::size_t instructions = 0;
+  };
+
+  struct Block {
+    word start;
+    word length;
+    std::vector<DecodedInstruction> instructions;
+    bool valid = true;
+    std::uint32_t executions = 0;
+    std::vector<Translation> translations;
+
+    [[nodiscard]] bool covers(word address) const noexcept;
+  };
+
+private:
+  std::unique_ptr<MemoryBus> m_memory;
+  std::vector<std::unique_ptr<Block>> m_blocks;
+  std::array<std::vector<word>, 256> m_blocks_by_page;
+  std::array<bool, 256> m_pages_with_code{};
+  std::size_t m_block_count = 0;
+  // Removed blocks are kept alive until the block being executed is done
+  std::vector<std::unique_ptr<Block>> m_retired;
+
+  void remove(word start);
+  // Drops the blocks in the windows a write to the controller at address may
+  // have switched to other memory
+  void invalidate_switched(word address);
+
+public:
+  static constexpr std::size_t max_block_length = 64;
+
+  explicit BlockCache(std::unique_ptr<MemoryBus> memory);
+
+  // The bus to execute the blocks against; writes through it invalidate the
+  // blocks they hit
+  [[nodiscard]] MemoryBus &memory() noexcept;
+  // Whether any block was decoded from each page, so writes which go around
+  // memory know which pages they may not write in place
+  [[nodiscard]] const std::array<bool, 256> &pages_with_code() const noexcept;
+
+  Block &block_at(word address);
+  void release_removed() noexcept;
+
+  // Drops the blocks a write to address may have changed, which in the
+  // cartridge area are those of the windows it may have switched
+  void invalidate(word address);
+  // Drops the blocks decoded from address only
+  void invalidate_decoded(word address);
+  void invalidate_all() noexcept;
+  [[nodiscard]] std::size_t size() const noexcept;
+};
+} // namespace greenboy
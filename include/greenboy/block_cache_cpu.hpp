@@ -0,0 +1,30 @@
+#pragma once
+#include "block_cache.hpp"
+#include "cpu.hpp"
+
+#include <memory>
+
+namespace greenboy {
+class MemoryBus;
+
+// Interprets straight-line blocks of predecoded instructions, so opcodes and
+// immediates are only read from memory once per block.
+class BlockCacheCPU final : public CPU {
+  BlockCache m_cache;
+  CPU::RegisterSet m_registers{};
+
+public:
+  explicit BlockCacheCPU(std::unique_ptr<MemoryBus> memory);
+
+  cycles update() override;
+  [[nodiscard]] word pc() const noexcept override;
+  cycles run(cycles budget) override;
+
+  void invalidate(word address);
+  void invalidate_all() noexcept;
+  [[nodiscard]] std::size_t cached_blocks() const noexcept;
+
+  [[nodiscard]] CPU::RegisterSet &registers() noexcept;
+  [[nodiscard]] const CPU::RegisterSet &registers() const noexcept;
+};
+} // namespace greenboy
@@ -0,0 +1,155 @@
+#pragma once
+#include "page_table_memory_bus.hpp"
+#include "timing.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace greenboy::cartridge {
+// Hints passed to the kernel for a mapped ROM. They are ignored where the
+// platform does not support them.
+struct MapOptions {
+  // Back the mapping with transparent huge pages
+  bool huge_pages = false;
+  // Read ahead aggressively and drop pages soon after they have been read
+  bool sequential = false;
+};
+
+// The ROM of a cartridge. The pointer keeps whatever owns the bytes alive,
+// so the image can be shared between any number of buses.
+struct Rom {
+  // The number of controllers the image is installed in. Every Rom of the
+  // same image refers to the same count, however often it is copied.
+  struct Sharers {
+    std::atomic<std::size_t> controllers{0};
+  };
+
+  std::shared_ptr<const byte> data;
+  std::size_t size = 0;
+  std::shared_ptr<Sharers> sharers = std::make_shared<Sharers>();
+
+  static Rom from(std::vector<byte> image);
+  // Maps the file read only. Every Rom mapped from the same file in the
+  // process shares one mapping, so an instance only adds the pages it
+  // touches once. The options of every call are passed on for the shared
+  // mapping, so the hints add up.
+  static Rom map(const std::string &path, MapOptions options = {});
+
+  // The bytes of the image currently resident in physical memory
+  [[nodiscard]] std::size_t resident() const;
+};
+
+// The memory a single controller accounts for. The resident ROM is shared
+// between every controller the image is installed in.
+struct MemoryUsage {
+  std::size_t rom_resident = 0;
+  std::size_t rom_sharers = 0;
+  std::size_t ram_resident = 0;
+
+  // The resident ROM split evenly between its sharers plus the private RAM
+  [[nodiscard]] std::size_t proportional() const noexcept;
+};
+
+// The external RAM of a cartridge
+struct Ram {
+  std::shared_ptr<byte> data;
+  std::size_t size = 0;
+
+  static Ram allocate(std::size_t size);
+
+  [[nodiscard]] std::size_t resident() const;
+};
+
+// Battery backed RAM kept in a save file. The file is mapped, so writes to
+// the RAM go straight to the page cache and survive the process without any
+// explicit save. Once the interval has passed, advance hands the pages
+// written since to the kernel for writing back without waiting for the disk,
+// as it runs on the emulation thread. flush waits until they are written,
+// for saving on exit, and so does destroying the last reference. Both advance
+// and flush throw when the file cannot be written back.
+class SaveFile {
+  struct Storage;
+  std::shared_ptr<Storage> m_storage;
+  cycles m_interval;
+  cycles m_since_flush{0};
+  std::uint64_t m_flushes = 0;
+
+public:
+  // The length of a frame and of a second
+  static constexpr cycles frame{70224};
+  static constexpr cycles second{4194304};
+
+  SaveFile(const std::string &path, std::size_t size,
+           cycles interval = second);
+
+  // The RAM keeps the file mapped for as long as it is referenced
+  [[nodiscard]] Ram ram() const;
+
+  void advance(cycles c);
+  void flush();
+  // Both those started by advance and by flush
+  [[nodiscard]] std::uint64_t flushes() const noexcept;
+};
+
+enum class ControllerType { None, MBC1, MBC3, MBC5 };
+
+[[nodiscard]] ControllerType controller_type(const Rom &rom);
+// The external RAM size from the cartridge header
+[[nodiscard]] std::size_t ram_size(const Rom &rom);
+
+// Maps the ROM and RAM of a cartridge into the bus and handles writes to the
+// controller registers. A bank switch remaps the pages of the switched
+// window, so reads of banked memory cost the same as any other mapped read.
+class Controller : public PageTableMemoryBus::Handler {
+  PageTableMemoryBus &m_bus;
+  PageTableMemoryBus::HandlerIndex m_index = PageTableMemoryBus::open_bus;
+  Rom m_rom;
+  Ram m_ram;
+  // The memory of every bank number a controller can select, wrapped around
+  // the size of the ROM, so a switch needs neither a division nor a check
+  std::array<const byte *, 0x200> m_rom_banks{};
+  std::size_t m_rom_bank = 1;
+  std::size_t m_ram_bank = 0;
+  bool m_ram_enabled = false;
+
+  void attach(PageTableMemoryBus::HandlerIndex index);
+  template <class Type>
+  static Controller &make(PageTableMemoryBus &bus, Rom rom, Ram ram);
+
+protected:
+  static constexpr std::size_t rom_bank_size = 0x4000;
+  static constexpr std::size_t ram_bank_size = 0x2000;
+
+  // Maps the banks selected after power on
+  virtual void power_on();
+
+  // Maps a 16 KiB ROM bank at 0x0000 or 0x4000
+  void map_rom(word address, std::size_t bank);
+  void map_ram(std::size_t bank);
+  void disable_ram();
+
+public:
+  Controller(PageTableMemoryBus &bus, Rom rom, Ram ram);
+  ~Controller() override;
+
+  // Creates the controller named in the cartridge header and maps the
+  // cartridge into the bus, which takes ownership of the controller
+  static Controller &install(PageTableMemoryBus &bus, Rom rom);
+  static Controller &install(PageTableMemoryBus &bus, Rom rom, Ram ram);
+  static Controller &install(PageTableMemoryBus &bus, ControllerType type,
+                             Rom rom, Ram ram);
+
+  byte read(word address) const override;
+
+  [[nodiscard]] std::size_t rom_bank() const noexcept;
+  [[nodiscard]] std::size_t ram_bank() const noexcept;
+  [[nodiscard]] bool ram_enabled() const noexcept;
+  [[nodiscard]] const Ram &ram() const noexcept;
+  [[nodiscard]] MemoryUsage memory_usage() const;
+};
+} // namespace greenboy::cartridge
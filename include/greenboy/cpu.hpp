@@ -3,8 +3,29 @@
 #include "timing.hpp"
 #include "types.hpp"
 
+#include <algorithm>
+#include <utility>
+
 namespace greenboy {
+struct Interrupts;
+
 class CPU {
+protected:
+  // Serviced between instructions once connected
+  Interrupts *m_interrupts = nullptr;
+  // The time the run in progress has taken so far and may take, kept where
+  // the hardware it accesses can catch up to it and cut it short. Both are
+  // zero between runs.
+  cycles m_elapsed{0};
+  cycles m_budget{0};
+
+  // Bracket the loop of a run, end_run returning the time it took
+  void begin_run(cycles budget) noexcept { m_budget = budget; }
+  cycles end_run() noexcept {
+    m_budget = cycles{0};
+    return std::exchange(m_elapsed, cycles{0});
+  }
+
 public:
   CPU() noexcept = default;
   CPU(const CPU &other) = delete;
@@ -16,6 +37,25 @@ public:
   CPU &operator=(CPU &&) = delete;
 
   virtual cycles update() = 0;
+  // Runs until at least budget has passed, or less if limited meanwhile.
+  // Cores which keep the registers in locals for the length of a run
+  // override this to do so once rather than per update.
+  virtual cycles run(cycles budget);
+  // Where the next update starts
+  [[nodiscard]] virtual word pc() const noexcept = 0;
+
+  [[nodiscard]] cycles elapsed() const noexcept { return m_elapsed; }
+  // Ends the run in progress after c more cycles if that is sooner. Block
+  // based cores only end a run between blocks.
+  void limit(cycles c) noexcept {
+    m_budget = std::min(m_budget, m_elapsed + c);
+  }
+
+  // Lets the core dispatch the requests in interrupts. Until then IF and IE
+  // are never looked at, and HALT only ends through the registers.
+  void connect(Interrupts &interrupts) noexcept {
+    m_interrupts = &interrupts;
+  }
 
   enum class R8 { B, C, D, E, H, L, A };
   enum class R16 { BC, DE, HL, SP, PC, AF };
@@ -53,6 +93,10 @@ public:
     byte l{};
     byte a{};
     Flags f{};
+    bool interrupts_enabled = false;
+    // Set by EI, which only lets interrupts in after the next instruction
+    bool interrupts_delayed = false;
+    bool halted = false;
   };
 };
 
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "greenboy/cpu.hpp"
+
+namespace greenboy::data_access::compile_time {
+// Statically composed counterparts of the runtime data access classes. An
+// access such as IndirectByte<IncrementingWord<WordRegister<CPU::R16::HL>>>
+// has no state and no virtual calls, so it inlines to straight-line code. The
+// memory type is a template parameter to let a final bus devirtualize as well.
+
+template <CPU::R8 Register> struct ByteRegister {
+  template <class Memory>
+  static byte read(CPU::RegisterSet &registers, Memory & /* memory */) {
+    if constexpr (Register == CPU::R8::B) {
+      return registers.b;
+    } else if constexpr (Register == CPU::R8::C) {
+      return registers.c;
+    } else if constexpr (Register == CPU::R8::D) {
+      return registers.d;
+    } else if constexpr (Register == CPU::R8::E) {
+      return registers.e;
+    } else if constexpr (Register == CPU::R8::H) {
+      return registers.h;
+    } else if constexpr (Register == CPU::R8::L) {
+      return registers.l;
+    } else {
+      return registers.a;
+    }
+  }
+  template <class Memory>
+  static void write(CPU::RegisterSet &registers, Memory & /* memory */,
+                    byte value) {
+    if constexpr (Register == CPU::R8::B) {
+      registers.b = value;
+    } else if constexpr (Register == CPU::R8::C) {
+      registers.c = value;
+    } else if constexpr (Register == CPU::R8::D) {
+      registers.d = value;
+    } else if constexpr (Register == CPU::R8::E) {
+      registers.e = value;
+    } else if constexpr (Register == CPU::R8::H) {
+      registers.h = value;
+    } else if constexpr (Register == CPU::R8::L) {
+      registers.l = value;
+    } else {
+      registers.a = value;
+    }
+  }
+  static constexpr cycles access_time() noexcept { return cycles{0}; }
+};
+
+template <CPU::R16 Register> struct WordRegister {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory & /* memory */) {
+    if constexpr (Register == CPU::R16::BC) {
+      return to_word(registers.b, registers.c);
+    } else if constexpr (Register == CPU::R16::DE) {
+      return to_word(registers.d, registers.e);
+    } else if constexpr (Register == CPU::R16::HL) {
+      return to_word(registers.h, registers.l);
+    } else if constexpr (Register == CPU::R16::SP) {
+      return registers.sp;
+    } else if constexpr (Register == CPU::R16::PC) {
+      return registers.pc;
+    } else {
+      return to_word(registers.a, static_cast<byte>(registers.f));
+    }
+  }
+  template <class Memory>
+  static void write(CPU::RegisterSet &registers, Memory & /* memory */,
+                    word value) {
+    if constexpr (Register == CPU::R16::BC) {
+      registers.b = high_byte(value);
+      registers.c = low_byte(value);
+    } else if constexpr (Register == CPU::R16::DE) {
+      registers.d = high_byte(value);
+      registers.e = low_byte(value);
+    } else if constexpr (Register == CPU::R16::HL) {
+      registers.h = high_byte(value);
+      registers.l = low_byte(value);
+    } else if constexpr (Register == CPU::R16::SP) {
+      registers.sp = value;
+    } else if constexpr (Register == CPU::R16::PC) {
+      registers.pc = value;
+    } else {
+      registers.a = high_byte(value);
+      registers.f = CPU::Flags(low_byte(value));
+    }
+  }
+  static constexpr cycles access_time() noexcept { return cycles{0}; }
+};
+
+template <byte Value> struct ConstantByte {
+  template <class Memory>
+  static byte read(CPU::RegisterSet & /* registers */, Memory & /* memory */) {
+    return Value;
+  }
+  static constexpr cycles access_time() noexcept { return cycles{0}; }
+};
+
+struct ImmediateByte {
+  template <class Memory>
+  static byte read(CPU::RegisterSet &registers, Memory &memory) {
+    return memory.read(registers.pc++);
+  }
+  static constexpr cycles access_time() noexcept { return cycles{4}; }
+};
+
+struct ImmediateWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto value = memory.read_word(registers.pc);
+    registers.pc = static_cast<word>(registers.pc + 2);
+    return value;
+  }
+  static constexpr cycles access_time() noexcept { return cycles{8}; }
+};
+
+struct StackWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto value = memory.read_word(registers.sp);
+    registers.sp = static_cast<word>(registers.sp + 2);
+    return value;
+  }
+  template <class Memory>
+  static void write(CPU::RegisterSet &registers, Memory &memory, word value) {
+    memory.write(--registers.sp, high_byte(value));
+    memory.write(--registers.sp, low_byte(value));
+  }
+  static constexpr cycles access_time() noexcept { return cycles{8}; }
+};
+
+struct RelativeAddress {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto offset = static_cast<std::int8_t>(memory.read(registers.pc++));
+    return static_cast<word>(registers.pc + offset);
+  }
+  static constexpr cycles access_time() noexcept { return cycles{4}; }
+};
+
+template <class Pointer> struct IndirectByte {
+  template <class Memory>
+  static byte read(CPU::RegisterSet &registers, Memory &memory) {
+    return memory.read(Pointer::read(registers, memory));
+  }
+  template <class Memory>
+  static void write(CPU::RegisterSet &registers, Memory &memory, byte value) {
+    memory.write(Pointer::read(registers, memory), value);
+  }
+  static constexpr cycles access_time() noexcept {
+    return cycles{4} + Pointer::access_time();
+  }
+};
+
+template <class Pointer> struct IndirectWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    return memory.read_word(Pointer::read(registers, memory));
+  }
+  template <class Memory>
+  static void write(CPU::RegisterSet &registers, Memory &memory, word value) {
+    memory.write_word(Pointer::read(registers, memory), value);
+  }
+  static constexpr cycles access_time() noexcept {
+    return cycles{8} + Pointer::access_time();
+  }
+};
+
+template <class Inner> struct IncrementingWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto value = Inner::read(registers, memory);
+    Inner::write(registers, memory, static_cast<word>(value + 1));
+    return value;
+  }
+  static constexpr cycles access_time() noexcept {
+    return Inner::access_time();
+  }
+};
+
+template <class Inner> struct DecrementingWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto value = Inner::read(registers, memory);
+    Inner::write(registers, memory, static_cast<word>(value - 1));
+    return value;
+  }
+  static constexpr cycles access_time() noexcept {
+    return Inner::access_time();
+  }
+};
+
+template <class Inner> struct PreIncrementingWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto value = static_cast<word>(Inner::read(registers, memory) + 1);
+    Inner::write(registers, memory, value);
+    return value;
+  }
+  static constexpr cycles access_time() noexcept {
+    return Inner::access_time();
+  }
+};
+
+template <class Inner> struct PreDecrementingWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto value = static_cast<word>(Inner::read(registers, memory) - 1);
+    Inner::write(registers, memory, value);
+    return value;
+  }
+  static constexpr cycles access_time() noexcept {
+    return Inner::access_time();
+  }
+};
+
+template <class Inner> struct DelayedWordAccess {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    return Inner::read(registers, memory);
+  }
+  template <class Memory>
+  static void write(CPU::RegisterSet &registers, Memory &memory, word value) {
+    Inner::write(registers, memory, value);
+  }
+  static constexpr cycles access_time() noexcept {
+    return cycles{4} + Inner::access_time();
+  }
+};
+
+template <class High, class Low> struct DoubleByteWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    // Order is important if the source are both immediate values
+    const auto low = Low::read(registers, memory);
+    const auto high = High::read(registers, memory);
+    return to_word(high, low);
+  }
+  template <class Memory>
+  static void write(CPU::RegisterSet &registers, Memory &memory, word value) {
+    // Order is important for push instruction
+    High::write(registers, memory, high_byte(value));
+    Low::write(registers, memory, low_byte(value));
+  }
+  static constexpr cycles access_time() noexcept {
+    return High::access_time() + Low::access_time();
+  }
+};
+
+template <class Access, class Offset> struct OffsatWord {
+  template <class Memory>
+  static word read(CPU::RegisterSet &registers, Memory &memory) {
+    const auto value = Access::read(registers, memory);
+    const auto offset_low = Offset::read(registers, memory);
+    const auto offset_high =
+        (offset_low & byte{0x80}) != byte{} ? 0xffu : 0x00u;
+
+    // Same flag semantics as the runtime OffsatWord: the low byte addition
+    // feeds its carry into the high byte addition, whose flags are kept
+    auto &f = registers.f;
+    const auto low = add(to_integer<unsigned>(low_byte(value)),
+                         to_integer<unsigned>(offset_low), f);
+    const auto high = add(to_integer<unsigned>(high_byte(value)),
+                          (offset_high + (f.carry ? 1u : 0u)) & 0xffu, f);
+    return to_word(high, low);
+  }
+  static constexpr cycles access_time() noexcept {
+    return Offset::access_time() + Access::access_time();
+  }
+
+private:
+  static byte add(unsigned a, unsigned b, CPU::Flags &f) noexcept {
+    auto result = a + b;
+    const auto carry = result ^ a ^ b;
+    result &= 0xffu;
+
+    f.zero = result == 0;
+    f.negate = false;
+    f.half_carry = (carry & (1u << 4u)) != 0;
+    f.carry = (carry & (1u << 8u)) != 0;
+
+    return byte{static_cast<uint8_t>(result)};
+  }
+};
+} // namespace greenboy::data_access::compile_time
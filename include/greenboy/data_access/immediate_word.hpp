@@ -0,0 +1,18 @@
+#pragma once
+
+#include "word_access.hpp"
+
+#include <memory>
+
+namespace greenboy::data_access {
+// The 16 bit operand following the opcode, read with a single word access
+class ImmediateWord final : public WordAccess {
+public:
+  word read(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+  void write(CPU::RegisterSet &registers, MemoryBus &memory,
+             word value) override;
+  cycles access_time() const noexcept override;
+
+  static std::shared_ptr<ImmediateWord> instance();
+};
+} // namespace greenboy::data_access
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "word_access.hpp"
+
+#include <memory>
+
+namespace greenboy::data_access {
+class PreIncrementingWord final : public WordAccess {
+  std::shared_ptr<WordAccess> m_inner;
+
+public:
+  explicit PreIncrementingWord(std::shared_ptr<WordAccess> inner);
+
+  word read(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+  void write(CPU::RegisterSet &registers, MemoryBus &memory,
+             word value) override;
+
+  static std::shared_ptr<PreIncrementingWord>
+  from(std::shared_ptr<WordAccess> inner);
+};
+} // namespace greenboy::data_access
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "word_access.hpp"
+
+#include <memory>
+
+namespace greenboy::data_access {
+class RelativeAddress final : public WordAccess {
+public:
+  word read(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+  void write(CPU::RegisterSet &registers, MemoryBus &memory,
+             word value) override;
+  cycles access_time() const override;
+
+  static std::shared_ptr<RelativeAddress> instance();
+};
+} // namespace greenboy::data_access
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "word_access.hpp"
+
+#include <memory>
+
+namespace greenboy::data_access {
+// The top of the stack. Reads pop it with a single word access, writes push
+// the high byte and then the low byte, in the order the hardware does.
+class StackWord final : public WordAccess {
+public:
+  word read(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+  void write(CPU::RegisterSet &registers, MemoryBus &memory,
+             word value) override;
+  cycles access_time() const noexcept override;
+
+  static std::shared_ptr<StackWord> instance();
+};
+} // namespace greenboy::data_access
@@ -19,6 +19,8 @@ public:
   [[nodiscard]] static std::shared_ptr<WordRegister> de();
   [[nodiscard]] static std::shared_ptr<WordRegister> hl();
   [[nodiscard]] static std::shared_ptr<WordRegister> sp();
+  [[nodiscard]] static std::shared_ptr<WordRegister> pc();
+  [[nodiscard]] static std::shared_ptr<WordRegister> af();
 };
 
 inline std::shared_ptr<WordRegister> WordRegister::bc() {
@@ -37,4 +39,12 @@ inline std::shared_ptr<WordRegister> WordRegister::sp() {
   static auto instance = std::make_shared<WordRegister>(CPU::R16::SP);
   return instance;
 }
+inline std::shared_ptr<WordRegister> WordRegister::pc() {
+  static auto instance = std::make_shared<WordRegister>(CPU::R16::PC);
+  return instance;
+}
+inline std::shared_ptr<WordRegister> WordRegister::af() {
+  static auto instance = std::make_shared<WordRegister>(CPU::R16::AF);
+  return instance;
+}
 } // namespace greenboy::data_access
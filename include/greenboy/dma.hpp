@@ -0,0 +1,77 @@
+#pragma once
+#include "timing.hpp"
+#include "types.hpp"
+
+#include <array>
+
+namespace greenboy {
+class IoRegisters;
+class PageTableMemoryBus;
+
+// OAM DMA (0xff46) and the CGB VRAM DMA (0xff51-0xff55). Each transfer is a
+// single block copy through the bus rather than a byte per machine cycle.
+// The OAM copy is made when the transfer starts, and for the 160 machine
+// cycles the hardware takes the bus is locked out, leaving the CPU only the
+// high RAM and the I/O registers.
+class Dma {
+public:
+  using Oam = std::array<byte, 0x100>;
+
+  // Only a CGB has the VRAM DMA registers
+  enum class Model : std::uint8_t { Dmg, Cgb };
+
+  static constexpr word oam_dma_address = 0xff46;
+  static constexpr word hdma1_address = 0xff51;
+  static constexpr word hdma2_address = 0xff52;
+  static constexpr word hdma3_address = 0xff53;
+  static constexpr word hdma4_address = 0xff54;
+  static constexpr word hdma5_address = 0xff55;
+
+  static constexpr cycles oam_transfer_time{640};
+
+private:
+  PageTableMemoryBus &m_bus;
+  Oam &m_oam;
+  const Model m_model;
+  byte m_oam_source{0xff};
+  cycles m_oam_remaining{0};
+
+  word m_hdma_source = 0;
+  word m_hdma_destination = 0;
+  unsigned m_hdma_blocks = 0;
+  bool m_hblank_transfer = false;
+  cycles m_stall{0};
+
+  void copy_to_vram(unsigned blocks);
+  void run_oam_transfer(cycles c);
+
+public:
+  // Connects the DMA registers of the model. OAM transfers copy into oam,
+  // which whoever maps it at 0xfe00 has to be caught up for.
+  Dma(PageTableMemoryBus &bus, IoRegisters &io, Oam &oam, Model model);
+
+  // Inline, so Gameboy::step only makes a call while the bus is locked
+  void advance(cycles c) {
+    if (m_oam_remaining > cycles{0}) {
+      run_oam_transfer(c);
+    }
+  }
+  // Copies the next 16 bytes of an HBlank transfer. The PPU calls this on
+  // entering mode 0.
+  void hblank();
+  // The cycles the CPU is halted by general purpose transfers since the last
+  // call
+  [[nodiscard]] cycles take_stall() noexcept;
+
+  [[nodiscard]] Model model() const noexcept;
+  // Whether an OAM transfer has the bus locked out
+  [[nodiscard]] bool oam_transfer() const noexcept;
+  // Whether an HBlank transfer has blocks left to copy
+  [[nodiscard]] bool hblank_transfer() const noexcept;
+
+  [[nodiscard]] byte read_oam_dma(word address) const noexcept;
+  void write_oam_dma(word address, byte value);
+  [[nodiscard]] byte read_hdma(word address) const noexcept;
+  void write_hdma(word address, byte value);
+};
+} // namespace greenboy
@@ -17,5 +17,9 @@ public:
                   std::unique_ptr<OpcodeTranslator> controlUnit) noexcept;
 
   cycles update() override;
+  [[nodiscard]] word pc() const noexcept override;
+
+  [[nodiscard]] CPU::RegisterSet &registers() noexcept;
+  [[nodiscard]] const CPU::RegisterSet &registers() const noexcept;
 };
 } // namespace greenboy
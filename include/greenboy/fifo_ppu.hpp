@@ -0,0 +1,45 @@
+#pragma once
+#include "ppu.hpp"
+
+namespace greenboy {
+// Pushes the pixels of a line out one per cycle of mode 3, as the pixel FIFO
+// does. Tiles are fetched as the line is drawn and the palettes are applied
+// as each pixel leaves the FIFO, so writes in the middle of a line, such as
+// to the palettes, the scroll or the window position, change the rest of
+// the line. The FIFO stalls while the fetcher starts the window or fetches
+// a sprite, and mode 3 ends with the last pixel.
+class FifoPpu final : public Ppu {
+  struct SpritePixel {
+    unsigned colour;
+    std::size_t sprite;
+  };
+
+  Sprites m_sprites{};
+  std::size_t m_next_sprite = 0;
+  // The sprites which have been fetched, and the dots left to fetch them
+  std::size_t m_fetched_sprites = 0;
+  SpriteStalls m_sprite_stalls{};
+  unsigned m_stall = 0;
+  std::array<SpritePixel, 8> m_sprite_fifo{};
+  // The background FIFO holds the rest of the last fetched tile row
+  std::array<std::uint8_t, 8> m_row{};
+  unsigned m_bit = 8;
+  unsigned m_fetches = 0;
+  bool m_in_window = false;
+  unsigned m_window_row = 0;
+
+  unsigned m_dots = 0;
+  unsigned m_x = 0;
+  unsigned m_discard = 0;
+
+  void begin_transfer() override;
+  void transfer(cycles elapsed) override;
+
+  void step();
+  void fetch();
+  void mix(std::size_t sprite);
+
+public:
+  FifoPpu(PageTableMemoryBus &bus, IoRegisters &io, Interrupts &interrupts);
+};
+} // namespace greenboy
@@ -0,0 +1,54 @@
+#pragma once
+#include "opcode_translator.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace greenboy {
+class Instruction;
+
+// Replaces the first opcode of common instruction sequences with a
+// superinstruction. It executes the first instruction and carries on with the
+// rest of the sequence for as long as the following opcodes match, so the
+// cycles and flags add up to those of the individual instructions. Every
+// other opcode is translated by the decorated translator.
+class FusingOpcodeTranslator final : public OpcodeTranslator {
+public:
+  enum class Idiom {
+    // LD A,(HL+); LD (DE),A
+    CopyByte,
+    // LD A,(HL+); LD (DE),A; INC DE
+    CopyByteAndAdvance,
+    // DEC r; JR NZ,e
+    DecrementAndBranch,
+    // CP n; JR cc,e
+    CompareAndBranch,
+    // LDH A,(n); CP n; JR cc,e
+    PollAndBranch
+  };
+  static constexpr std::size_t idiom_count = 5;
+  using Hits = std::array<std::uint64_t, idiom_count>;
+
+private:
+  std::unique_ptr<OpcodeTranslator> m_translator;
+  std::array<std::unique_ptr<const Instruction>, 256> m_fused;
+  Hits m_hits{};
+
+public:
+  explicit FusingOpcodeTranslator(
+      std::unique_ptr<OpcodeTranslator> translator);
+  FusingOpcodeTranslator(const FusingOpcodeTranslator &) = delete;
+  FusingOpcodeTranslator(FusingOpcodeTranslator &&) = delete;
+  ~FusingOpcodeTranslator() override;
+
+  FusingOpcodeTranslator &operator=(const FusingOpcodeTranslator &) = delete;
+  FusingOpcodeTranslator &operator=(FusingOpcodeTranslator &&) = delete;
+
+  const Instruction &translate(byte opcode) override;
+
+  // How often each idiom has been executed in full
+  [[nodiscard]] std::uint64_t hits(Idiom idiom) const noexcept;
+  void reset_hits() noexcept;
+};
+} // namespace greenboy
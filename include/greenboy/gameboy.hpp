@@ -1,17 +1,67 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 
 namespace greenboy {
 class CPU;
+class Dma;
+struct Interrupts;
+class MemoryBus;
+class PageTableMemoryBus;
+class Ppu;
+class TracingMemoryBus;
 class Video;
 
+enum class CPUCore { FetchExecute, Switch, BlockCache, Jit };
+
+// The PPU, from the most accurate and slowest to the fastest, which never
+// draws a pixel
+enum class VideoAccuracy { PixelFifo, Scanline, TimingOnly };
+
 class Gameboy {
-  const std::unique_ptr<CPU> m_cpu;
+  // The components installed into a PageTableMemoryBus along with the bus
+  struct Hardware;
+
+  // Declared first so the bus, which is owned by the CPU, goes before the
+  // components it refers to
+  const std::unique_ptr<Interrupts> m_interrupts;
   const std::unique_ptr<Video> m_video;
+  // The video if it is a Ppu, which step advances without a virtual call
+  Ppu *const m_ppu;
+  // Only installed along with the PPU
+  const std::unique_ptr<Dma> m_dma;
+  const std::unique_ptr<CPU> m_cpu;
+  // Stamped with the time and the program counter before every update
+  TracingMemoryBus *m_tracing = nullptr;
+  std::uint64_t m_cycle = 0;
+
+  static Hardware install(VideoAccuracy accuracy,
+                          std::unique_ptr<PageTableMemoryBus> memory);
+  Gameboy(CPUCore core, Hardware hardware);
 
 public:
   Gameboy(std::unique_ptr<CPU> cpu, std::unique_ptr<Video> video) noexcept;
+  Gameboy(CPUCore core, std::unique_ptr<MemoryBus> memory,
+          std::unique_ptr<Video> video);
+  // Installs the I/O registers, a PPU of the given accuracy and the DMA into
+  // memory. The DMA has the CGB VRAM transfers if the cartridge mapped in
+  // memory asks for CGB mode.
+  Gameboy(CPUCore core, VideoAccuracy accuracy,
+          std::unique_ptr<PageTableMemoryBus> memory);
+  Gameboy(const Gameboy &) = delete;
+  Gameboy(Gameboy &&) = delete;
+  ~Gameboy();
 
+  Gameboy &operator=(const Gameboy &) = delete;
+  Gameboy &operator=(Gameboy &&) = delete;
+
+  // Runs the CPU up to the next time the PPU has to catch up, or for a
+  // single update where there is no PPU or the accesses are traced
   void step();
+  // Lets the accesses recorded by memory, which has to be the bus the CPU
+  // runs on, tell which step and instruction they come from
+  void trace(TracingMemoryBus &memory) noexcept;
+
+  [[nodiscard]] Video &video() const noexcept;
 };
 } // namespace greenboy
@@ -0,0 +1,23 @@
+#pragma once
+#include <memory>
+
+#include "greenboy/instruction.hpp"
+
+namespace greenboy {
+namespace data_access {
+class ByteAccess;
+}
+
+namespace instructions {
+class BitTest final : public Instruction {
+  std::shared_ptr<const data_access::ByteAccess> m_operand;
+  byte m_mask;
+
+public:
+  BitTest(std::shared_ptr<const data_access::ByteAccess> operand,
+          unsigned bit);
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+} // namespace instructions
+} // namespace greenboy
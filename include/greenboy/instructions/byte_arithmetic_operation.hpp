@@ -25,6 +25,22 @@ public:
   cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
 };
 
+using ByteOperation = byte (*)(const byte, const byte, CPU::Flags &) noexcept;
+
+template <ByteOperation Operation>
+class StaticByteArithmeticOperation final : public Instruction {
+  std::shared_ptr<data_access::ByteAccess> m_lhs;
+  std::shared_ptr<const data_access::ByteAccess> m_rhs;
+
+public:
+  StaticByteArithmeticOperation(
+      std::shared_ptr<data_access::ByteAccess> lhs,
+      std::shared_ptr<const data_access::ByteAccess> rhs) noexcept
+      : m_lhs(std::move(lhs)), m_rhs(std::move(rhs)) {}
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+
 namespace operations {
 byte add(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
 byte add_with_carry(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
@@ -37,6 +53,33 @@ byte bitwise_xor(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
 byte compare(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
 byte increment(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
 byte decrement(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte rotate_left_circular(const byte lhs, const byte rhs,
+                          CPU::Flags &f) noexcept;
+byte rotate_right_circular(const byte lhs, const byte rhs,
+                           CPU::Flags &f) noexcept;
+byte rotate_left(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte rotate_right(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte rotate_left_circular_accumulator(const byte lhs, const byte rhs,
+                                      CPU::Flags &f) noexcept;
+byte rotate_right_circular_accumulator(const byte lhs, const byte rhs,
+                                       CPU::Flags &f) noexcept;
+byte rotate_left_accumulator(const byte lhs, const byte rhs,
+                             CPU::Flags &f) noexcept;
+byte rotate_right_accumulator(const byte lhs, const byte rhs,
+                              CPU::Flags &f) noexcept;
+byte shift_left_arithmetic(const byte lhs, const byte rhs,
+                           CPU::Flags &f) noexcept;
+byte shift_right_arithmetic(const byte lhs, const byte rhs,
+                            CPU::Flags &f) noexcept;
+byte shift_right_logical(const byte lhs, const byte rhs,
+                         CPU::Flags &f) noexcept;
+byte swap(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte reset_bits(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte set_bits(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte decimal_adjust(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte complement(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte set_carry(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
+byte complement_carry(const byte lhs, const byte rhs, CPU::Flags &f) noexcept;
 } // namespace operations
 } // namespace instructions
 } // namespace greenboy
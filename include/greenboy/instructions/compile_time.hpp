@@ -0,0 +1,20 @@
+#pragma once
+
+#include "greenboy/instruction.hpp"
+
+namespace greenboy::instructions::compile_time {
+// Load between two statically composed data accesses, see
+// greenboy/data_access/compile_time.hpp. The timing is folded to a constant.
+template <class Destination, class Source>
+class Load final : public Instruction {
+public:
+  static constexpr cycles time =
+      Destination::access_time() + Source::access_time();
+
+  cycles execute(CPU::RegisterSet &registers,
+                 MemoryBus &memory) const override {
+    Destination::write(registers, memory, Source::read(registers, memory));
+    return time;
+  }
+};
+} // namespace greenboy::instructions::compile_time
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "greenboy/cpu.hpp"
+
+namespace greenboy::instructions {
+enum class Condition { Always, NotZero, Zero, NotCarry, Carry };
+
+[[nodiscard]] constexpr bool is_satisfied(Condition condition,
+                                          const CPU::Flags &f) noexcept {
+  switch (condition) {
+  case Condition::NotZero:
+    return !f.zero;
+  case Condition::Zero:
+    return f.zero;
+  case Condition::NotCarry:
+    return !f.carry;
+  case Condition::Carry:
+    return f.carry;
+  case Condition::Always:
+  default:
+    return true;
+  }
+}
+} // namespace greenboy::instructions
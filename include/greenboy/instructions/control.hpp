@@ -0,0 +1,41 @@
+#pragma once
+#include "greenboy/instruction.hpp"
+
+namespace greenboy::instructions {
+class Nop final : public Instruction {
+public:
+  Nop() noexcept = default;
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+
+class Halt final : public Instruction {
+public:
+  Halt() noexcept = default;
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+
+class Stop final : public Instruction {
+public:
+  Stop() noexcept = default;
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+
+class InterruptMasterEnable final : public Instruction {
+  bool m_enable;
+
+public:
+  explicit InterruptMasterEnable(bool enable) noexcept;
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+
+class IllegalInstruction final : public Instruction {
+public:
+  IllegalInstruction() noexcept = default;
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+} // namespace greenboy::instructions
@@ -0,0 +1,24 @@
+#pragma once
+#include <memory>
+
+#include "condition.hpp"
+#include "greenboy/instruction.hpp"
+
+namespace greenboy {
+namespace data_access {
+class WordAccess;
+}
+
+namespace instructions {
+class Jump final : public Instruction {
+  std::shared_ptr<const data_access::WordAccess> m_target;
+  Condition m_condition;
+
+public:
+  Jump(std::shared_ptr<const data_access::WordAccess> target,
+       Condition condition);
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+} // namespace instructions
+} // namespace greenboy
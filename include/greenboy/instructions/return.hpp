@@ -0,0 +1,15 @@
+#pragma once
+#include "condition.hpp"
+#include "greenboy/instruction.hpp"
+
+namespace greenboy::instructions {
+class Return final : public Instruction {
+  Condition m_condition;
+  bool m_enable_interrupts;
+
+public:
+  Return(Condition condition, bool enable_interrupts) noexcept;
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+} // namespace greenboy::instructions
@@ -0,0 +1,32 @@
+#pragma once
+#include <functional>
+#include <memory>
+
+#include "greenboy/instruction.hpp"
+
+namespace greenboy {
+namespace data_access {
+class WordAccess;
+}
+
+namespace instructions {
+class WordArithmeticOperation final : public Instruction {
+  std::shared_ptr<data_access::WordAccess> m_lhs;
+  std::shared_ptr<const data_access::WordAccess> m_rhs;
+  std::function<word(const word, const word, CPU::Flags &)> m_operation;
+
+public:
+  WordArithmeticOperation(
+      std::shared_ptr<data_access::WordAccess> lhs,
+      std::shared_ptr<const data_access::WordAccess> rhs,
+      std::function<word(const word, const word, CPU::Flags &)>
+          operation) noexcept;
+
+  cycles execute(CPU::RegisterSet &registers, MemoryBus &memory) const override;
+};
+
+namespace operations {
+word add_words(const word lhs, const word rhs, CPU::Flags &f) noexcept;
+} // namespace operations
+} // namespace instructions
+} // namespace greenboy
@@ -0,0 +1,1081 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "greenboy/instructions/byte_arithmetic_operation.hpp"
+#include "greenboy/instructions/word_arithmetic_operation.hpp"
+#include "greenboy/lazy_flags.hpp"
+#include "greenboy/packed_register_set.hpp"
+
+namespace greenboy::interpreter {
+namespace operations = instructions::operations;
+
+using Operation = byte (*)(const byte, const byte, CPU::Flags &) noexcept;
+
+template <Operation Op>
+byte apply(CPU::Flags &flags, byte lhs, byte rhs) noexcept {
+  return Op(lhs, rhs, flags);
+}
+
+template <Operation Op>
+byte apply(LazyFlags &flags, byte lhs, byte rhs) noexcept {
+  using Kind = LazyFlags::Operation;
+  if constexpr (Op == operations::add) {
+    return flags.record(Kind::Add, lhs, rhs);
+  } else if constexpr (Op == operations::add_with_carry) {
+    return flags.record(Kind::AddWithCarry, lhs, rhs);
+  } else if constexpr (Op == operations::subtract) {
+    return flags.record(Kind::Subtract, lhs, rhs);
+  } else if constexpr (Op == operations::subtract_with_carry) {
+    return flags.record(Kind::SubtractWithCarry, lhs, rhs);
+  } else if constexpr (Op == operations::compare) {
+    flags.record(Kind::Subtract, lhs, rhs);
+    return lhs;
+  } else if constexpr (Op == operations::bitwise_and) {
+    return flags.record(Kind::And, lhs, rhs);
+  } else if constexpr (Op == operations::bitwise_or) {
+    return flags.record(Kind::Or, lhs, rhs);
+  } else if constexpr (Op == operations::bitwise_xor) {
+    return flags.record(Kind::Xor, lhs, rhs);
+  } else if constexpr (Op == operations::increment) {
+    return flags.record(Kind::Increment, lhs, rhs);
+  } else if constexpr (Op == operations::decrement) {
+    return flags.record(Kind::Decrement, lhs, rhs);
+  } else {
+    auto materialized = flags.get();
+    const auto result = Op(lhs, rhs, materialized);
+    flags.set(materialized);
+    return result;
+  }
+}
+
+inline CPU::Flags materialize(const CPU::Flags &flags) noexcept {
+  return flags;
+}
+inline CPU::Flags materialize(const LazyFlags &flags) noexcept {
+  return flags.get();
+}
+
+inline void assign(CPU::Flags &flags, CPU::Flags value) noexcept {
+  flags = value;
+}
+inline void assign(LazyFlags &flags, CPU::Flags value) noexcept {
+  flags.set(value);
+}
+
+inline bool zero(const CPU::Flags &flags) noexcept { return flags.zero; }
+inline bool zero(const LazyFlags &flags) noexcept { return flags.zero(); }
+
+inline bool carry(const CPU::Flags &flags) noexcept { return flags.carry; }
+inline bool carry(const LazyFlags &flags) noexcept { return flags.carry(); }
+
+// Operands are numbered as in the opcode encoding: B, C, D, E, H, L, (HL), A
+// for bytes and BC, DE, HL, SP for words (AF replaces SP for PUSH and POP).
+// Flags is either CPU::Flags, updated as each instruction executes, or
+// LazyFlags, which defers the flag computation until the flags are read.
+template <class Memory, class Flags> class Interpreter {
+  PackedRegisterSet &m_registers;
+  Flags &m_flags;
+  Memory &m_memory;
+
+  const byte *m_operands = nullptr;
+
+  byte fetch() {
+    if (m_operands != nullptr) {
+      ++m_registers.pc;
+      return *m_operands++;
+    }
+    return m_memory.read(m_registers.pc++);
+  }
+
+  word fetch_word() {
+    if (m_operands != nullptr) {
+      const auto low = fetch();
+      const auto high = fetch();
+      return to_word(high, low);
+    }
+    const auto value = m_memory.read_word(m_registers.pc);
+    m_registers.pc = static_cast<word>(m_registers.pc + 2);
+    return value;
+  }
+
+  [[nodiscard]] word hl() const noexcept { return m_registers.hl(); }
+
+  void set_hl(word value) noexcept { m_registers.hl() = value; }
+
+  template <unsigned Index> byte read_operand() {
+    if constexpr (Index == 0) {
+      return m_registers.b();
+    } else if constexpr (Index == 1) {
+      return m_registers.c();
+    } else if constexpr (Index == 2) {
+      return m_registers.d();
+    } else if constexpr (Index == 3) {
+      return m_registers.e();
+    } else if constexpr (Index == 4) {
+      return m_registers.h();
+    } else if constexpr (Index == 5) {
+      return m_registers.l();
+    } else if constexpr (Index == 6) {
+      return m_memory.read(hl());
+    } else {
+      return m_registers.a();
+    }
+  }
+
+  template <unsigned Index> void write_operand(byte value) {
+    if constexpr (Index == 0) {
+      m_registers.set_b(value);
+    } else if constexpr (Index == 1) {
+      m_registers.set_c(value);
+    } else if constexpr (Index == 2) {
+      m_registers.set_d(value);
+    } else if constexpr (Index == 3) {
+      m_registers.set_e(value);
+    } else if constexpr (Index == 4) {
+      m_registers.set_h(value);
+    } else if constexpr (Index == 5) {
+      m_registers.set_l(value);
+    } else if constexpr (Index == 6) {
+      m_memory.write(hl(), value);
+    } else {
+      m_registers.set_a(value);
+    }
+  }
+
+  template <unsigned Index> [[nodiscard]] word read_pair() const noexcept {
+    if constexpr (Index == 0) {
+      return m_registers.bc();
+    } else if constexpr (Index == 1) {
+      return m_registers.de();
+    } else if constexpr (Index == 2) {
+      return hl();
+    } else {
+      return m_registers.sp;
+    }
+  }
+
+  template <unsigned Index> void write_pair(word value) noexcept {
+    if constexpr (Index == 0) {
+      m_registers.bc() = value;
+    } else if constexpr (Index == 1) {
+      m_registers.de() = value;
+    } else if constexpr (Index == 2) {
+      set_hl(value);
+    } else {
+      m_registers.sp = value;
+    }
+  }
+
+  template <unsigned Index> [[nodiscard]] bool condition() const noexcept {
+    if constexpr (Index == 0) {
+      return !zero(m_flags);
+    } else if constexpr (Index == 1) {
+      return zero(m_flags);
+    } else if constexpr (Index == 2) {
+      return !carry(m_flags);
+    } else {
+      return carry(m_flags);
+    }
+  }
+
+  void push(word value) {
+    m_memory.write(--m_registers.sp, high_byte(value));
+    m_memory.write(--m_registers.sp, low_byte(value));
+  }
+
+  word pop() {
+    const auto value = m_memory.read_word(m_registers.sp);
+    m_registers.sp = static_cast<word>(m_registers.sp + 2);
+    return value;
+  }
+
+  template <unsigned Destination, unsigned Source> cycles load() {
+    write_operand<Destination>(read_operand<Source>());
+    return Destination == 6 || Source == 6 ? cycles{8} : cycles{4};
+  }
+
+  template <Operation Op, unsigned Source> cycles arithmetic() {
+    const auto lhs = m_registers.a();
+    m_registers.set_a(apply<Op>(m_flags, lhs, read_operand<Source>()));
+    return Source == 6 ? cycles{8} : cycles{4};
+  }
+
+  template <Operation Op> cycles arithmetic_immediate() {
+    const auto lhs = m_registers.a();
+    m_registers.set_a(apply<Op>(m_flags, lhs, fetch()));
+    return cycles{8};
+  }
+
+  template <Operation Op, unsigned Index> void modify(byte rhs) {
+    write_operand<Index>(apply<Op>(m_flags, read_operand<Index>(), rhs));
+  }
+
+  template <Operation Op> cycles modify_accumulator() {
+    m_registers.set_a(apply<Op>(m_flags, m_registers.a(), byte{}));
+    return cycles{4};
+  }
+
+  template <unsigned Index> cycles increment() {
+    modify<operations::increment, Index>(byte{1});
+    return Index == 6 ? cycles{12} : cycles{4};
+  }
+
+  template <unsigned Index> cycles decrement() {
+    modify<operations::decrement, Index>(byte{1});
+    return Index == 6 ? cycles{12} : cycles{4};
+  }
+
+  template <unsigned Index> cycles load_immediate() {
+    write_operand<Index>(fetch());
+    return Index == 6 ? cycles{12} : cycles{8};
+  }
+
+  template <unsigned Index> cycles add_to_hl() {
+    const auto lhs = hl();
+    auto flags = materialize(m_flags);
+    set_hl(operations::add_words(lhs, read_pair<Index>(), flags));
+    assign(m_flags, flags);
+    return cycles{8};
+  }
+
+  word offset_stack_pointer() {
+    // Mirrors data_access::OffsatWord, which reports the flags of the upper
+    // byte addition
+    const auto value = m_registers.sp;
+    const auto offset = fetch();
+    const auto offset_high =
+        (offset & byte{0x80}) != byte{} ? byte{0xff} : byte{0x00};
+    auto flags = materialize(m_flags);
+    const auto low = operations::add(low_byte(value), offset, flags);
+    const auto high = operations::add(
+        high_byte(value),
+        static_cast<byte>(to_integer<unsigned>(offset_high) +
+                          (flags.carry ? 1u : 0u)),
+        flags);
+    assign(m_flags, flags);
+    return to_word(high, low);
+  }
+
+  cycles jump_relative(bool taken) {
+    const auto offset = static_cast<std::int8_t>(fetch());
+    if (!taken) {
+      return cycles{8};
+    }
+    m_registers.pc = static_cast<word>(m_registers.pc + offset);
+    return cycles{12};
+  }
+
+  cycles jump(bool taken) {
+    const auto target = fetch_word();
+    if (!taken) {
+      return cycles{12};
+    }
+    m_registers.pc = target;
+    return cycles{16};
+  }
+
+  cycles call(bool taken) {
+    const auto target = fetch_word();
+    if (!taken) {
+      return cycles{12};
+    }
+    push(m_registers.pc);
+    m_registers.pc = target;
+    return cycles{24};
+  }
+
+  cycles conditional_return(bool taken) {
+    if (!taken) {
+      return cycles{8};
+    }
+    m_registers.pc = pop();
+    return cycles{20};
+  }
+
+  cycles restart(word vector) {
+    push(m_registers.pc);
+    m_registers.pc = vector;
+    return cycles{16};
+  }
+
+  template <unsigned Index> cycles prefixed(unsigned operation) {
+    constexpr auto modify_time = Index == 6 ? cycles{12} : cycles{4};
+    const auto mask = static_cast<byte>(1u << (operation & 7u));
+    switch (operation) {
+    case 0:
+      modify<operations::rotate_left_circular, Index>(byte{});
+      return modify_time;
+    case 1:
+      modify<operations::rotate_right_circular, Index>(byte{});
+      return modify_time;
+    case 2:
+      modify<operations::rotate_left, Index>(byte{});
+      return modify_time;
+    case 3:
+      modify<operations::rotate_right, Index>(byte{});
+      return modify_time;
+    case 4:
+      modify<operations::shift_left_arithmetic, Index>(byte{});
+      return modify_time;
+    case 5:
+      modify<operations::shift_right_arithmetic, Index>(byte{});
+      return modify_time;
+    case 6:
+      modify<operations::swap, Index>(byte{});
+      return modify_time;
+    case 7:
+      modify<operations::shift_right_logical, Index>(byte{});
+      return modify_time;
+    default:
+      break;
+    }
+    if (operation < 16) {
+      auto flags = materialize(m_flags);
+      flags.zero = (read_operand<Index>() & mask) == byte{};
+      flags.negate = false;
+      flags.half_carry = true;
+      assign(m_flags, flags);
+      return Index == 6 ? cycles{8} : cycles{4};
+    }
+    if (operation < 24) {
+      modify<operations::reset_bits, Index>(mask);
+    } else {
+      modify<operations::set_bits, Index>(mask);
+    }
+    return modify_time;
+  }
+
+  cycles execute_prefixed() {
+    const auto opcode = to_integer<unsigned>(fetch());
+    const auto operation = opcode >> 3u;
+    switch (opcode & 7u) {
+    case 0:
+      return prefixed<0>(operation);
+    case 1:
+      return prefixed<1>(operation);
+    case 2:
+      return prefixed<2>(operation);
+    case 3:
+      return prefixed<3>(operation);
+    case 4:
+      return prefixed<4>(operation);
+    case 5:
+      return prefixed<5>(operation);
+    case 6:
+      return prefixed<6>(operation);
+    default:
+      return prefixed<7>(operation);
+    }
+  }
+
+public:
+  Interpreter(PackedRegisterSet &registers, Flags &flags,
+              Memory &memory) noexcept
+      : m_registers(registers), m_flags(flags), m_memory(memory) {}
+
+  cycles step() {
+    if (m_registers.halted) {
+      return cycles{4};
+    }
+    return execute(fetch());
+  }
+
+  // Executes an instruction whose bytes have already been read from memory.
+  // The opcode and operands must be the ones at pc.
+  cycles execute(byte opcode, const byte *operands) {
+    ++m_registers.pc;
+    m_operands = operands;
+    const auto time = execute(opcode);
+    m_operands = nullptr;
+    return time;
+  }
+
+  cycles execute(byte opcode) {
+    switch (to_integer<unsigned>(opcode)) {
+    case 0x00:
+      return cycles{4};
+    case 0x01:
+      write_pair<0>(fetch_word());
+      return cycles{12};
+    case 0x02:
+      m_memory.write(read_pair<0>(), m_registers.a());
+      return cycles{8};
+    case 0x03:
+      write_pair<0>(static_cast<word>(read_pair<0>() + 1));
+      return cycles{8};
+    case 0x04:
+      return increment<0>();
+    case 0x05:
+      return decrement<0>();
+    case 0x06:
+      return load_immediate<0>();
+    case 0x07:
+      return modify_accumulator<operations::rotate_left_circular_accumulator>();
+    case 0x08: {
+      m_memory.write_word(fetch_word(), m_registers.sp);
+      return cycles{20};
+    }
+    case 0x09:
+      return add_to_hl<0>();
+    case 0x0a:
+      m_registers.set_a(m_memory.read(read_pair<0>()));
+      return cycles{8};
+    case 0x0b:
+      write_pair<0>(static_cast<word>(read_pair<0>() - 1));
+      return cycles{8};
+    case 0x0c:
+      return increment<1>();
+    case 0x0d:
+      return decrement<1>();
+    case 0x0e:
+      return load_immediate<1>();
+    case 0x0f:
+      return modify_accumulator<
+          operations::rotate_right_circular_accumulator>();
+    case 0x10:
+      ++m_registers.pc;
+      m_registers.halted = true;
+      return cycles{4};
+    case 0x11:
+      write_pair<1>(fetch_word());
+      return cycles{12};
+    case 0x12:
+      m_memory.write(read_pair<1>(), m_registers.a());
+      return cycles{8};
+    case 0x13:
+      write_pair<1>(static_cast<word>(read_pair<1>() + 1));
+      return cycles{8};
+    case 0x14:
+      return increment<2>();
+    case 0x15:
+      return decrement<2>();
+    case 0x16:
+      return load_immediate<2>();
+    case 0x17:
+      return modify_accumulator<operations::rotate_left_accumulator>();
+    case 0x18:
+      return jump_relative(true);
+    case 0x19:
+      return add_to_hl<1>();
+    case 0x1a:
+      m_registers.set_a(m_memory.read(read_pair<1>()));
+      return cycles{8};
+    case 0x1b:
+      write_pair<1>(static_cast<word>(read_pair<1>() - 1));
+      return cycles{8};
+    case 0x1c:
+      return increment<3>();
+    case 0x1d:
+      return decrement<3>();
+    case 0x1e:
+      return load_immediate<3>();
+    case 0x1f:
+      return modify_accumulator<operations::rotate_right_accumulator>();
+    case 0x20:
+      return jump_relative(condition<0>());
+    case 0x21:
+      write_pair<2>(fetch_word());
+      return cycles{12};
+    case 0x22: {
+      const auto address = hl();
+      set_hl(static_cast<word>(address + 1));
+      m_memory.write(address, m_registers.a());
+      return cycles{8};
+    }
+    case 0x23:
+      write_pair<2>(static_cast<word>(read_pair<2>() + 1));
+      return cycles{8};
+    case 0x24:
+      return increment<4>();
+    case 0x25:
+      return decrement<4>();
+    case 0x26:
+      return load_immediate<4>();
+    case 0x27:
+      return modify_accumulator<operations::decimal_adjust>();
+    case 0x28:
+      return jump_relative(condition<1>());
+    case 0x29:
+      return add_to_hl<2>();
+    case 0x2a: {
+      const auto address = hl();
+      set_hl(static_cast<word>(address + 1));
+      m_registers.set_a(m_memory.read(address));
+      return cycles{8};
+    }
+    case 0x2b:
+      write_pair<2>(static_cast<word>(read_pair<2>() - 1));
+      return cycles{8};
+    case 0x2c:
+      return increment<5>();
+    case 0x2d:
+      return decrement<5>();
+    case 0x2e:
+      return load_immediate<5>();
+    case 0x2f:
+      return modify_accumulator<operations::complement>();
+    case 0x30:
+      return jump_relative(condition<2>());
+    case 0x31:
+      write_pair<3>(fetch_word());
+      return cycles{12};
+    case 0x32: {
+      const auto address = hl();
+      set_hl(static_cast<word>(address - 1));
+      m_memory.write(address, m_registers.a());
+      return cycles{8};
+    }
+    case 0x33:
+      write_pair<3>(static_cast<word>(read_pair<3>() + 1));
+      return cycles{8};
+    case 0x34:
+      return increment<6>();
+    case 0x35:
+      return decrement<6>();
+    case 0x36:
+      return load_immediate<6>();
+    case 0x37:
+      return modify_accumulator<operations::set_carry>();
+    case 0x38:
+      return jump_relative(condition<3>());
+    case 0x39:
+      return add_to_hl<3>();
+    case 0x3a: {
+      const auto address = hl();
+      set_hl(static_cast<word>(address - 1));
+      m_registers.set_a(m_memory.read(address));
+      return cycles{8};
+    }
+    case 0x3b:
+      write_pair<3>(static_cast<word>(read_pair<3>() - 1));
+      return cycles{8};
+    case 0x3c:
+      return increment<7>();
+    case 0x3d:
+      return decrement<7>();
+    case 0x3e:
+      return load_immediate<7>();
+    case 0x3f:
+      return modify_accumulator<operations::complement_carry>();
+    case 0x40:
+      return load<0, 0>();
+    case 0x41:
+      return load<0, 1>();
+    case 0x42:
+      return load<0, 2>();
+    case 0x43:
+      return load<0, 3>();
+    case 0x44:
+      return load<0, 4>();
+    case 0x45:
+      return load<0, 5>();
+    case 0x46:
+      return load<0, 6>();
+    case 0x47:
+      return load<0, 7>();
+    case 0x48:
+      return load<1, 0>();
+    case 0x49:
+      return load<1, 1>();
+    case 0x4a:
+      return load<1, 2>();
+    case 0x4b:
+      return load<1, 3>();
+    case 0x4c:
+      return load<1, 4>();
+    case 0x4d:
+      return load<1, 5>();
+    case 0x4e:
+      return load<1, 6>();
+    case 0x4f:
+      return load<1, 7>();
+    case 0x50:
+      return load<2, 0>();
+    case 0x51:
+      return load<2, 1>();
+    case 0x52:
+      return load<2, 2>();
+    case 0x53:
+      return load<2, 3>();
+    case 0x54:
+      return load<2, 4>();
+    case 0x55:
+      return load<2, 5>();
+    case 0x56:
+      return load<2, 6>();
+    case 0x57:
+      return load<2, 7>();
+    case 0x58:
+      return load<3, 0>();
+    case 0x59:
+      return load<3, 1>();
+    case 0x5a:
+      return load<3, 2>();
+    case 0x5b:
+      return load<3, 3>();
+    case 0x5c:
+      return load<3, 4>();
+    case 0x5d:
+      return load<3, 5>();
+    case 0x5e:
+      return load<3, 6>();
+    case 0x5f:
+      return load<3, 7>();
+    case 0x60:
+      return load<4, 0>();
+    case 0x61:
+      return load<4, 1>();
+    case 0x62:
+      return load<4, 2>();
+    case 0x63:
+      return load<4, 3>();
+    case 0x64:
+      return load<4, 4>();
+    case 0x65:
+      return load<4, 5>();
+    case 0x66:
+      return load<4, 6>();
+    case 0x67:
+      return load<4, 7>();
+    case 0x68:
+      return load<5, 0>();
+    case 0x69:
+      return load<5, 1>();
+    case 0x6a:
+      return load<5, 2>();
+    case 0x6b:
+      return load<5, 3>();
+    case 0x6c:
+      return load<5, 4>();
+    case 0x6d:
+      return load<5, 5>();
+    case 0x6e:
+      return load<5, 6>();
+    case 0x6f:
+      return load<5, 7>();
+    case 0x70:
+      return load<6, 0>();
+    case 0x71:
+      return load<6, 1>();
+    case 0x72:
+      return load<6, 2>();
+    case 0x73:
+      return load<6, 3>();
+    case 0x74:
+      return load<6, 4>();
+    case 0x75:
+      return load<6, 5>();
+    case 0x76:
+      m_registers.halted = true;
+      return cycles{4};
+    case 0x77:
+      return load<6, 7>();
+    case 0x78:
+      return load<7, 0>();
+    case 0x79:
+      return load<7, 1>();
+    case 0x7a:
+      return load<7, 2>();
+    case 0x7b:
+      return load<7, 3>();
+    case 0x7c:
+      return load<7, 4>();
+    case 0x7d:
+      return load<7, 5>();
+    case 0x7e:
+      return load<7, 6>();
+    case 0x7f:
+      return load<7, 7>();
+    case 0x80:
+      return arithmetic<operations::add, 0>();
+    case 0x81:
+      return arithmetic<operations::add, 1>();
+    case 0x82:
+      return arithmetic<operations::add, 2>();
+    case 0x83:
+      return arithmetic<operations::add, 3>();
+    case 0x84:
+      return arithmetic<operations::add, 4>();
+    case 0x85:
+      return arithmetic<operations::add, 5>();
+    case 0x86:
+      return arithmetic<operations::add, 6>();
+    case 0x87:
+      return arithmetic<operations::add, 7>();
+    case 0x88:
+      return arithmetic<operations::add_with_carry, 0>();
+    case 0x89:
+      return arithmetic<operations::add_with_carry, 1>();
+    case 0x8a:
+      return arithmetic<operations::add_with_carry, 2>();
+    case 0x8b:
+      return arithmetic<operations::add_with_carry, 3>();
+    case 0x8c:
+      return arithmetic<operations::add_with_carry, 4>();
+    case 0x8d:
+      return arithmetic<operations::add_with_carry, 5>();
+    case 0x8e:
+      return arithmetic<operations::add_with_carry, 6>();
+    case 0x8f:
+      return arithmetic<operations::add_with_carry, 7>();
+    case 0x90:
+      return arithmetic<operations::subtract, 0>();
+    case 0x91:
+      return arithmetic<operations::subtract, 1>();
+    case 0x92:
+      return arithmetic<operations::subtract, 2>();
+    case 0x93:
+      return arithmetic<operations::subtract, 3>();
+    case 0x94:
+      return arithmetic<operations::subtract, 4>();
+    case 0x95:
+      return arithmetic<operations::subtract, 5>();
+    case 0x96:
+      return arithmetic<operations::subtract, 6>();
+    case 0x97:
+      return arithmetic<operations::subtract, 7>();
+    case 0x98:
+      return arithmetic<operations::subtract_with_carry, 0>();
+    case 0x99:
+      return arithmetic<operations::subtract_with_carry, 1>();
+    case 0x9a:
+      return arithmetic<operations::subtract_with_carry, 2>();
+    case 0x9b:
+      return arithmetic<operations::subtract_with_carry, 3>();
+    case 0x9c:
+      return arithmetic<operations::subtract_with_carry, 4>();
+    case 0x9d:
+      return arithmetic<operations::subtract_with_carry, 5>();
+    case 0x9e:
+      return arithmetic<operations::subtract_with_carry, 6>();
+    case 0x9f:
+      return arithmetic<operations::subtract_with_carry, 7>();
+    case 0xa0:
+      return arithmetic<operations::bitwise_and, 0>();
+    case 0xa1:
+      return arithmetic<operations::bitwise_and, 1>();
+    case 0xa2:
+      return arithmetic<operations::bitwise_and, 2>();
+    case 0xa3:
+      return arithmetic<operations::bitwise_and, 3>();
+    case 0xa4:
+      return arithmetic<operations::bitwise_and, 4>();
+    case 0xa5:
+      return arithmetic<operations::bitwise_and, 5>();
+    case 0xa6:
+      return arithmetic<operations::bitwise_and, 6>();
+    case 0xa7:
+      return arithmetic<operations::bitwise_and, 7>();
+    case 0xa8:
+      return arithmetic<operations::bitwise_xor, 0>();
+    case 0xa9:
+      return arithmetic<operations::bitwise_xor, 1>();
+    case 0xaa:
+      return arithmetic<operations::bitwise_xor, 2>();
+    case 0xab:
+      return arithmetic<operations::bitwise_xor, 3>();
+    case 0xac:
+      return arithmetic<operations::bitwise_xor, 4>();
+    case 0xad:
+      return arithmetic<operations::bitwise_xor, 5>();
+    case 0xae:
+      return arithmetic<operations::bitwise_xor, 6>();
+    case 0xaf:
+      return arithmetic<operations::bitwise_xor, 7>();
+    case 0xb0:
+      return arithmetic<operations::bitwise_or, 0>();
+    case 0xb1:
+      return arithmetic<operations::bitwise_or, 1>();
+    case 0xb2:
+      return arithmetic<operations::bitwise_or, 2>();
+    case 0xb3:
+      return arithmetic<operations::bitwise_or, 3>();
+    case 0xb4:
+      return arithmetic<operations::bitwise_or, 4>();
+    case 0xb5:
+      return arithmetic<operations::bitwise_or, 5>();
+    case 0xb6:
+      return arithmetic<operations::bitwise_or, 6>();
+    case 0xb7:
+      return arithmetic<operations::bitwise_or, 7>();
+    case 0xb8:
+      return arithmetic<operations::compare, 0>();
+    case 0xb9:
+      return arithmetic<operations::compare, 1>();
+    case 0xba:
+      return arithmetic<operations::compare, 2>();
+    case 0xbb:
+      return arithmetic<operations::compare, 3>();
+    case 0xbc:
+      return arithmetic<operations::compare, 4>();
+    case 0xbd:
+      return arithmetic<operations::compare, 5>();
+    case 0xbe:
+      return arithmetic<operations::compare, 6>();
+    case 0xbf:
+      return arithmetic<operations::compare, 7>();
+    case 0xc0:
+      return conditional_return(condition<0>());
+    case 0xc1:
+      write_pair<0>(pop());
+      return cycles{12};
+    case 0xc2:
+      return jump(condition<0>());
+    case 0xc3:
+      return jump(true);
+    case 0xc4:
+      return call(condition<0>());
+    case 0xc5:
+      push(read_pair<0>());
+      return cycles{16};
+    case 0xc6:
+      return arithmetic_immediate<operations::add>();
+    case 0xc7:
+      return restart(0x00);
+    case 0xc8:
+      return conditional_return(condition<1>());
+    case 0xc9:
+      m_registers.pc = pop();
+      return cycles{16};
+    case 0xca:
+      return jump(condition<1>());
+    case 0xcb:
+      return cycles{4} + execute_prefixed();
+    case 0xcc:
+      return call(condition<1>());
+    case 0xcd:
+      return call(true);
+    case 0xce:
+      return arithmetic_immediate<operations::add_with_carry>();
+    case 0xcf:
+      return restart(0x08);
+    case 0xd0:
+      return conditional_return(condition<2>());
+    case 0xd1:
+      write_pair<1>(pop());
+      return cycles{12};
+    case 0xd2:
+      return jump(condition<2>());
+    case 0xd4:
+      return call(condition<2>());
+    case 0xd5:
+      push(read_pair<1>());
+      return cycles{16};
+    case 0xd6:
+      return arithmetic_immediate<operations::subtract>();
+    case 0xd7:
+      return restart(0x10);
+    case 0xd8:
+      return conditional_return(condition<3>());
+    case 0xd9:
+      m_registers.pc = pop();
+      m_registers.interrupts_enabled = true;
+      return cycles{16};
+    case 0xda:
+      return jump(condition<3>());
+    case 0xdc:
+      return call(condition<3>());
+    case 0xde:
+      return arithmetic_immediate<operations::subtract_with_carry>();
+    case 0xdf:
+      return restart(0x18);
+    case 0xe0:
+      m_memory.write(to_word(byte{0xff}, fetch()), m_registers.a());
+      return cycles{12};
+    case 0xe1:
+      write_pair<2>(pop());
+      return cycles{12};
+    case 0xe2:
+      m_memory.write(to_word(byte{0xff}, m_registers.c()), m_registers.a());
+      return cycles{8};
+    case 0xe5:
+      push(read_pair<2>());
+      return cycles{16};
+    case 0xe6:
+      return arithmetic_immediate<operations::bitwise_and>();
+    case 0xe7:
+      return restart(0x20);
+    case 0xe8:
+      m_registers.sp = offset_stack_pointer();
+      return cycles{16};
+    case 0xe9:
+      m_registers.pc = hl();
+      return cycles{4};
+    case 0xea:
+      m_memory.write(fetch_word(), m_registers.a());
+      return cycles{16};
+    case 0xee:
+      return arithmetic_immediate<operations::bitwise_xor>();
+    case 0xef:
+      return restart(0x28);
+    case 0xf0:
+      m_registers.set_a(m_memory.read(to_word(byte{0xff}, fetch())));
+      return cycles{12};
+    case 0xf1: {
+      const auto value = pop();
+      m_registers.set_a(high_byte(value));
+      assign(m_flags, CPU::Flags{low_byte(value)});
+      return cycles{12};
+    }
+    case 0xf2:
+      m_registers.set_a(m_memory.read(to_word(byte{0xff}, m_registers.c())));
+      return cycles{8};
+    case 0xf3:
+      m_registers.interrupts_enabled = false;
+      return cycles{4};
+    case 0xf5:
+      push(to_word(m_registers.a(), static_cast<byte>(materialize(m_flags))));
+      return cycles{16};
+    case 0xf6:
+      return arithmetic_immediate<operations::bitwise_or>();
+    case 0xf7:
+      return restart(0x30);
+    case 0xf8:
+      set_hl(offset_stack_pointer());
+      return cycles{12};
+    case 0xf9:
+      m_registers.sp = hl();
+      return cycles{8};
+    case 0xfa:
+      m_registers.set_a(m_memory.read(fetch_word()));
+      return cycles{16};
+    case 0xfb:
+      m_registers.interrupts_enabled = true;
+      m_registers.interrupts_delayed = true;
+      return cycles{4};
+    case 0xfe:
+      return arithmetic_immediate<operations::compare>();
+    case 0xff:
+      return restart(0x38);
+    default:
+      throw std::runtime_error("Tried to execute an illegal opcode");
+    }
+  }
+};
+
+[[nodiscard]] constexpr unsigned instruction_length(byte opcode) noexcept {
+  switch (to_integer<unsigned>(opcode)) {
+  case 0x01:
+  case 0x08:
+  case 0x11:
+  case 0x21:
+  case 0x31:
+  case 0xc2:
+  case 0xc3:
+  case 0xc4:
+  case 0xca:
+  case 0xcc:
+  case 0xcd:
+  case 0xd2:
+  case 0xd4:
+  case 0xda:
+  case 0xdc:
+  case 0xea:
+  case 0xfa:
+    return 3;
+  case 0x06:
+  case 0x0e:
+  case 0x10:
+  case 0x16:
+  case 0x18:
+  case 0x1e:
+  case 0x20:
+  case 0x26:
+  case 0x28:
+  case 0x2e:
+  case 0x30:
+  case 0x36:
+  case 0x38:
+  case 0x3e:
+  case 0xc6:
+  case 0xcb:
+  case 0xce:
+  case 0xd6:
+  case 0xde:
+  case 0xe0:
+  case 0xe6:
+  case 0xe8:
+  case 0xee:
+  case 0xf0:
+  case 0xf6:
+  case 0xf8:
+  case 0xfe:
+    return 2;
+  default:
+    return 1;
+  }
+}
+
+// True for instructions after which execution may continue anywhere but the
+// next instruction: jumps, calls, returns, restarts, HALT, STOP and illegal
+// opcodes.
+[[nodiscard]] constexpr bool ends_block(byte opcode) noexcept {
+  switch (to_integer<unsigned>(opcode)) {
+  case 0x10:
+  case 0x18:
+  case 0x20:
+  case 0x28:
+  case 0x30:
+  case 0x38:
+  case 0x76:
+  case 0xc0:
+  case 0xc2:
+  case 0xc3:
+  case 0xc4:
+  case 0xc7:
+  case 0xc8:
+  case 0xc9:
+  case 0xca:
+  case 0xcc:
+  case 0xcd:
+  case 0xcf:
+  case 0xd0:
+  case 0xd2:
+  case 0xd3:
+  case 0xd4:
+  case 0xd7:
+  case 0xd8:
+  case 0xd9:
+  case 0xda:
+  case 0xdb:
+  case 0xdc:
+  case 0xdd:
+  case 0xdf:
+  case 0xe3:
+  case 0xe4:
+  case 0xe7:
+  case 0xe9:
+  case 0xeb:
+  case 0xec:
+  case 0xed:
+  case 0xef:
+  case 0xf4:
+  case 0xf7:
+  case 0xfc:
+  case 0xfd:
+  case 0xff:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// True for instructions which name an address on the last page, where the
+// I/O registers are: LDH, LD (C) and LD (nn) with nn at 0xff00 and above
+[[nodiscard]] constexpr bool addresses_last_page(byte opcode,
+                                                 byte high_operand) noexcept {
+  switch (to_integer<unsigned>(opcode)) {
+  case 0xe0:
+  case 0xe2:
+  case 0xf0:
+  case 0xf2:
+    return true;
+  case 0xea:
+  case 0xfa:
+    return high_operand == byte{0xff};
+  default:
+    return false;
+  }
+}
+} // namespace greenboy::interpreter
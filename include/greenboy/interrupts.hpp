@@ -0,0 +1,65 @@
+#pragma once
+#include "timing.hpp"
+#include "types.hpp"
+
+namespace greenboy {
+class IoRegisters;
+
+// The interrupt request (IF) and enable (IE) registers. Components raise
+// their bit in requested, the CPU reaches both registers through the ports
+// connected by connect and dispatches the requests through service.
+struct Interrupts {
+  static constexpr word requested_address = 0xff0f;
+  static constexpr word enabled_address = 0xffff;
+
+  static constexpr byte vblank{0x01};
+  static constexpr byte stat{0x02};
+  static constexpr byte timer{0x04};
+  static constexpr byte serial{0x08};
+  static constexpr byte joypad{0x10};
+  // Only the low five bits of IF exist
+  static constexpr byte requested_mask{0x1f};
+  static constexpr cycles dispatch_time{20};
+
+  byte requested{0x00};
+  byte enabled{0x00};
+
+  void connect(IoRegisters &io);
+
+  void request(byte interrupt) noexcept;
+
+  // Called by the CPU cores before every instruction, or every block for
+  // the cores which run blocks. An enabled request wakes a halted CPU. With
+  // IME set, and EI not having been the instruction before, the request of
+  // the highest priority is cleared, PC pushed and execution continues at
+  // its vector. Returns the time the dispatch took.
+  template <class Registers, class Memory>
+  cycles service(Registers &registers, Memory &memory) {
+    const auto delayed = registers.interrupts_delayed;
+    registers.interrupts_delayed = false;
+    const auto pending =
+        to_integer<unsigned>(requested & enabled & requested_mask);
+    if (pending == 0) {
+      return cycles{0};
+    }
+    registers.halted = false;
+    if (!registers.interrupts_enabled || delayed) {
+      return cycles{0};
+    }
+    unsigned index = 0;
+    while ((pending >> index & 1u) == 0) {
+      ++index;
+    }
+    requested &= static_cast<byte>(~(1u << index));
+    registers.interrupts_enabled = false;
+    memory.write(--registers.sp, high_byte(registers.pc));
+    memory.write(--registers.sp, low_byte(registers.pc));
+    registers.pc = static_cast<word>(0x40u + 8u * index);
+    return dispatch_time;
+  }
+
+  // Only the low five bits of IF exist, the others read as set
+  [[nodiscard]] byte read_requested(word address) const noexcept;
+  void write_requested(word address, byte value) noexcept;
+};
+} // namespace greenboy
@@ -0,0 +1,57 @@
+#pragma once
+#include "page_table_memory_bus.hpp"
+
+namespace greenboy {
+// The page at 0xff00, holding the hardware registers, the high RAM and IE.
+// Components connect a read and a write function to each of their register
+// addresses, so an access is one indexed indirect call instead of a chain of
+// address comparisons. The bus makes that call inline and accesses the high
+// RAM at 0xff80-0xfffe in place. Unconnected registers read 0xff and ignore
+// writes.
+class IoRegisters final : public PageTableMemoryBus::Handler {
+public:
+  static constexpr word first_address = 0xff00;
+
+  // Reads take the component as mutable, as reading some registers has side
+  // effects, such as catching the PPU up
+  using Reader = PageTableMemoryBus::IoPage::Reader;
+  using Writer = PageTableMemoryBus::IoPage::Writer;
+
+private:
+  PageTableMemoryBus::IoPage m_page;
+
+  static std::size_t index(word address);
+
+public:
+  IoRegisters() noexcept;
+
+  // Maps a new IoRegisters over 0xff00-0xffff, which the bus takes
+  // ownership of
+  static IoRegisters &install(PageTableMemoryBus &bus);
+
+  byte read(word address) const override { return m_page.read(address); }
+
+  void write(word address, byte value) override {
+    m_page.write(address, value);
+  }
+
+  // The high RAM cannot be connected
+  void connect(word address, void *component, Reader reader, Writer writer);
+  // Connects the member functions Read and Write of component
+  template <auto Read, auto Write, class Component>
+  void connect(word address, Component &component) {
+    connect(
+        address, &component,
+        [](void *self, word at) {
+          return (static_cast<Component *>(self)->*Read)(at);
+        },
+        [](void *self, word at, byte value) {
+          (static_cast<Component *>(self)->*Write)(at, value);
+        });
+  }
+  // Connects a register which reads and writes value as it is
+  void bind(word address, byte &value);
+  // Restores the open bus behaviour of the address
+  void disconnect(word address);
+};
+} // namespace greenboy
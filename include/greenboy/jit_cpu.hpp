@@ -0,0 +1,52 @@
+#pragma once
+#include "block_cache.hpp"
+#include "cpu.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace greenboy {
+class MemoryBus;
+class PageTableMemoryBus;
+class ExecutableArena;
+
+// Translates blocks which have been executed often enough to x86-64 machine
+// code, keeping the guest registers in host registers while it runs. The
+// 8 bit loads, stores and arithmetic are translated, and the interpreter runs
+// the other instructions of a block in between the native runs. On a
+// PageTableMemoryBus the native code reads and writes memory in place through
+// the page tables, and calls out to the bus only for pages without memory and
+// for writes to pages which blocks were decoded from. On any other bus every
+// access calls out. The cycle budget is checked between blocks.
+class JitCPU final : public CPU {
+  // The bus the memory was given as, if it has page tables
+  const PageTableMemoryBus *m_page_table;
+  BlockCache m_cache;
+  std::unique_ptr<ExecutableArena> m_arena;
+  CPU::RegisterSet m_registers{};
+  std::uint32_t m_hot_threshold;
+  std::size_t m_translations = 0;
+
+  void translate(BlockCache::Block &block);
+
+public:
+  explicit JitCPU(std::unique_ptr<MemoryBus> memory,
+                  std::uint32_t hot_threshold = 8);
+  JitCPU(const JitCPU &) = delete;
+  JitCPU(JitCPU &&) = delete;
+  ~JitCPU() noexcept override;
+
+  JitCPU &operator=(const JitCPU &) = delete;
+  JitCPU &operator=(JitCPU &&) = delete;
+
+  cycles update() override;
+  [[nodiscard]] word pc() const noexcept override;
+  cycles run(cycles budget) override;
+
+  void invalidate(word address);
+  [[nodiscard]] std::size_t translations() const noexcept;
+
+  [[nodiscard]] CPU::RegisterSet &registers() noexcept;
+  [[nodiscard]] const CPU::RegisterSet &registers() const noexcept;
+};
+} // namespace greenboy
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "greenboy/cpu.hpp"
+
+namespace greenboy {
+// Records the last flag producing ALU operation instead of computing Z, N, H
+// and C up front. The flags are derived from the operands on demand and are
+// bit-exact with the functions in instructions::operations.
+class LazyFlags {
+public:
+  enum class Operation : std::uint8_t {
+    None,
+    Add,
+    AddWithCarry,
+    Subtract,
+    SubtractWithCarry,
+    And,
+    Or,
+    Xor,
+    Increment,
+    Decrement
+  };
+
+private:
+  Operation m_operation = Operation::None;
+  byte m_lhs{};
+  byte m_rhs{};
+  byte m_result{};
+  bool m_carry_in = false;
+  CPU::Flags m_flags{};
+
+  [[nodiscard]] unsigned full_result() const noexcept {
+    const auto a = to_integer<unsigned>(m_lhs);
+    const auto b = to_integer<unsigned>(m_rhs);
+    const auto c = m_carry_in ? 1u : 0u;
+    switch (m_operation) {
+    case Operation::Add:
+    case Operation::AddWithCarry:
+    case Operation::Increment:
+      return a + b + c;
+    default:
+      return a - b - c;
+    }
+  }
+
+public:
+  constexpr LazyFlags() noexcept = default;
+  explicit constexpr LazyFlags(CPU::Flags flags) noexcept : m_flags(flags) {}
+
+  byte record(Operation operation, byte lhs, byte rhs) noexcept {
+    const auto carry_in = operation == Operation::AddWithCarry ||
+                          operation == Operation::SubtractWithCarry ||
+                          operation == Operation::Increment ||
+                          operation == Operation::Decrement
+                              ? carry()
+                              : false;
+    const auto a = to_integer<unsigned>(lhs);
+    const auto b = to_integer<unsigned>(rhs);
+    unsigned result = 0;
+    switch (operation) {
+    case Operation::Add:
+    case Operation::Increment:
+      result = a + b;
+      break;
+    case Operation::AddWithCarry:
+      result = a + b + (carry_in ? 1u : 0u);
+      break;
+    case Operation::Subtract:
+    case Operation::Decrement:
+      result = a - b;
+      break;
+    case Operation::SubtractWithCarry:
+      result = a - b - (carry_in ? 1u : 0u);
+      break;
+    case Operation::And:
+      result = a & b;
+      break;
+    case Operation::Or:
+      result = a | b;
+      break;
+    case Operation::Xor:
+      result = a ^ b;
+      break;
+    case Operation::None:
+      return lhs;
+    }
+    m_operation = operation;
+    m_lhs = lhs;
+    m_rhs = rhs;
+    m_result = static_cast<byte>(result);
+    if (operation == Operation::Increment ||
+        operation == Operation::Decrement) {
+      // The carry of the previous operation is kept as is
+      m_carry_in = false;
+      m_flags.carry = carry_in;
+    } else {
+      m_carry_in = carry_in;
+    }
+    return m_result;
+  }
+
+  [[nodiscard]] bool zero() const noexcept {
+    if (m_operation == Operation::None) {
+      return m_flags.zero;
+    }
+    return m_result == byte{};
+  }
+
+  [[nodiscard]] bool carry() const noexcept {
+    switch (m_operation) {
+    case Operation::None:
+    case Operation::Increment:
+    case Operation::Decrement:
+      return m_flags.carry;
+    case Operation::And:
+    case Operation::Or:
+    case Operation::Xor:
+      return false;
+    default:
+      return (full_result() & 0x100u) != 0;
+    }
+  }
+
+  [[nodiscard]] CPU::Flags get() const noexcept {
+    if (m_operation == Operation::None) {
+      return m_flags;
+    }
+    CPU::Flags flags;
+    flags.zero = zero();
+    flags.carry = carry();
+    switch (m_operation) {
+    case Operation::And:
+      flags.half_carry = true;
+      break;
+    case Operation::Or:
+    case Operation::Xor:
+      break;
+    default: {
+      const auto carries = full_result() ^ to_integer<unsigned>(m_lhs) ^
+                           to_integer<unsigned>(m_rhs);
+      flags.half_carry = (carries & 0x10u) != 0;
+      flags.negate = m_operation == Operation::Subtract ||
+                     m_operation == Operation::SubtractWithCarry ||
+                     m_operation == Operation::Decrement;
+      break;
+    }
+    }
+    return flags;
+  }
+
+  void set(CPU::Flags flags) noexcept {
+    m_operation = Operation::None;
+    m_flags = flags;
+  }
+};
+} // namespace greenboy
@@ -0,0 +1,55 @@
+#pragma once
+#include "types.hpp"
+
+namespace greenboy {
+class IoRegisters;
+
+// The LCD controller registers at 0xff40-0xff4b, except for the OAM DMA
+// register at 0xff46. A PPU reads and updates the fields directly, the CPU
+// reaches them through the ports connected by connect.
+struct LcdRegisters {
+  static constexpr word lcdc_address = 0xff40;
+  static constexpr word stat_address = 0xff41;
+  static constexpr word scy_address = 0xff42;
+  static constexpr word scx_address = 0xff43;
+  static constexpr word ly_address = 0xff44;
+  static constexpr word lyc_address = 0xff45;
+  static constexpr word bgp_address = 0xff47;
+  static constexpr word obp0_address = 0xff48;
+  static constexpr word obp1_address = 0xff49;
+  static constexpr word wy_address = 0xff4a;
+  static constexpr word wx_address = 0xff4b;
+
+  // The bits of LCDC
+  static constexpr byte lcd_enable{0x80};
+  static constexpr byte window_map{0x40};
+  static constexpr byte window_enable{0x20};
+  static constexpr byte unsigned_tiles{0x10};
+  static constexpr byte background_map{0x08};
+  static constexpr byte tall_sprites{0x04};
+  static constexpr byte sprites_enable{0x02};
+  static constexpr byte background_enable{0x01};
+
+  byte lcdc{0x91};
+  byte stat{0x00};
+  byte scy{0x00};
+  byte scx{0x00};
+  byte ly{0x00};
+  byte lyc{0x00};
+  byte bgp{0xfc};
+  byte obp0{0xff};
+  byte obp1{0xff};
+  byte wy{0x00};
+  byte wx{0x00};
+
+  void connect(IoRegisters &io);
+
+  // The mode and coincidence flag in the low three bits of STAT belong to
+  // the PPU, and bit 7 always reads as set
+  [[nodiscard]] byte read_stat(word address) const noexcept;
+  void write_stat(word address, byte value) noexcept;
+  // LY is updated by the PPU only
+  [[nodiscard]] byte read_ly(word address) const noexcept;
+  void write_ly(word address, byte value) noexcept;
+};
+} // namespace greenboy
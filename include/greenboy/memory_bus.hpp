@@ -1,6 +1,8 @@
 #pragma once
 #include "types.hpp"
 
+#include <cstddef>
+
 namespace greenboy {
 class MemoryBus {
 public:
@@ -16,5 +18,17 @@ public:
   virtual byte read(word address) const = 0;
 
   virtual void write(word address, byte value) = 0;
+
+  // Little endian 16 bit accesses. The low byte is accessed first and the
+  // high byte wraps around to 0x0000, just as two single byte accesses would.
+  [[nodiscard]] virtual word read_word(word address) const;
+  virtual void write_word(word address, word value);
+
+  // Copies size bytes starting at start, wrapping around at the end of the
+  // address space. The default reads one byte at a time; buses backed by
+  // host memory copy whole runs instead.
+  virtual void read_block(word start, byte *destination,
+                          std::size_t size) const;
+  virtual void write_block(word start, const byte *source, std::size_t size);
 };
 } // namespace greenboy
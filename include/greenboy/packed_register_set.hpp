@@ -0,0 +1,83 @@
+#pragma once
+
+#include "greenboy/cpu.hpp"
+
+namespace greenboy {
+// Register file which keeps every pair in a single word, so 16-bit accesses
+// are plain loads and stores. F is kept in the low byte of AF with its lower
+// nibble cleared, as on hardware. The byte accessors have the same semantics
+// as the fields of CPU::RegisterSet.
+class PackedRegisterSet {
+  word m_bc{};
+  word m_de{};
+  word m_hl{};
+  word m_af{};
+
+  static constexpr word with_high(word pair, byte value) noexcept {
+    return static_cast<word>((pair & 0x00ffu) |
+                             (to_integer<unsigned>(value) << 8u));
+  }
+
+  static constexpr word with_low(word pair, byte value) noexcept {
+    return static_cast<word>((pair & 0xff00u) | to_integer<unsigned>(value));
+  }
+
+public:
+  word pc{};
+  word sp{};
+  bool interrupts_enabled = false;
+  bool interrupts_delayed = false;
+  bool halted = false;
+
+  constexpr PackedRegisterSet() noexcept = default;
+  explicit PackedRegisterSet(const CPU::RegisterSet &registers) noexcept;
+
+  [[nodiscard]] CPU::RegisterSet unpack() const noexcept;
+
+  [[nodiscard]] constexpr byte a() const noexcept { return high_byte(m_af); }
+  [[nodiscard]] constexpr byte b() const noexcept { return high_byte(m_bc); }
+  [[nodiscard]] constexpr byte c() const noexcept { return low_byte(m_bc); }
+  [[nodiscard]] constexpr byte d() const noexcept { return high_byte(m_de); }
+  [[nodiscard]] constexpr byte e() const noexcept { return low_byte(m_de); }
+  [[nodiscard]] constexpr byte h() const noexcept { return high_byte(m_hl); }
+  [[nodiscard]] constexpr byte l() const noexcept { return low_byte(m_hl); }
+
+  constexpr void set_a(byte value) noexcept { m_af = with_high(m_af, value); }
+  constexpr void set_b(byte value) noexcept { m_bc = with_high(m_bc, value); }
+  constexpr void set_c(byte value) noexcept { m_bc = with_low(m_bc, value); }
+  constexpr void set_d(byte value) noexcept { m_de = with_high(m_de, value); }
+  constexpr void set_e(byte value) noexcept { m_de = with_low(m_de, value); }
+  constexpr void set_h(byte value) noexcept { m_hl = with_high(m_hl, value); }
+  constexpr void set_l(byte value) noexcept { m_hl = with_low(m_hl, value); }
+
+  [[nodiscard]] constexpr word &bc() noexcept { return m_bc; }
+  [[nodiscard]] constexpr word &de() noexcept { return m_de; }
+  [[nodiscard]] constexpr word &hl() noexcept { return m_hl; }
+  [[nodiscard]] constexpr word bc() const noexcept { return m_bc; }
+  [[nodiscard]] constexpr word de() const noexcept { return m_de; }
+  [[nodiscard]] constexpr word hl() const noexcept { return m_hl; }
+
+  [[nodiscard]] constexpr word af() const noexcept { return m_af; }
+  constexpr void set_af(word value) noexcept {
+    m_af = static_cast<word>(value & 0xfff0u);
+  }
+
+  [[nodiscard]] constexpr CPU::Flags f() const noexcept {
+    return CPU::Flags{low_byte(m_af)};
+  }
+  constexpr void set_f(CPU::Flags flags) noexcept {
+    m_af = with_low(m_af, static_cast<byte>(flags));
+  }
+};
+
+[[nodiscard]] constexpr bool operator==(const PackedRegisterSet &lhs,
+                                        const PackedRegisterSet &rhs) noexcept {
+  return lhs.bc() == rhs.bc() && lhs.de() == rhs.de() &&
+         lhs.hl() == rhs.hl() && lhs.af() == rhs.af();
+}
+
+[[nodiscard]] constexpr bool operator!=(const PackedRegisterSet &lhs,
+                                        const PackedRegisterSet &rhs) noexcept {
+  return !(lhs == rhs);
+}
+} // namespace greenboy
@@ -0,0 +1,246 @@
+#pragma once
+#include "memory_bus.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace greenboy {
+// A bus which looks every access up in a table with one entry per 256 byte
+// page. A page is either backed by host memory, which is read and written
+// in place, or by a handler, as for I/O registers. Reads and writes can be
+// mapped separately, so ROM can be read in place while writes to it go to the
+// cartridge controller.
+//
+// read and write are final and defined inline, so code which knows it works
+// on a PageTableMemoryBus, such as interpreter::Interpreter and the
+// compile_time data accesses, calls them without a virtual call. The bus does
+// not own the memory it maps, which has to outlive the mapping.
+class PageTableMemoryBus final : public MemoryBus {
+public:
+  static constexpr std::size_t page_size = 0x100;
+  static constexpr std::size_t page_count = 0x100;
+
+  class Handler {
+  public:
+    Handler() = default;
+    Handler(const Handler &) = delete;
+    Handler(Handler &&) = delete;
+
+    virtual ~Handler() = default;
+
+    Handler &operator=(const Handler &) = delete;
+    Handler &operator=(Handler &&) = delete;
+
+    virtual byte read(word address) const = 0;
+    virtual void write(word address, byte value) = 0;
+  };
+
+  using HandlerIndex = std::uint8_t;
+  // Reads 0xff and ignores writes, as the unmapped parts of the bus do
+  static constexpr HandlerIndex open_bus = 0;
+
+  // The hardware registers and high RAM of the page at 0xff00. Once mapped
+  // with map_io, the bus dispatches accesses to it inline: the high RAM at
+  // 0xff80-0xfffe is read and written in place and every other address calls
+  // the functions of its port directly, without a call through a handler.
+  struct IoPage {
+    static constexpr std::size_t page = 0xff;
+
+    using Reader = byte (*)(void *component, word address);
+    using Writer = void (*)(void *component, word address, byte value);
+
+    struct Port {
+      void *component;
+      Reader read;
+      Writer write;
+    };
+
+    std::array<Port, page_size> ports{};
+    std::array<byte, page_size> high_ram{};
+
+    static constexpr bool in_high_ram(std::size_t offset) noexcept {
+      return offset >= 0x80u && offset != 0xffu;
+    }
+
+    byte read(word address) const {
+      const auto offset = address & 0xffu;
+      if (in_high_ram(offset)) {
+        return high_ram[offset];
+      }
+      const auto &port = ports[offset];
+      return port.read(port.component, address);
+    }
+
+    void write(word address, byte value) {
+      const auto offset = address & 0xffu;
+      if (in_high_ram(offset)) {
+        high_ram[offset] = value;
+        return;
+      }
+      const auto &port = ports[offset];
+      port.write(port.component, address, value);
+    }
+  };
+
+  // Writes to tracked pages are recorded per block of this many bytes
+  static constexpr std::size_t dirty_block_size = 0x40;
+  using DirtyMap = std::bitset<page_size * page_count / dirty_block_size>;
+
+private:
+  // Kept as separate arrays so a lookup loads a single pointer and remapping
+  // a bank is a run of contiguous stores
+  std::array<const byte *, page_count> m_read{};
+  std::array<byte *, page_count> m_write{};
+  std::array<HandlerIndex, page_count> m_read_handler{};
+  std::array<HandlerIndex, page_count> m_write_handler{};
+  std::vector<std::unique_ptr<Handler>> m_handlers;
+
+  // The write side of tracked pages, which are routed through the tracker
+  class DirtyTracker;
+  static constexpr HandlerIndex dirty_tracker = 1;
+  std::bitset<page_count> m_tracked;
+  std::array<byte *, page_count> m_tracked_write{};
+  std::array<HandlerIndex, page_count> m_tracked_handler{};
+  DirtyMap m_dirty;
+
+  // The I/O page while page 0xff is mapped to it, and its write side while
+  // that is not tracked either
+  IoPage *m_io_reads = nullptr;
+  IoPage *m_io_writes = nullptr;
+
+  // The mappings of the pages below 0xff while the bus is locked out, which
+  // mappings made meanwhile change instead of the table
+  bool m_locked_out = false;
+  std::array<const byte *, page_count> m_saved_read{};
+  std::array<byte *, page_count> m_saved_write{};
+  std::array<HandlerIndex, page_count> m_saved_read_handler{};
+  std::array<HandlerIndex, page_count> m_saved_write_handler{};
+
+  static std::size_t first_page(word address, std::size_t size);
+  [[nodiscard]] bool set_aside(std::size_t page) const noexcept;
+  [[nodiscard]] const byte *&read_entry(std::size_t page) noexcept;
+  [[nodiscard]] byte *&write_entry(std::size_t page) noexcept;
+  [[nodiscard]] HandlerIndex &read_handler_entry(std::size_t page) noexcept;
+  [[nodiscard]] HandlerIndex &write_handler_entry(std::size_t page) noexcept;
+  void check_handler(HandlerIndex handler) const;
+  void map_write(std::size_t page, byte *memory, HandlerIndex handler);
+  void mark_dirty(std::size_t address, std::size_t size);
+  // Stops the inline dispatch if the size bytes from page first cover page 0xff
+  void unmap_io(std::size_t first, std::size_t size) noexcept;
+
+public:
+  PageTableMemoryBus();
+
+  byte read(word address) const final {
+    const auto page = static_cast<unsigned>(address) >> 8u;
+    if (const auto *memory = m_read[page]) {
+      return memory[address & 0xffu];
+    }
+    if (page == IoPage::page && m_io_reads != nullptr) {
+      return m_io_reads->read(address);
+    }
+    return m_handlers[m_read_handler[page]]->read(address);
+  }
+
+  void write(word address, byte value) final {
+    const auto page = static_cast<unsigned>(address) >> 8u;
+    if (auto *memory = m_write[page]) {
+      memory[address & 0xffu] = value;
+      return;
+    }
+    if (page == IoPage::page && m_io_writes != nullptr) {
+      m_io_writes->write(address, value);
+      return;
+    }
+    m_handlers[m_write_handler[page]]->write(address, value);
+  }
+
+  // Both bytes are accessed in place when they lie in the same page of
+  // memory, which compiles to a single 16 bit load or store
+  word read_word(word address) const final {
+    const auto page = static_cast<unsigned>(address) >> 8u;
+    const auto offset = address & 0xffu;
+    const auto *memory = m_read[page];
+    if (memory != nullptr && offset != 0xffu) {
+      return to_word(memory[offset + 1], memory[offset]);
+    }
+    const auto low = read(address);
+    const auto high = read(static_cast<word>(address + 1));
+    return to_word(high, low);
+  }
+
+  void write_word(word address, word value) final {
+    const auto page = static_cast<unsigned>(address) >> 8u;
+    const auto offset = address & 0xffu;
+    auto *memory = m_write[page];
+    if (memory != nullptr && offset != 0xffu) {
+      memory[offset] = low_byte(value);
+      memory[offset + 1] = high_byte(value);
+      return;
+    }
+    write(address, low_byte(value));
+    write(static_cast<word>(address + 1), high_byte(value));
+  }
+
+  // Copies runs of mapped pages with memcpy
+  void read_block(word start, byte *destination,
+                  std::size_t size) const override;
+  void write_block(word start, const byte *source, std::size_t size) override;
+
+  // The page tables, for code which accesses memory in place itself. Pages
+  // without memory have to be accessed through read and write.
+  [[nodiscard]] const std::array<const byte *, page_count> &
+  read_pages() const noexcept {
+    return m_read;
+  }
+  [[nodiscard]] const std::array<byte *, page_count> &
+  write_pages() const noexcept {
+    return m_write;
+  }
+
+  HandlerIndex add_handler(std::unique_ptr<Handler> handler);
+  [[nodiscard]] Handler &handler(HandlerIndex index) const;
+
+  // The address and size have to be multiples of the page size
+  void map(word address, std::size_t size, byte *memory);
+  void map_read_only(word address, std::size_t size, const byte *memory,
+                     HandlerIndex writes);
+  void map_handler(word address, std::size_t size, HandlerIndex handler);
+  // Maps page 0xff to handler, which has to access io as well, and dispatches
+  // the reads and writes of the page to io inline. Block copies still go
+  // through the handler.
+  void map_io(HandlerIndex handler, IoPage &io);
+  // Points the reads of the pages at memory and leaves their writes as they
+  // are. Nothing is validated, so a ROM bank switch is a run of stores over
+  // pages which a map_read_only has already checked.
+  void remap_read(word address, std::size_t size,
+                  const byte *memory) noexcept;
+
+  // Records writes to the pages in the range in the dirty map, including
+  // those through handlers. Untracked pages cost nothing extra, tracked ones
+  // take the handler path for writes while reads stay in place. Mappings
+  // made later keep the tracking of their pages.
+  void track_writes(word address, std::size_t size);
+  void untrack_writes(word address, std::size_t size);
+  // Records writes made to the range without going through the bus, as DMA
+  // into memory the bus maps, for the tracked pages in it
+  void mark_written(word start, std::size_t size);
+
+  // Points every page below 0xff at open bus until unlock, as an OAM DMA
+  // transfer leaves the CPU only the high RAM and the I/O registers. Mappings
+  // made in between take effect on unlocking.
+  void lock_out() noexcept;
+  void unlock() noexcept;
+  [[nodiscard]] bool locked_out() const noexcept;
+
+  [[nodiscard]] const DirtyMap &dirty_map() const noexcept;
+  // Whether any byte in the range has been written since it was cleared
+  [[nodiscard]] bool dirty(word address, std::size_t size) const;
+  void clear_dirty() noexcept;
+  void clear_dirty(word address, std::size_t size);
+};
+} // namespace greenboy
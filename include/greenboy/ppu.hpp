@@ -0,0 +1,245 @@
+#pragma once
+#include "dma.hpp"
+#include "lcd_registers.hpp"
+#include "page_table_memory_bus.hpp"
+#include "video.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace greenboy {
+class CPU;
+struct Interrupts;
+class IoRegisters;
+class TileCache;
+
+// Follows the mode, LY and STAT timing of the hardware from the cycles it is
+// advanced by. Mode 3 is lengthened by the fine scroll and by the stalls of
+// the fetcher for the window and the sprites, as the registers and OAM are
+// when it starts. FifoPpu runs the fetcher and ends mode 3 when its last
+// pixel is out instead, which only differs when the registers change in the
+// middle of a line. Otherwise every subclass raises the same interrupts at
+// the same times and they differ only in how the pixels are drawn.
+//
+// Advancing only adds the cycles up until the next time anything outside the
+// PPU could tell it is behind: an interrupt or the end of a frame, an HBlank
+// DMA step or, for the subclasses which draw, the next point at which they
+// draw. Accesses to the registers whose value depends on the time, and writes
+// to those which change it, catch up first, and so do the accessors below.
+// VRAM is accessed in place, and so are OAM reads, while OAM writes catch up
+// first as the sprites lengthen mode 3. Subclasses which draw per dot lock
+// them as the hardware does, VRAM during mode 3 and OAM during modes 2 and
+// 3, so that they read as open bus and ignore writes. The others leave them
+// open, which is safe as nothing is drawn from them later than it would have
+// been.
+class Ppu : public Video {
+public:
+  using Vram = std::array<byte, 0x2000>;
+
+  enum class Mode : std::uint8_t { HBlank, VBlank, OamScan, Transfer };
+
+  static constexpr cycles line_time{456};
+  static constexpr cycles oam_scan_time{80};
+  // Mode 3 takes at least this long plus one cycle per pixel of fine scroll
+  static constexpr cycles transfer_time{172};
+  static constexpr unsigned line_count = 154;
+
+protected:
+  // How closely a subclass has to follow the CPU to draw what it would have
+  // drawn advanced after every instruction
+  enum class Drawing : std::uint8_t {
+    None,
+    // Draws at mode changes only
+    PerMode,
+    // Draws throughout mode 3
+    PerDot
+  };
+
+private:
+  // Takes the writes to OAM, which is read in place
+  class OamWrites;
+
+  PageTableMemoryBus &m_bus;
+  Interrupts &m_interrupts;
+  IoRegisters &m_io;
+  const Drawing m_drawing;
+  Dma *m_dma = nullptr;
+  TileCache *m_tiles = nullptr;
+  LcdRegisters m_registers;
+  Vram m_vram{};
+  Dma::Oam m_oam{};
+  PageTableMemoryBus::HandlerIndex m_oam_writes;
+  Frame m_frame{};
+  std::uint64_t m_frames = 0;
+
+  bool m_enabled = true;
+  Mode m_mode = Mode::OamScan;
+  // The time since the start of the current line and of the next mode change
+  cycles m_dot{0};
+  cycles m_next{oam_scan_time};
+  unsigned m_window_line = 0;
+  bool m_stat_line = false;
+  bool m_vram_locked = false;
+  bool m_oam_locked = false;
+
+  // The cycles advanced by but not run yet, and how many may be before the
+  // PPU has to catch up
+  cycles m_pending{0};
+  cycles m_horizon{0};
+  // The CPU whose runs the accesses catch up to, and how much of the run in
+  // progress they have added to m_pending
+  CPU *m_cpu = nullptr;
+  cycles m_followed{0};
+
+  void run(cycles c);
+  [[nodiscard]] cycles horizon() const noexcept;
+  // Also ends the CPU run in progress at the new horizon
+  void update_horizon() noexcept;
+  // The time until the start of the next occurrence of the line
+  [[nodiscard]] cycles until_line(unsigned line) const noexcept;
+  void enter(Mode mode);
+  // The stalls which lengthen the coming mode 3
+  [[nodiscard]] cycles transfer_stalls() const;
+  void lock(Mode mode);
+  void lock_oam(bool locked);
+  void next_line();
+  void switch_off() noexcept;
+  void update_stat() noexcept;
+
+  // STAT and LYC writes can raise the STAT interrupt right away, LCDC, SCX,
+  // WY and WX writes change the timing
+  [[nodiscard]] byte read_lcdc(word address) const noexcept;
+  void write_lcdc(word address, byte value);
+  [[nodiscard]] byte read_stat(word address);
+  void write_stat(word address, byte value);
+  [[nodiscard]] byte read_scx(word address) const noexcept;
+  void write_scx(word address, byte value);
+  [[nodiscard]] byte read_window(word address) const noexcept;
+  void write_window(word address, byte value);
+  [[nodiscard]] byte read_ly(word address);
+  void write_ly(word address, byte value) noexcept;
+  [[nodiscard]] byte read_lyc(word address) const noexcept;
+  void write_lyc(word address, byte value);
+  // HBlank DMA progresses as the PPU does, and an OAM transfer must not reach
+  // lines drawn before it started
+  [[nodiscard]] byte read_hdma5(word address);
+  void write_hdma5(word address, byte value);
+  [[nodiscard]] byte read_oam_dma(word address) const noexcept;
+  void write_oam_dma(word address, byte value);
+  void write_oam(word address, byte value);
+
+protected:
+  static constexpr std::size_t sprites_per_line = 10;
+  // The dots the fetcher stalls for on starting the window
+  static constexpr unsigned window_stall = 6;
+
+  // The row of a sprite which lies on the current line
+  struct SpriteRow {
+    // The colours from the left edge on, flipped as the sprite is
+    std::array<std::uint8_t, 8> colours;
+    byte attributes;
+    // The left edge plus 8, as in OAM
+    unsigned x;
+
+    [[nodiscard]] bool behind_background() const noexcept;
+    [[nodiscard]] byte palette(const LcdRegisters &registers) const noexcept;
+  };
+
+  struct Sprites {
+    std::array<SpriteRow, sprites_per_line> rows;
+    std::size_t count;
+  };
+
+  // Counts the dots the fetcher stalls for to fetch the sprites of a line,
+  // from left to right. A sprite takes 6, and the first on a background or
+  // window tile up to 5 more, the fewer the further into the tile it starts.
+  class SpriteStalls {
+    unsigned m_tile = ~0u;
+
+  public:
+    // x is the position in OAM, in_window whether the window has started at
+    // the left edge of the sprite
+    unsigned next(unsigned x, const LcdRegisters &registers,
+                  bool in_window) noexcept;
+  };
+
+private:
+  // The OAM indices of the first ten sprites on the current line
+  std::size_t scan_oam(
+      std::array<std::size_t, sprites_per_line> &found) const noexcept;
+
+protected:
+  // Maps VRAM at 0x8000 and OAM at 0xfe00 and connects the LCD registers.
+  // Subclasses which draw get a TileCache in front of the tile data.
+  Ppu(PageTableMemoryBus &bus, IoRegisters &io, Interrupts &interrupts,
+      Drawing drawing);
+
+  // Called when mode 3 starts, whenever it has progressed, with the time
+  // since it started, and when it ends
+  virtual void begin_transfer() {}
+  virtual void transfer(cycles /* elapsed */) {}
+  virtual void end_transfer() {}
+  // The time mode 3 is set to take on the current line, which a subclass
+  // may change while it lasts
+  [[nodiscard]] cycles transfer_length() const noexcept;
+  void set_transfer_length(cycles length) noexcept;
+
+  [[nodiscard]] static byte shade(byte palette, unsigned colour) noexcept;
+
+  // The VRAM offset of a row of a background or window tile
+  [[nodiscard]] std::size_t tile_row(byte tile, unsigned row) const noexcept;
+  // The first ten sprites in OAM on the current line, ordered from the one
+  // drawn in front to the one drawn at the back
+  [[nodiscard]] Sprites line_sprites();
+  // The row of the window on the current line. Only lines the window is
+  // drawn on count.
+  unsigned next_window_line() noexcept;
+  [[nodiscard]] byte *line_pixels() noexcept;
+  [[nodiscard]] TileCache &tiles() noexcept;
+  // The registers as they are, without catching up, for drawing
+  [[nodiscard]] const LcdRegisters &lcd() const noexcept;
+
+public:
+  // Runs HBlank transfers of dma on entering mode 0 and catches up before
+  // any transfer starts. dma has to be connected to the same I/O registers
+  // already.
+  void attach(Dma &dma);
+
+  // Lets the accesses made in the middle of a run of cpu catch up to it,
+  // and cuts the run short where they bring the horizon closer
+  void follow(CPU &cpu) noexcept;
+
+  // Final and inline, so Gameboy::step adds the cycles up without a call.
+  // Whatever part of c was caught up to during the run is left out.
+  void advance(cycles c) final {
+    m_pending += c - m_followed;
+    m_followed = cycles{0};
+    if (m_pending >= m_horizon) {
+      catch_up();
+    }
+  }
+  // Runs the cycles advanced by so far
+  void catch_up();
+  // How far the PPU may be advanced before it has to catch up
+  [[nodiscard]] cycles until_horizon() const noexcept {
+    return m_horizon - m_pending;
+  }
+
+  [[nodiscard]] Mode mode();
+  // Writes through the reference are seen from the next advance on
+  [[nodiscard]] LcdRegisters &registers();
+  // Writes go through the bus, so the tile cache sees them
+  [[nodiscard]] const Vram &vram() const noexcept;
+  [[nodiscard]] Dma::Oam &oam() noexcept;
+  [[nodiscard]] const Frame &frame();
+  // The number of frames which have been completed
+  [[nodiscard]] std::uint64_t frames();
+};
+
+// Keeps the timing, registers and interrupts of the PPU but never draws, for
+// running games which nobody watches
+class TimingPpu final : public Ppu {
+public:
+  TimingPpu(PageTableMemoryBus &bus, IoRegisters &io, Interrupts &interrupts);
+};
+} // namespace greenboy
@@ -0,0 +1,65 @@
+#pragma once
+#include "cpu.hpp"
+#include "interpreter.hpp"
+#include "lazy_flags.hpp"
+#include "packed_register_set.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace greenboy {
+class MemoryBus;
+
+namespace recompiled {
+using Interpreter = interpreter::Interpreter<MemoryBus, LazyFlags>;
+
+// The state a recompiled block works on. Instructions which were not
+// translated are handed to the interpreter.
+struct Context {
+  PackedRegisterSet &registers;
+  LazyFlags &flags;
+  MemoryBus &memory;
+  Interpreter &interpreter;
+};
+
+using BlockFunction = cycles (*)(Context &);
+
+// A block emitted by greenboy-recompile. Blocks in the switchable ROM bank
+// carry the bytes they were compiled from, which are compared with memory
+// before the block is run.
+struct Block {
+  word start;
+  BlockFunction function;
+  const byte *code;
+  word length;
+};
+
+struct Program {
+  const Block *blocks;
+  std::size_t size;
+};
+} // namespace recompiled
+
+// Runs a ROM which has been compiled to C++ ahead of time. Code which was not
+// found by the recompiler, such as code in RAM or code reached through jumps
+// to computed addresses, is interpreted one instruction at a time.
+class RecompiledCPU final : public CPU {
+  std::unique_ptr<MemoryBus> m_memory;
+  std::vector<const recompiled::Block *> m_blocks;
+  CPU::RegisterSet m_registers{};
+
+  [[nodiscard]] const recompiled::Block *block_at(word address) const;
+
+public:
+  RecompiledCPU(std::unique_ptr<MemoryBus> memory,
+                const recompiled::Program &program);
+
+  cycles update() override;
+  [[nodiscard]] word pc() const noexcept override;
+  cycles run(cycles budget) override;
+
+  [[nodiscard]] CPU::RegisterSet &registers() noexcept;
+  [[nodiscard]] const CPU::RegisterSet &registers() const noexcept;
+};
+} // namespace greenboy
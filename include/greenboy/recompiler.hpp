@@ -0,0 +1,48 @@
+#pragma once
+#include "types.hpp"
+
+#include <array>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace greenboy {
+// Finds the code reachable from a set of entry points in the first 32 KiB of
+// a ROM, as it is mapped at power on, and writes it out as a C++ translation
+// unit with one function per block for RecompiledCPU to run.
+class Recompiler {
+public:
+  struct Instruction {
+    word address;
+    byte opcode;
+    std::array<byte, 2> operands;
+  };
+
+  struct Block {
+    word start;
+    std::vector<Instruction> instructions;
+
+    [[nodiscard]] word length() const noexcept;
+  };
+
+private:
+  std::vector<byte> m_rom;
+  std::map<word, Block> m_blocks;
+
+  [[nodiscard]] Block decode(word start) const;
+
+public:
+  // The cartridge entry point, the restart vectors and the interrupt vectors
+  static const std::vector<word> &default_entry_points();
+
+  explicit Recompiler(std::vector<byte> rom);
+
+  void discover(word entry_point);
+  [[nodiscard]] const std::map<word, Block> &blocks() const noexcept;
+
+  // Defines `const recompiled::Program &<name>() noexcept` in the global
+  // namespace, or in the namespace named by a qualified name
+  void emit(std::ostream &out, const std::string &name) const;
+};
+} // namespace greenboy
@@ -0,0 +1,15 @@
+#pragma once
+#include "ppu.hpp"
+
+namespace greenboy {
+// Draws each line in a single pass at the end of mode 3 instead of pushing
+// pixels through the FIFO dot by dot. Registers written in the middle of
+// mode 3 apply to the whole line.
+class ScanlinePpu final : public Ppu {
+  void end_transfer() override;
+
+public:
+  ScanlinePpu(PageTableMemoryBus &bus, IoRegisters &io,
+              Interrupts &interrupts);
+};
+} // namespace greenboy
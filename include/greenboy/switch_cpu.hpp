@@ -0,0 +1,35 @@
+#pragma once
+#include "cpu.hpp"
+
+#include <memory>
+
+namespace greenboy {
+class MemoryBus;
+class PageTableMemoryBus;
+
+enum class FlagEvaluation { Eager, Lazy };
+
+class SwitchCPU final : public CPU {
+  std::unique_ptr<MemoryBus> m_memory;
+  // Set when m_memory is a PageTableMemoryBus, whose accesses can be inlined
+  PageTableMemoryBus *m_page_table;
+  FlagEvaluation m_flag_evaluation;
+  CPU::RegisterSet m_registers{};
+
+  template <class Flags> cycles run(cycles budget);
+  template <class Flags, class Memory>
+  cycles run(Memory &memory, cycles budget);
+
+public:
+  explicit SwitchCPU(
+      std::unique_ptr<MemoryBus> memory,
+      FlagEvaluation flag_evaluation = FlagEvaluation::Eager) noexcept;
+
+  cycles update() override;
+  [[nodiscard]] word pc() const noexcept override;
+  cycles run(cycles budget) override;
+
+  [[nodiscard]] CPU::RegisterSet &registers() noexcept;
+  [[nodiscard]] const CPU::RegisterSet &registers() const noexcept;
+};
+} // namespace greenboy
@@ -0,0 +1,28 @@
+#pragma once
+#include "opcode_translator.hpp"
+
+#include <array>
+#include <memory>
+
+namespace greenboy {
+class TableOpcodeTranslator final : public OpcodeTranslator {
+public:
+  // The instructions are composed of polymorphic operands, so the table can
+  // only hold pointers to them. Built once at startup, they are allocated in
+  // opcode order and translating is a single indexed load.
+  using Table = std::array<std::unique_ptr<const Instruction>, 256>;
+
+private:
+  const Table &m_table;
+  const Table &m_prefixed_table;
+
+public:
+  TableOpcodeTranslator() noexcept;
+
+  const Instruction &translate(byte opcode) override;
+  [[nodiscard]] const Instruction &translate_prefixed(byte opcode) const;
+
+  [[nodiscard]] static const Table &main_table();
+  [[nodiscard]] static const Table &prefixed_table();
+};
+} // namespace greenboy
@@ -0,0 +1,56 @@
+#pragma once
+#include "page_table_memory_bus.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+namespace greenboy {
+// The 384 tiles of VRAM decoded to one colour per pixel, as well as
+// mirrored for horizontally flipped sprites. The cache takes the writes to
+// the tile data at 0x8000-0x97ff, while reads stay in place, and marks the
+// tile written to as stale. Stale tiles are decoded again on their next
+// use, so drawing a line mostly copies decoded rows.
+//
+// Writes to the tile data which do not go through the bus have to be
+// followed by invalidate.
+class TileCache final : public PageTableMemoryBus::Handler {
+public:
+  static constexpr word first_address = 0x8000;
+  static constexpr std::size_t tile_count = 384;
+
+private:
+  static constexpr std::size_t tile_colours = 64;
+
+  byte *m_vram;
+  PageTableMemoryBus::HandlerIndex m_index = PageTableMemoryBus::open_bus;
+  std::array<std::uint8_t, tile_count * tile_colours> m_colours{};
+  std::array<std::uint8_t, tile_count * tile_colours> m_flipped{};
+  std::bitset<tile_count> m_stale;
+  std::uint64_t m_decodes = 0;
+
+  void decode(std::size_t tile);
+
+public:
+  // vram points at the memory mapped at 0x8000
+  explicit TileCache(byte *vram) noexcept;
+
+  // Maps the tile data in vram into the bus, which takes ownership of the
+  // new cache
+  static TileCache &install(PageTableMemoryBus &bus, byte *vram);
+  // Maps the tile data in again after something else was mapped over it
+  void map(PageTableMemoryBus &bus) const;
+
+  byte read(word address) const override;
+  void write(word address, byte value) override;
+
+  // The eight colours of the tile row at a VRAM offset below 0x1800,
+  // leftmost first, or rightmost first when flipped
+  [[nodiscard]] const std::uint8_t *row(std::size_t offset,
+                                        bool flipped = false);
+
+  void invalidate() noexcept;
+  // The number of tiles which have been decoded
+  [[nodiscard]] std::uint64_t decodes() const noexcept;
+};
+} // namespace greenboy
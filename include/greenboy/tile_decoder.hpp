@@ -0,0 +1,27 @@
+#pragma once
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Tiles are stored as two bit planes. Each row of 8 pixels is a byte of the
+// low bits of the colours followed by a byte of the high bits, with the
+// leftmost pixel in bit 7. The decoders turn any number of such rows, laid
+// out one after the other, into a colour index from 0 to 3 per pixel, eight
+// bytes per row with the leftmost pixel first.
+namespace greenboy::tiles {
+using Decoder = void (*)(const byte *planes, std::uint8_t *colours,
+                         std::size_t rows);
+
+enum class Kernel { Scalar, SSE2, AVX2 };
+
+// Whether the kernel was built in and runs on this CPU
+[[nodiscard]] bool supported(Kernel kernel) noexcept;
+// AVX2 where the CPU has it, scalar otherwise. SSE2 is slower than scalar
+// and only used when asked for.
+[[nodiscard]] Kernel fastest() noexcept;
+[[nodiscard]] Decoder decoder(Kernel kernel);
+
+// Decodes with the fastest kernel, which is picked on the first call
+void decode(const byte *planes, std::uint8_t *colours, std::size_t rows);
+} // namespace greenboy::tiles
@@ -0,0 +1,115 @@
+#pragma once
+#include "types.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace greenboy::trace {
+enum class Access : std::uint8_t { Read, Write };
+
+struct Record {
+  std::uint64_t cycle;
+  word address;
+  word pc;
+  byte value;
+  Access access;
+};
+
+// The size of a record in a trace file, stored little endian field by field
+constexpr std::size_t record_size = 14;
+
+// A fixed size queue for one producer and one consumer. push and pop never
+// block or allocate; when the consumer falls behind, records are dropped and
+// counted instead.
+class RingBuffer {
+  std::vector<Record> m_records;
+  std::size_t m_mask;
+  alignas(64) std::atomic<std::size_t> m_head{0};
+  alignas(64) std::atomic<std::size_t> m_tail{0};
+  std::atomic<std::uint64_t> m_dropped{0};
+
+public:
+  // The capacity is rounded up to a power of two
+  explicit RingBuffer(std::size_t capacity);
+
+  bool push(const Record &record) noexcept {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    m_records[head & m_mask] = record;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves up to size records to destination and returns how many it moved
+  std::size_t pop(Record *destination, std::size_t size) noexcept;
+
+  [[nodiscard]] std::size_t capacity() const noexcept;
+  [[nodiscard]] std::uint64_t dropped() const noexcept;
+};
+
+// Drains a ring buffer to a trace file on its own thread until stopped
+class Writer {
+  RingBuffer &m_buffer;
+  std::ofstream m_file;
+  // Where drain takes records out of the buffer, allocated once
+  std::vector<Record> m_batch;
+  std::atomic<bool> m_running{true};
+  std::uint64_t m_written = 0;
+  std::thread m_thread;
+
+  void drain();
+  void run();
+
+public:
+  Writer(RingBuffer &buffer, const std::string &path);
+  Writer(const Writer &) = delete;
+  Writer(Writer &&) = delete;
+  ~Writer();
+
+  Writer &operator=(const Writer &) = delete;
+  Writer &operator=(Writer &&) = delete;
+
+  // Writes whatever is left in the buffer and waits for the thread to end
+  void stop();
+  // The records written so far, only stable after stop
+  [[nodiscard]] std::uint64_t written() const noexcept;
+};
+
+enum class Region {
+  Rom0,
+  RomX,
+  Vram,
+  ExternalRam,
+  Wram,
+  Echo,
+  Oam,
+  Unusable,
+  Io,
+  HighRam,
+  InterruptEnable
+};
+constexpr std::size_t region_count = 11;
+
+[[nodiscard]] Region region_of(word address) noexcept;
+[[nodiscard]] const char *name(Region region) noexcept;
+
+struct Count {
+  std::uint64_t reads = 0;
+  std::uint64_t writes = 0;
+};
+using Histogram = std::array<Count, region_count>;
+
+// Reads records from a trace file until the end of the stream
+bool read(std::istream &input, Record &record);
+[[nodiscard]] Histogram histogram(std::istream &input);
+} // namespace greenboy::trace
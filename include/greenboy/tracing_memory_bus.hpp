@@ -0,0 +1,45 @@
+#pragma once
+#include "memory_bus.hpp"
+#include "trace.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace greenboy {
+// Records every access to the decorated bus in a ring buffer, stamped with
+// the cycle and program counter given to at, which a traced Gameboy does
+// before every step. Recording is a copy into a preallocated slot. The
+// decorator only exists where it has been put around a bus, so an untraced
+// emulator runs exactly the code it ran before.
+class TracingMemoryBus final : public MemoryBus {
+  std::unique_ptr<MemoryBus> m_memory;
+  trace::RingBuffer &m_buffer;
+  std::uint64_t m_cycle = 0;
+  word m_pc = 0;
+
+  void record(word address, byte value, trace::Access access) const noexcept {
+    m_buffer.push(trace::Record{m_cycle, address, m_pc, value, access});
+  }
+
+public:
+  TracingMemoryBus(std::unique_ptr<MemoryBus> memory,
+                   trace::RingBuffer &buffer) noexcept;
+
+  // Sets the time and the instruction the following accesses belong to
+  void at(std::uint64_t cycle, word pc) noexcept {
+    m_cycle = cycle;
+    m_pc = pc;
+  }
+
+  byte read(word address) const override {
+    const auto value = m_memory->read(address);
+    record(address, value, trace::Access::Read);
+    return value;
+  }
+
+  void write(word address, byte value) override {
+    m_memory->write(address, value);
+    record(address, value, trace::Access::Write);
+  }
+};
+} // namespace greenboy
@@ -1,10 +1,20 @@
 #pragma once
 
 #include "timing.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <cstddef>
 
 namespace greenboy {
 class Video {
 public:
+  static constexpr std::size_t screen_width = 160;
+  static constexpr std::size_t screen_height = 144;
+  // The shade of every pixel, row by row, from 0 for the lightest to 3 for
+  // the darkest
+  using Frame = std::array<byte, screen_width * screen_height>;
+
   Video() noexcept = default;
   Video(const Video &) = delete;
   Video(Video &&) = delete;
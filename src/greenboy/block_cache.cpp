@@ -0,0 +1,214 @@
+#include "greenboy/block_cache.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "greenboy/interpreter.hpp"
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy {
+namespace {
+class WriteTrackingBus final : public MemoryBus {
+  std::unique_ptr<MemoryBus> m_memory;
+  BlockCache &m_cache;
+
+  // A cartridge ignores what is written to its ROM, but memory mapped in its
+  // place reads back as written and drops the blocks decoded from it
+  void written(word address, byte value) {
+    m_cache.invalidate(address);
+    if (address < 0x8000 && m_memory->read(address) == value) {
+      m_cache.invalidate_decoded(address);
+    }
+  }
+
+public:
+  WriteTrackingBus(std::unique_ptr<MemoryBus> memory,
+                   BlockCache &cache) noexcept
+      : m_memory(std::move(memory)), m_cache(cache) {
+    assert(m_memory != nullptr);
+  }
+
+  byte read(word address) const override { return m_memory->read(address); }
+
+  void write(word address, byte value) override {
+    m_memory->write(address, value);
+    written(address, value);
+  }
+
+  word read_word(word address) const override {
+    return m_memory->read_word(address);
+  }
+
+  void write_word(word address, word value) override {
+    m_memory->write_word(address, value);
+    written(address, low_byte(value));
+    written(static_cast<word>(address + 1), high_byte(value));
+  }
+
+  void read_block(word start, byte *destination,
+                  std::size_t size) const override {
+    m_memory->read_block(start, destination, size);
+  }
+
+  void write_block(word start, const byte *source,
+                   std::size_t size) override {
+    m_memory->write_block(start, source, size);
+    for (std::size_t i = 0; i < size; ++i) {
+      written(static_cast<word>(start + i), source[i]);
+    }
+  }
+};
+
+template <class Visitor>
+void for_each_page(const BlockCache::Block &block, Visitor visitor) {
+  const auto end = static_cast<word>(block.start + block.length - 1);
+  const auto first = static_cast<unsigned>(block.start) >> 8u;
+  const auto last = static_cast<unsigned>(end) >> 8u;
+  for (auto page = first;; page = (page + 1u) & 0xffu) {
+    visitor(page);
+    if (page == last) {
+      break;
+    }
+  }
+}
+} // namespace
+
+bool BlockCache::Block::covers(word address) const noexcept {
+  return static_cast<word>(address - start) < length;
+}
+
+BlockCache::BlockCache(std::unique_ptr<MemoryBus> memory)
+    : m_memory(std::make_unique<WriteTrackingBus>(std::move(memory), *this)),
+      m_blocks(0x10000) {}
+
+MemoryBus &BlockCache::memory() noexcept { return *m_memory; }
+
+const std::array<bool, 256> &BlockCache::pages_with_code() const noexcept {
+  return m_pages_with_code;
+}
+
+BlockCache::Block &BlockCache::block_at(word address) {
+  auto &cached = m_blocks[address];
+  if (cached != nullptr) {
+    return *cached;
+  }
+
+  auto block = std::make_unique<Block>();
+  block->start = address;
+  block->length = 0;
+  auto pc = address;
+  while (block->instructions.size() < max_block_length) {
+    DecodedInstruction instruction{m_memory->read(pc), {}};
+    const auto length = interpreter::instruction_length(instruction.opcode);
+    for (auto i = 1u; i < length; ++i) {
+      instruction.operands[i - 1] = m_memory->read(static_cast<word>(pc + i));
+    }
+    // The PPU is only brought up to the start of a block, so the registers
+    // it updates are only current for the first instruction
+    if (!block->instructions.empty() &&
+        interpreter::addresses_last_page(instruction.opcode,
+                                         instruction.operands[1])) {
+      break;
+    }
+    block->instructions.push_back(instruction);
+    pc = static_cast<word>(pc + length);
+    block->length = static_cast<word>(block->length + length);
+    if (interpreter::ends_block(instruction.opcode)) {
+      break;
+    }
+  }
+
+  for_each_page(*block, [this, address](unsigned page) {
+    m_blocks_by_page[page].push_back(address);
+    m_pages_with_code[page] = true;
+  });
+  ++m_block_count;
+  cached = std::move(block);
+  return *cached;
+}
+
+void BlockCache::release_removed() noexcept { m_retired.clear(); }
+
+void BlockCache::remove(word start) {
+  auto &block = m_blocks[start];
+  for_each_page(*block, [this, start](unsigned page) {
+    auto &starts = m_blocks_by_page[page];
+    starts.erase(std::find(starts.begin(), starts.end(), start));
+    m_pages_with_code[page] = !starts.empty();
+  });
+  block->valid = false;
+  m_retired.push_back(std::move(block));
+  --m_block_count;
+}
+
+void BlockCache::invalidate(word address) {
+  if (m_block_count == 0) {
+    return;
+  }
+  // Writes to the cartridge area control the memory bank controller, which
+  // remaps some of the windows the blocks may have been decoded from
+  if (address < 0x8000) {
+    invalidate_switched(address);
+    return;
+  }
+  invalidate_decoded(address);
+}
+
+void BlockCache::invalidate_decoded(word address) {
+  auto &starts = m_blocks_by_page[static_cast<unsigned>(address) >> 8u];
+  for (std::size_t i = 0; i < starts.size();) {
+    if (m_blocks[starts[i]]->covers(address)) {
+      remove(starts[i]);
+    } else {
+      ++i;
+    }
+  }
+}
+
+void BlockCache::invalidate_switched(word address) {
+  struct Window {
+    unsigned first_page;
+    unsigned last_page;
+  };
+  constexpr Window fixed_rom{0x00, 0x3f};
+  constexpr Window switchable_rom{0x40, 0x7f};
+  constexpr Window external_ram{0xa0, 0xbf};
+  // The ROM bank number at 0x2000-0x3fff only selects the switchable bank.
+  // RAM enables at 0x0000-0x1fff and the RAM bank, upper ROM bank and mode
+  // registers at 0x4000-0x7fff of the MBC1, MBC3 and MBC5 can remap the
+  // external RAM, and on the MBC1 also either ROM window.
+  const auto drop = [this](Window window) {
+    for (auto page = window.first_page; page <= window.last_page; ++page) {
+      auto &starts = m_blocks_by_page[page];
+      while (!starts.empty()) {
+        remove(starts.back());
+      }
+    }
+  };
+  if (address < 0x2000) {
+    drop(external_ram);
+  } else if (address < 0x4000) {
+    drop(switchable_rom);
+  } else {
+    drop(fixed_rom);
+    drop(switchable_rom);
+    drop(external_ram);
+  }
+}
+
+void BlockCache::invalidate_all() noexcept {
+  for (auto &starts : m_blocks_by_page) {
+    for (auto start : starts) {
+      if (auto &block = m_blocks[start]; block != nullptr) {
+        block->valid = false;
+        m_retired.push_back(std::move(block));
+      }
+    }
+    starts.clear();
+  }
+  m_pages_with_code.fill(false);
+  m_block_count = 0;
+}
+
+std::size_t BlockCache::size() const noexcept { return m_block_count; }
+} // namespace greenboy
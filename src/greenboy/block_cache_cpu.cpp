@@ -0,0 +1,69 @@
+#include "greenboy/block_cache_cpu.hpp"
+
+#include "greenboy/interpreter.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy {
+BlockCacheCPU::BlockCacheCPU(std::unique_ptr<MemoryBus> memory)
+    : m_cache(std::move(memory)) {}
+
+void BlockCacheCPU::invalidate(word address) { m_cache.invalidate(address); }
+
+void BlockCacheCPU::invalidate_all() noexcept { m_cache.invalidate_all(); }
+
+std::size_t BlockCacheCPU::cached_blocks() const noexcept {
+  return m_cache.size();
+}
+
+cycles BlockCacheCPU::update() { return run(cycles{1}); }
+
+cycles BlockCacheCPU::run(cycles budget) {
+  PackedRegisterSet registers{m_registers};
+  auto flags = m_registers.f;
+  interpreter::Interpreter<MemoryBus, CPU::Flags> interpreter{
+      registers, flags, m_cache.memory()};
+  const auto store = [&] {
+    registers.set_f(flags);
+    m_registers = registers.unpack();
+    m_cache.release_removed();
+  };
+  auto *const interrupts = m_interrupts;
+  begin_run(budget);
+  try {
+    while (m_elapsed < m_budget) {
+      // Between blocks only, so a request waits for the end of the block
+      if (interrupts != nullptr) {
+        m_elapsed += interrupts->service(registers, m_cache.memory());
+      }
+      if (registers.halted) {
+        m_elapsed += cycles{4};
+        continue;
+      }
+      const auto &block = m_cache.block_at(registers.pc);
+      for (const auto &instruction : block.instructions) {
+        m_elapsed += interpreter.execute(instruction.opcode,
+                                         instruction.operands.data());
+        if (!block.valid) {
+          break;
+        }
+      }
+      m_cache.release_removed();
+    }
+  } catch (...) {
+    store();
+    end_run();
+    throw;
+  }
+  store();
+  return end_run();
+}
+
+word BlockCacheCPU::pc() const noexcept { return m_registers.pc; }
+
+CPU::RegisterSet &BlockCacheCPU::registers() noexcept { return m_registers; }
+
+const CPU::RegisterSet &BlockCacheCPU::registers() const noexcept {
+  return m_registers;
+}
+} // namespace greenboy
@@ -0,0 +1,362 @@
+#include "greenboy/cartridge.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace greenboy::cartridge {
+namespace {
+constexpr std::size_t cartridge_type_address = 0x0147;
+constexpr std::size_t ram_size_address = 0x0149;
+constexpr word external_ram = 0xa000;
+
+unsigned header(const Rom &rom, std::size_t address) {
+  return address < rom.size ? to_integer<unsigned>(rom.data.get()[address])
+                            : 0u;
+}
+
+bool enables_ram(byte value) noexcept {
+  return (value & byte{0x0f}) == byte{0x0a};
+}
+
+class NoController final : public Controller {
+public:
+  using Controller::Controller;
+
+  void power_on() override {
+    Controller::power_on();
+    map_ram(0);
+  }
+
+  void write(word /* address */, byte /* value */) override {}
+};
+
+class MBC1 final : public Controller {
+  unsigned m_low = 1;
+  unsigned m_high = 0;
+  bool m_advanced_banking = false;
+  bool m_enabled = false;
+
+  void update_rom() {
+    const auto low = m_low == 0 ? 1u : m_low;
+    map_rom(0x4000, m_high << 5u | low);
+  }
+
+  void update_ram() {
+    if (m_enabled) {
+      map_ram(m_advanced_banking ? m_high : 0u);
+    } else {
+      disable_ram();
+    }
+  }
+
+public:
+  using Controller::Controller;
+
+  void write(word address, byte value) override {
+    const auto bits = to_integer<unsigned>(value);
+    switch (address >> 13u) {
+    case 0:
+      m_enabled = enables_ram(value);
+      update_ram();
+      break;
+    case 1:
+      m_low = bits & 0x1fu;
+      update_rom();
+      break;
+    case 2:
+      m_high = bits & 0x03u;
+      update_rom();
+      if (m_advanced_banking) {
+        map_rom(0x0000, m_high << 5u);
+        update_ram();
+      }
+      break;
+    case 3:
+      m_advanced_banking = (bits & 0x01u) != 0;
+      map_rom(0x0000, m_advanced_banking ? m_high << 5u : 0u);
+      update_ram();
+      break;
+    default:
+      // Writes to disabled RAM are dropped
+      break;
+    }
+  }
+};
+
+class MBC3 final : public Controller {
+  unsigned m_select = 0;
+  bool m_enabled = false;
+  bool m_latching = false;
+  std::array<byte, 5> m_clock{};
+  std::array<byte, 5> m_latched_clock{};
+
+  [[nodiscard]] bool clock_selected() const noexcept {
+    return m_select >= 0x08 && m_select <= 0x0c;
+  }
+
+  void update_ram() {
+    if (m_enabled && !clock_selected()) {
+      map_ram(m_select & 0x03u);
+    } else {
+      disable_ram();
+    }
+  }
+
+public:
+  using Controller::Controller;
+
+  byte read(word address) const override {
+    if (address >= external_ram && m_enabled && clock_selected()) {
+      return m_latched_clock[m_select - 0x08];
+    }
+    return Controller::read(address);
+  }
+
+  void write(word address, byte value) override {
+    const auto bits = to_integer<unsigned>(value);
+    switch (address >> 13u) {
+    case 0:
+      m_enabled = enables_ram(value);
+      update_ram();
+      break;
+    case 1:
+      map_rom(0x4000, (bits & 0x7fu) == 0 ? 1u : bits & 0x7fu);
+      break;
+    case 2:
+      m_select = bits;
+      update_ram();
+      break;
+    case 3:
+      // Writing 0 and then 1 copies the clock to the readable registers
+      if (m_latching && bits == 1) {
+        m_latched_clock = m_clock;
+      }
+      m_latching = bits == 0;
+      break;
+    default:
+      if (m_enabled && clock_selected()) {
+        m_clock[m_select - 0x08] = value;
+        m_latched_clock[m_select - 0x08] = value;
+      }
+      break;
+    }
+  }
+};
+
+class MBC5 final : public Controller {
+  unsigned m_rom_bank = 1;
+  bool m_enabled = false;
+  unsigned m_ram_bank = 0;
+
+  void update_ram() {
+    if (m_enabled) {
+      map_ram(m_ram_bank);
+    } else {
+      disable_ram();
+    }
+  }
+
+public:
+  using Controller::Controller;
+
+  void write(word address, byte value) override {
+    const auto bits = to_integer<unsigned>(value);
+    switch (address >> 12u) {
+    case 0:
+    case 1:
+      m_enabled = enables_ram(value);
+      update_ram();
+      break;
+    case 2:
+      m_rom_bank = (m_rom_bank & 0x100u) | bits;
+      map_rom(0x4000, m_rom_bank);
+      break;
+    case 3:
+      m_rom_bank = (m_rom_bank & 0xffu) | (bits & 0x01u) << 8u;
+      map_rom(0x4000, m_rom_bank);
+      break;
+    case 4:
+    case 5:
+      m_ram_bank = bits & 0x0fu;
+      update_ram();
+      break;
+    default:
+      break;
+    }
+  }
+};
+} // namespace
+
+template <class Type>
+Controller &Controller::make(PageTableMemoryBus &bus, Rom rom, Ram ram) {
+  auto controller =
+      std::make_unique<Type>(bus, std::move(rom), std::move(ram));
+  auto &installed = *controller;
+  installed.attach(bus.add_handler(std::move(controller)));
+  return installed;
+}
+
+Rom Rom::from(std::vector<byte> image) {
+  const auto owner =
+      std::make_shared<const std::vector<byte>>(std::move(image));
+  return Rom{std::shared_ptr<const byte>(owner, owner->data()), owner->size()};
+}
+
+Ram Ram::allocate(std::size_t size) {
+  if (size == 0) {
+    return Ram{};
+  }
+  return Ram{
+      std::shared_ptr<byte>(new byte[size](), std::default_delete<byte[]>()),
+      size};
+}
+
+ControllerType controller_type(const Rom &rom) {
+  switch (header(rom, cartridge_type_address)) {
+  case 0x00:
+  case 0x08:
+  case 0x09:
+    return ControllerType::None;
+  case 0x01:
+  case 0x02:
+  case 0x03:
+    return ControllerType::MBC1;
+  case 0x0f:
+  case 0x10:
+  case 0x11:
+  case 0x12:
+  case 0x13:
+    return ControllerType::MBC3;
+  case 0x19:
+  case 0x1a:
+  case 0x1b:
+  case 0x1c:
+  case 0x1d:
+  case 0x1e:
+    return ControllerType::MBC5;
+  default:
+    throw std::runtime_error("The cartridge type is not supported");
+  }
+}
+
+std::size_t ram_size(const Rom &rom) {
+  constexpr std::array<std::size_t, 6> sizes{0,      0x800,   0x2000,
+                                             0x8000, 0x20000, 0x10000};
+  const auto code = header(rom, ram_size_address);
+  return code < sizes.size() ? sizes[code] : 0;
+}
+
+Controller::Controller(PageTableMemoryBus &bus, Rom rom, Ram ram)
+    : m_bus(bus), m_rom(std::move(rom)), m_ram(std::move(ram)) {
+  if (m_rom.data == nullptr || m_rom.size < 2 * rom_bank_size ||
+      m_rom.size % rom_bank_size != 0) {
+    throw std::runtime_error(
+        "The ROM has to consist of at least two whole 16 KiB banks");
+  }
+  if (m_ram.size != 0 && m_ram.data == nullptr) {
+    throw std::runtime_error("Parameter ram has a size but no memory");
+  }
+  if (m_rom.sharers == nullptr) {
+    m_rom.sharers = std::make_shared<Rom::Sharers>();
+  }
+  ++m_rom.sharers->controllers;
+  const auto banks = m_rom.size / rom_bank_size;
+  for (std::size_t bank = 0; bank < m_rom_banks.size(); ++bank) {
+    m_rom_banks[bank] = m_rom.data.get() + bank % banks * rom_bank_size;
+  }
+}
+
+Controller::~Controller() { --m_rom.sharers->controllers; }
+
+void Controller::attach(PageTableMemoryBus::HandlerIndex index) {
+  m_index = index;
+  // Writes to both windows go to the controller for good, so a switch only
+  // has to remap the reads
+  m_bus.map_read_only(0x0000, 2 * rom_bank_size, m_rom.data.get(), m_index);
+  power_on();
+}
+
+void Controller::power_on() {
+  map_rom(0x0000, 0);
+  map_rom(0x4000, 1);
+  disable_ram();
+}
+
+void Controller::map_rom(word address, std::size_t bank) {
+  const auto *memory = m_rom_banks[bank % m_rom_banks.size()];
+  m_bus.remap_read(address, rom_bank_size, memory);
+  if (address != 0) {
+    m_rom_bank =
+        static_cast<std::size_t>(memory - m_rom.data.get()) / rom_bank_size;
+  }
+}
+
+void Controller::map_ram(std::size_t bank) {
+  if (m_ram.size == 0) {
+    disable_ram();
+    return;
+  }
+  bank %= std::max<std::size_t>(m_ram.size / ram_bank_size, 1);
+  // RAM smaller than a bank repeats across the window
+  for (std::size_t offset = 0; offset < ram_bank_size;
+       offset += PageTableMemoryBus::page_size) {
+    const auto source = (bank * ram_bank_size + offset) % m_ram.size;
+    m_bus.map(static_cast<word>(external_ram + offset),
+              PageTableMemoryBus::page_size, m_ram.data.get() + source);
+  }
+  m_ram_bank = bank;
+  m_ram_enabled = true;
+}
+
+void Controller::disable_ram() {
+  m_bus.map_handler(external_ram, ram_bank_size, m_index);
+  m_ram_enabled = false;
+}
+
+Controller &Controller::install(PageTableMemoryBus &bus, Rom rom) {
+  auto ram = Ram::allocate(ram_size(rom));
+  return install(bus, std::move(rom), std::move(ram));
+}
+
+Controller &Controller::install(PageTableMemoryBus &bus, Rom rom, Ram ram) {
+  const auto type = controller_type(rom);
+  return install(bus, type, std::move(rom), std::move(ram));
+}
+
+Controller &Controller::install(PageTableMemoryBus &bus, ControllerType type,
+                                Rom rom, Ram ram) {
+  switch (type) {
+  case ControllerType::None:
+    return make<NoController>(bus, std::move(rom), std::move(ram));
+  case ControllerType::MBC1:
+    return make<MBC1>(bus, std::move(rom), std::move(ram));
+  case ControllerType::MBC3:
+    return make<MBC3>(bus, std::move(rom), std::move(ram));
+  case ControllerType::MBC5:
+    return make<MBC5>(bus, std::move(rom), std::move(ram));
+  default:
+    throw std::runtime_error("The cartridge type is not supported");
+  }
+}
+
+byte Controller::read(word /* address */) const { return byte{0xff}; }
+
+std::size_t Controller::rom_bank() const noexcept { return m_rom_bank; }
+
+std::size_t Controller::ram_bank() const noexcept { return m_ram_bank; }
+
+bool Controller::ram_enabled() const noexcept { return m_ram_enabled; }
+
+const Ram &Controller::ram() const noexcept { return m_ram; }
+
+MemoryUsage Controller::memory_usage() const {
+  return MemoryUsage{m_rom.resident(), m_rom.sharers->controllers.load(),
+                     m_ram.resident()};
+}
+
+std::size_t MemoryUsage::proportional() const noexcept {
+  return (rom_sharers == 0 ? rom_resident : rom_resident / rom_sharers) +
+         ram_resident;
+}
+} // namespace greenboy::cartridge
@@ -0,0 +1,334 @@
+#include "greenboy/cartridge.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GREENBOY_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace greenboy::cartridge {
+namespace {
+#ifdef GREENBOY_MMAP
+using Key = std::pair<dev_t, ino_t>;
+#ifdef __linux__
+using Residency = unsigned char;
+#else
+using Residency = char;
+#endif
+
+class Mapping {
+  void *m_address;
+  std::size_t m_size;
+
+public:
+  Mapping(void *address, std::size_t size) noexcept
+      : m_address(address), m_size(size) {}
+  Mapping(const Mapping &) = delete;
+  Mapping(Mapping &&) = delete;
+  ~Mapping() { munmap(m_address, m_size); }
+
+  Mapping &operator=(const Mapping &) = delete;
+  Mapping &operator=(Mapping &&) = delete;
+
+  [[nodiscard]] byte *data() noexcept { return static_cast<byte *>(m_address); }
+  [[nodiscard]] const byte *data() const noexcept {
+    return static_cast<const byte *>(m_address);
+  }
+  [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+};
+
+class File {
+  int m_descriptor;
+
+public:
+  File(const std::string &path, int flags)
+      : m_descriptor(::open(path.c_str(), flags | O_CLOEXEC, 0644)) {
+    if (m_descriptor < 0) {
+      throw std::runtime_error("Could not open " + path);
+    }
+  }
+  File(const File &) = delete;
+  File(File &&) = delete;
+  ~File() { ::close(m_descriptor); }
+
+  File &operator=(const File &) = delete;
+  File &operator=(File &&) = delete;
+
+  [[nodiscard]] int descriptor() const noexcept { return m_descriptor; }
+};
+
+void advise(const Mapping &mapping, MapOptions options) {
+  // The hints only affect performance, so failures are ignored
+  auto *address = const_cast<byte *>(mapping.data());
+#ifdef MADV_HUGEPAGE
+  if (options.huge_pages) {
+    madvise(address, mapping.size(), MADV_HUGEPAGE);
+  }
+#endif
+  if (options.sequential) {
+    madvise(address, mapping.size(), MADV_SEQUENTIAL);
+  }
+}
+
+// A mapped ROM file and the count of the controllers it is installed in,
+// shared by every Rom mapped from the file
+struct Image {
+  Mapping mapping;
+  Rom::Sharers sharers;
+
+  Image(void *address, std::size_t size) noexcept : mapping(address, size) {}
+};
+
+std::shared_ptr<Image> map_file(const std::string &path, MapOptions options) {
+  // Files are identified by device and inode, so different paths to the
+  // same file share a mapping
+  static std::mutex mutex;
+  static std::map<Key, std::weak_ptr<Image>> images;
+
+  const File file{path, O_RDONLY};
+  struct stat status {};
+  if (fstat(file.descriptor(), &status) != 0) {
+    throw std::runtime_error("Could not read the size of " + path);
+  }
+  if (status.st_size <= 0) {
+    throw std::runtime_error("The ROM " + path + " is empty");
+  }
+
+  const std::lock_guard<std::mutex> lock{mutex};
+  // Entries of images nobody refers to any more are dropped, so the map
+  // does not grow with every file a long running process has opened
+  for (auto entry = images.begin(); entry != images.end();) {
+    entry = entry->second.expired() ? images.erase(entry) : std::next(entry);
+  }
+  const Key key{status.st_dev, status.st_ino};
+  // The last reference to an image may have gone since the entries were
+  // dropped, in which case the file is mapped again
+  if (const auto entry = images.find(key); entry != images.end()) {
+    if (auto image = entry->second.lock()) {
+      advise(image->mapping, options);
+      return image;
+    }
+  }
+  const auto size = static_cast<std::size_t>(status.st_size);
+  auto *address =
+      mmap(nullptr, size, PROT_READ, MAP_SHARED, file.descriptor(), 0);
+  if (address == MAP_FAILED) {
+    throw std::runtime_error("Could not map " + path);
+  }
+  auto image = std::make_shared<Image>(address, size);
+  advise(image->mapping, options);
+  images[key] = image;
+  return image;
+}
+#endif
+} // namespace
+
+#ifdef GREENBOY_MMAP
+struct SaveFile::Storage {
+  std::string path;
+  // Kept open for starting the writeback of the mapping
+  File file;
+  Mapping mapping;
+
+  Storage(const std::string &save, std::size_t size)
+      : path(save), file(save, O_RDWR | O_CREAT),
+        mapping(map(file, size, save), size) {}
+  Storage(const Storage &) = delete;
+  Storage(Storage &&) = delete;
+  ~Storage() {
+    // Nobody is left to tell that the last write back failed
+    try {
+      flush(true);
+    } catch (const std::runtime_error &) {
+    }
+  }
+
+  Storage &operator=(const Storage &) = delete;
+  Storage &operator=(Storage &&) = delete;
+
+  [[nodiscard]] byte *data() noexcept { return mapping.data(); }
+  [[nodiscard]] std::size_t size() const noexcept { return mapping.size(); }
+
+  // Writes the dirty pages back to the file, waiting for the disk unless
+  // asked not to. The kernel tracks which pages have been written, so clean
+  // ones cost nothing. MS_ASYNC does nothing on Linux, where
+  // sync_file_range starts the writeback instead.
+  void flush(bool wait) {
+    auto result = 0;
+    if (wait) {
+      result = msync(mapping.data(), mapping.size(), MS_SYNC);
+    } else {
+#ifdef __linux__
+      result = sync_file_range(file.descriptor(), 0,
+                               static_cast<off_t>(mapping.size()),
+                               SYNC_FILE_RANGE_WRITE);
+#else
+      result = msync(mapping.data(), mapping.size(), MS_ASYNC);
+#endif
+    }
+    if (result != 0) {
+      throw std::runtime_error("Could not write back " + path);
+    }
+  }
+
+  static void *map(const File &file, std::size_t size,
+                   const std::string &path) {
+    // A save of a different size is cut or padded with zeros to fit
+    if (ftruncate(file.descriptor(), static_cast<off_t>(size)) != 0) {
+      throw std::runtime_error("Could not resize " + path);
+    }
+    auto *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         file.descriptor(), 0);
+    if (address == MAP_FAILED) {
+      throw std::runtime_error("Could not map " + path);
+    }
+    return address;
+  }
+
+  static std::shared_ptr<Storage> open(const std::string &path,
+                                       std::size_t size) {
+    return std::make_shared<Storage>(path, size);
+  }
+};
+#else
+struct SaveFile::Storage {
+  std::string path;
+  std::vector<byte> memory;
+
+  Storage(std::string file, std::size_t size)
+      : path(std::move(file)), memory(size) {}
+  Storage(const Storage &) = delete;
+  Storage(Storage &&) = delete;
+  ~Storage() {
+    // Nobody is left to tell that the last write failed
+    try {
+      flush(true);
+    } catch (const std::runtime_error &) {
+    }
+  }
+
+  Storage &operator=(const Storage &) = delete;
+  Storage &operator=(Storage &&) = delete;
+
+  [[nodiscard]] byte *data() noexcept { return memory.data(); }
+  [[nodiscard]] std::size_t size() const noexcept { return memory.size(); }
+  void flush(bool /* wait */) {
+    std::ofstream file{path, std::ios::binary};
+    file.write(reinterpret_cast<const char *>(memory.data()),
+               static_cast<std::streamsize>(memory.size()));
+    file.close();
+    if (!file) {
+      throw std::runtime_error("Could not write " + path);
+    }
+  }
+
+  static std::shared_ptr<Storage> open(const std::string &path,
+                                       std::size_t size) {
+    auto storage = std::make_shared<Storage>(path, size);
+    std::ifstream file{path, std::ios::binary};
+    file.read(reinterpret_cast<char *>(storage->memory.data()),
+              static_cast<std::streamsize>(size));
+    return storage;
+  }
+};
+#endif
+
+namespace {
+std::size_t resident_size(const byte *data, std::size_t size) {
+#ifdef GREENBOY_MMAP
+  if (data == nullptr || size == 0) {
+    return 0;
+  }
+  const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto first = reinterpret_cast<std::uintptr_t>(data) / page * page;
+  const auto end = reinterpret_cast<std::uintptr_t>(data) + size;
+  std::vector<Residency> pages((end - first + page - 1) / page);
+  if (mincore(reinterpret_cast<void *>(first), end - first, pages.data()) !=
+      0) {
+    return size;
+  }
+  std::size_t resident = 0;
+  for (std::size_t i = 0; i < pages.size(); ++i) {
+    if ((static_cast<unsigned>(pages[i]) & 1u) != 0) {
+      const auto begin = std::max(first + i * page,
+                                  reinterpret_cast<std::uintptr_t>(data));
+      resident += std::min(first + (i + 1) * page, end) - begin;
+    }
+  }
+  return resident;
+#else
+  return data == nullptr ? 0 : size;
+#endif
+}
+} // namespace
+
+Rom Rom::map(const std::string &path, MapOptions options) {
+#ifdef GREENBOY_MMAP
+  const auto image = map_file(path, options);
+  return Rom{std::shared_ptr<const byte>(image, image->mapping.data()),
+             image->mapping.size(),
+             std::shared_ptr<Rom::Sharers>(image, &image->sharers)};
+#else
+  // Without mmap the image is read once, and still shared by every Rom
+  // copied from the result
+  static_cast<void>(options);
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    throw std::runtime_error("Could not open " + path);
+  }
+  std::vector<byte> image;
+  std::transform(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>(), std::back_inserter(image),
+                 [](char value) { return static_cast<byte>(value); });
+  return Rom::from(std::move(image));
+#endif
+}
+
+std::size_t Rom::resident() const { return resident_size(data.get(), size); }
+
+SaveFile::SaveFile(const std::string &path, std::size_t size, cycles interval)
+    : m_interval(interval) {
+  if (size == 0) {
+    throw std::runtime_error("A save file needs a size");
+  }
+  if (interval <= cycles{0}) {
+    throw std::runtime_error("The flush interval has to be positive");
+  }
+  m_storage = Storage::open(path, size);
+}
+
+Ram SaveFile::ram() const {
+  return Ram{std::shared_ptr<byte>(m_storage, m_storage->data()),
+             m_storage->size()};
+}
+
+void SaveFile::advance(cycles c) {
+  m_since_flush += c;
+  if (m_since_flush >= m_interval) {
+    m_storage->flush(false);
+    m_since_flush = cycles{0};
+    ++m_flushes;
+  }
+}
+
+void SaveFile::flush() {
+  m_storage->flush(true);
+  m_since_flush = cycles{0};
+  ++m_flushes;
+}
+
+std::uint64_t SaveFile::flushes() const noexcept { return m_flushes; }
+
+std::size_t Ram::resident() const { return resident_size(data.get(), size); }
+} // namespace greenboy::cartridge
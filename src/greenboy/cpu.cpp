@@ -1 +1,16 @@
 #include "greenboy/cpu.hpp"
+
+namespace greenboy {
+cycles CPU::run(cycles budget) {
+  begin_run(budget);
+  try {
+    while (m_elapsed < m_budget) {
+      m_elapsed += update();
+    }
+  } catch (...) {
+    end_run();
+    throw;
+  }
+  return end_run();
+}
+} // namespace greenboy
@@ -0,0 +1 @@
+#include "greenboy/data_access/compile_time.hpp"
@@ -0,0 +1,22 @@
+#include "greenboy/data_access/immediate_word.hpp"
+
+#include <stdexcept>
+
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy::data_access {
+word ImmediateWord::read(CPU::RegisterSet &registers, MemoryBus &memory) const {
+  const auto value = memory.read_word(registers.pc);
+  registers.pc = static_cast<word>(registers.pc + 2);
+  return value;
+}
+void ImmediateWord::write(CPU::RegisterSet & /* registers */,
+                          MemoryBus & /* memory */, word /* value */) {
+  throw std::runtime_error("Tried to write to immediate word");
+}
+cycles ImmediateWord::access_time() const noexcept { return cycles{8}; }
+std::shared_ptr<ImmediateWord> ImmediateWord::instance() {
+  static auto instance = std::make_shared<ImmediateWord>();
+  return instance;
+}
+} // namespace greenboy::data_access
@@ -0,0 +1,27 @@
+#include "greenboy/data_access/pre_incrementing_word.hpp"
+
+#include <stdexcept>
+
+namespace greenboy::data_access {
+PreIncrementingWord::PreIncrementingWord(std::shared_ptr<WordAccess> inner)
+    : m_inner(std::move(inner)) {
+  if (m_inner == nullptr) {
+    throw std::runtime_error("Parameter inner may not be null");
+  }
+}
+word PreIncrementingWord::read(CPU::RegisterSet &registers,
+                               MemoryBus &memory) const {
+  auto value = m_inner->read(registers, memory);
+  ++value;
+  m_inner->write(registers, memory, value);
+  return value;
+}
+void PreIncrementingWord::write(CPU::RegisterSet & /* registers */,
+                                MemoryBus & /* memory */, word /* value */) {
+  throw std::runtime_error("Tried to write to an preincrementing word");
+}
+std::shared_ptr<PreIncrementingWord>
+PreIncrementingWord::from(std::shared_ptr<WordAccess> inner) {
+  return std::make_shared<PreIncrementingWord>(std::move(inner));
+}
+} // namespace greenboy::data_access
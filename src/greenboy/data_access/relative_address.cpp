@@ -0,0 +1,23 @@
+#include "greenboy/data_access/relative_address.hpp"
+
+#include <stdexcept>
+
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy::data_access {
+word RelativeAddress::read(CPU::RegisterSet &registers,
+                           MemoryBus &memory) const {
+  // The offset is relative to the address following the operand
+  const auto offset = static_cast<std::int8_t>(memory.read(registers.pc++));
+  return static_cast<word>(registers.pc + offset);
+}
+void RelativeAddress::write(CPU::RegisterSet & /* registers */,
+                            MemoryBus & /* memory */, word /* value */) {
+  throw std::runtime_error("Tried to write to a relative address");
+}
+cycles RelativeAddress::access_time() const { return cycles{4}; }
+std::shared_ptr<RelativeAddress> RelativeAddress::instance() {
+  static auto instance = std::make_shared<RelativeAddress>();
+  return instance;
+}
+} // namespace greenboy::data_access
@@ -0,0 +1,21 @@
+#include "greenboy/data_access/stack_word.hpp"
+
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy::data_access {
+word StackWord::read(CPU::RegisterSet &registers, MemoryBus &memory) const {
+  const auto value = memory.read_word(registers.sp);
+  registers.sp = static_cast<word>(registers.sp + 2);
+  return value;
+}
+void StackWord::write(CPU::RegisterSet &registers, MemoryBus &memory,
+                      word value) {
+  memory.write(--registers.sp, high_byte(value));
+  memory.write(--registers.sp, low_byte(value));
+}
+cycles StackWord::access_time() const noexcept { return cycles{8}; }
+std::shared_ptr<StackWord> StackWord::instance() {
+  static auto instance = std::make_shared<StackWord>();
+  return instance;
+}
+} // namespace greenboy::data_access
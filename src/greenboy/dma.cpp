@@ -0,0 +1,128 @@
+#include "greenboy/dma.hpp"
+
+#include "greenboy/io_registers.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+
+namespace greenboy {
+namespace {
+constexpr word oam_address = 0xfe00;
+constexpr std::size_t oam_size = 0xa0;
+constexpr word vram_address = 0x8000;
+constexpr std::size_t hdma_block = 0x10;
+// Each block takes 8 machine cycles at normal speed
+constexpr cycles hdma_block_time{32};
+} // namespace
+
+Dma::Dma(PageTableMemoryBus &bus, IoRegisters &io, Oam &oam, Model model)
+    : m_bus(bus), m_oam(oam), m_model(model) {
+  io.connect<&Dma::read_oam_dma, &Dma::write_oam_dma>(oam_dma_address, *this);
+  if (model == Model::Cgb) {
+    for (auto address = hdma1_address; address <= hdma5_address; ++address) {
+      io.connect<&Dma::read_hdma, &Dma::write_hdma>(address, *this);
+    }
+  }
+}
+
+void Dma::run_oam_transfer(cycles c) {
+  m_oam_remaining -= c;
+  if (m_oam_remaining <= cycles{0}) {
+    m_bus.unlock();
+  }
+}
+
+void Dma::copy_to_vram(unsigned blocks) {
+  std::array<byte, 0x80 * hdma_block> buffer{};
+  const auto size = blocks * hdma_block;
+  m_bus.read_block(m_hdma_source, buffer.data(), size);
+  m_bus.write_block(static_cast<word>(vram_address | m_hdma_destination),
+                    buffer.data(), size);
+  m_hdma_source = static_cast<word>(m_hdma_source + size);
+  m_hdma_destination =
+      static_cast<word>((m_hdma_destination + size) & 0x1ff0u);
+  m_hdma_blocks -= blocks;
+}
+
+void Dma::hblank() {
+  if (m_hblank_transfer && m_hdma_blocks > 0) {
+    copy_to_vram(1);
+    m_hblank_transfer = m_hdma_blocks > 0;
+  }
+}
+
+cycles Dma::take_stall() noexcept {
+  const auto stall = m_stall;
+  m_stall = cycles{0};
+  return stall;
+}
+
+Dma::Model Dma::model() const noexcept { return m_model; }
+
+bool Dma::oam_transfer() const noexcept {
+  return m_oam_remaining > cycles{0};
+}
+
+bool Dma::hblank_transfer() const noexcept { return m_hblank_transfer; }
+
+byte Dma::read_oam_dma(word /* address */) const noexcept {
+  return m_oam_source;
+}
+
+void Dma::write_oam_dma(word /* address */, byte value) {
+  m_oam_source = value;
+  // Sources above 0xdfff read the echo of work RAM
+  auto source = to_integer<unsigned>(value);
+  if (source >= 0xe0u) {
+    source -= 0x20u;
+  }
+  // A transfer started during another one reads the bus as it is mapped
+  m_bus.unlock();
+  m_bus.read_block(static_cast<word>(source << 8u), m_oam.data(), oam_size);
+  m_bus.mark_written(oam_address, oam_size);
+  m_oam_remaining = oam_transfer_time;
+  m_bus.lock_out();
+}
+
+byte Dma::read_hdma(word address) const noexcept {
+  if (address != hdma5_address) {
+    return byte{0xff};
+  }
+  // The remaining length, with bit 7 clear while an HBlank transfer is active
+  const auto remaining = (m_hdma_blocks - 1u) & 0x7fu;
+  return static_cast<byte>(m_hblank_transfer ? remaining : remaining | 0x80u);
+}
+
+void Dma::write_hdma(word address, byte value) {
+  const auto bits = to_integer<unsigned>(value);
+  switch (address) {
+  case hdma1_address:
+    m_hdma_source = static_cast<word>((m_hdma_source & 0x00ffu) | bits << 8u);
+    break;
+  case hdma2_address:
+    m_hdma_source =
+        static_cast<word>((m_hdma_source & 0xff00u) | (bits & 0xf0u));
+    break;
+  case hdma3_address:
+    m_hdma_destination = static_cast<word>((m_hdma_destination & 0x00ffu) |
+                                           (bits & 0x1fu) << 8u);
+    break;
+  case hdma4_address:
+    m_hdma_destination =
+        static_cast<word>((m_hdma_destination & 0xff00u) | (bits & 0xf0u));
+    break;
+  default:
+    if (m_hblank_transfer && (bits & 0x80u) == 0) {
+      // Clearing bit 7 stops an HBlank transfer
+      m_hblank_transfer = false;
+      break;
+    }
+    m_hdma_blocks = (bits & 0x7fu) + 1;
+    if ((bits & 0x80u) != 0) {
+      m_hblank_transfer = true;
+    } else {
+      m_stall += hdma_block_time * static_cast<int>(m_hdma_blocks);
+      copy_to_vram(m_hdma_blocks);
+    }
+    break;
+  }
+}
+} // namespace greenboy
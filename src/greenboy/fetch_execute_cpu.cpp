@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "greenboy/instruction.hpp"
+#include "greenboy/interrupts.hpp"
 #include "greenboy/memory_bus.hpp"
 #include "greenboy/opcode_translator.hpp"
 
@@ -16,8 +17,25 @@ FetchExecuteCPU::FetchExecuteCPU(
 }
 
 cycles FetchExecuteCPU::update() {
-  const auto opcode = m_memory->read(m_registers.pc);
+  if (m_interrupts != nullptr) {
+    if (const auto time = m_interrupts->service(m_registers, *m_memory);
+        time > cycles{0}) {
+      return time;
+    }
+  }
+  if (m_registers.halted) {
+    return cycles{4};
+  }
+  const auto opcode = m_memory->read(m_registers.pc++);
   const auto &instruction = m_controlUnit->translate(opcode);
-  return instruction.execute(m_registers, *m_memory);
+  return cycles{4} + instruction.execute(m_registers, *m_memory);
+}
+
+word FetchExecuteCPU::pc() const noexcept { return m_registers.pc; }
+
+CPU::RegisterSet &FetchExecuteCPU::registers() noexcept { return m_registers; }
+
+const CPU::RegisterSet &FetchExecuteCPU::registers() const noexcept {
+  return m_registers;
 }
 } // namespace greenboy
@@ -0,0 +1,152 @@
+#include "greenboy/fifo_ppu.hpp"
+
+#include <algorithm>
+
+#include "greenboy/tile_cache.hpp"
+
+namespace greenboy {
+namespace {
+constexpr std::size_t map_width = 32;
+// The first tile fetched on a line is thrown away
+constexpr unsigned fetch_delay = 12;
+
+bool set(byte value, byte mask) noexcept { return (value & mask) != byte{0}; }
+} // namespace
+
+FifoPpu::FifoPpu(PageTableMemoryBus &bus, IoRegisters &io,
+                 Interrupts &interrupts)
+    : Ppu(bus, io, interrupts, Drawing::PerDot) {}
+
+void FifoPpu::begin_transfer() {
+  m_sprites = line_sprites();
+  m_next_sprite = 0;
+  m_fetched_sprites = 0;
+  m_sprite_stalls = SpriteStalls{};
+  m_stall = 0;
+  m_sprite_fifo = {};
+  m_bit = 8;
+  m_fetches = 0;
+  m_in_window = false;
+  m_dots = 0;
+  m_x = 0;
+  m_discard = to_integer<unsigned>(lcd().scx & byte{0x07});
+}
+
+void FifoPpu::transfer(cycles elapsed) {
+  const auto dots = static_cast<unsigned>(elapsed.count());
+  while (m_dots < dots && m_x < screen_width) {
+    step();
+  }
+  if (m_x == screen_width) {
+    set_transfer_length(cycles{static_cast<int>(m_dots)});
+  } else if (elapsed >= transfer_length()) {
+    // The window started where it was not expected to
+    set_transfer_length(elapsed + cycles{1});
+  }
+}
+
+void FifoPpu::step() {
+  if (m_dots++ < fetch_delay) {
+    return;
+  }
+  const auto &registers = this->lcd();
+  const auto lcdc = registers.lcdc;
+  const auto background_enabled =
+      set(lcdc, LcdRegisters::background_enable);
+
+  const auto wx = to_integer<unsigned>(registers.wx);
+  if (!m_in_window && m_discard == 0 && background_enabled &&
+      set(lcdc, LcdRegisters::window_enable) &&
+      registers.wy <= registers.ly && m_x + 7 >= wx) {
+    m_in_window = true;
+    m_window_row = next_window_line();
+    m_fetches = 0;
+    m_bit = 8;
+    m_discard = wx < 7 ? 7 - wx : 0;
+    m_stall += window_stall;
+  }
+  if (m_discard == 0) {
+    while (m_fetched_sprites < m_sprites.count &&
+           m_sprites.rows[m_fetched_sprites].x <= m_x + 8) {
+      const auto x = m_sprites.rows[m_fetched_sprites++].x;
+      if (set(lcdc, LcdRegisters::sprites_enable)) {
+        m_stall += m_sprite_stalls.next(x, registers, m_in_window);
+      }
+    }
+  }
+  if (m_stall > 0) {
+    --m_stall;
+    return;
+  }
+  if (m_bit == 8) {
+    fetch();
+  }
+  const auto background = m_row[m_bit++];
+  if (m_discard > 0) {
+    --m_discard;
+    return;
+  }
+
+  while (m_next_sprite < m_sprites.count &&
+         m_sprites.rows[m_next_sprite].x <= m_x + 8) {
+    mix(m_next_sprite++);
+  }
+  const auto sprite = m_sprite_fifo[0];
+  for (std::size_t i = 1; i < m_sprite_fifo.size(); ++i) {
+    m_sprite_fifo[i - 1] = m_sprite_fifo[i];
+  }
+  m_sprite_fifo.back() = SpritePixel{};
+
+  const auto background_colour = background_enabled ? background : 0u;
+  auto pixel = background_enabled ? shade(registers.bgp, background) : byte{0};
+  if (set(lcdc, LcdRegisters::sprites_enable) && sprite.colour != 0) {
+    const auto &row = m_sprites.rows[sprite.sprite];
+    if (!row.behind_background() || background_colour == 0) {
+      pixel = shade(row.palette(registers), sprite.colour);
+    }
+  }
+  line_pixels()[m_x++] = pixel;
+}
+
+void FifoPpu::fetch() {
+  const auto &registers = this->lcd();
+  const auto lcdc = registers.lcdc;
+  std::size_t map = 0;
+  unsigned x = 0;
+  unsigned y = 0;
+  if (m_in_window) {
+    map = set(lcdc, LcdRegisters::window_map) ? 0x1c00 : 0x1800;
+    x = m_fetches;
+    y = m_window_row;
+  } else {
+    map = set(lcdc, LcdRegisters::background_map) ? 0x1c00 : 0x1800;
+    x = to_integer<unsigned>(registers.scx) / 8u + m_fetches;
+    y = (to_integer<unsigned>(registers.scy) +
+         to_integer<unsigned>(registers.ly)) &
+        0xffu;
+  }
+  const auto &vram = this->vram();
+  const auto data =
+      tile_row(vram[map + (y / 8u) * map_width + x % map_width], y % 8u);
+  std::copy_n(tiles().row(data), m_row.size(), m_row.begin());
+  m_bit = 0;
+  ++m_fetches;
+}
+
+// Sprite pixels only replace transparent ones, so the sprites mixed in first
+// stay in front
+void FifoPpu::mix(std::size_t sprite) {
+  const auto &row = m_sprites.rows[sprite];
+  for (unsigned pixel = 0; pixel < 8u; ++pixel) {
+    const auto x = row.x + pixel;
+    if (x < m_x + 8) {
+      continue;
+    }
+    auto &slot = m_sprite_fifo[x - m_x - 8];
+    const auto sprite_colour = row.colours[pixel];
+    if (slot.colour == 0 && sprite_colour != 0) {
+      slot = SpritePixel{sprite_colour, sprite};
+    }
+  }
+}
+} // namespace greenboy
@@ -0,0 +1,204 @@
+#include "greenboy/fusing_opcode_translator.hpp"
+
+#include <cassert>
+
+#include "greenboy/instruction.hpp"
+#include "greenboy/instructions/byte_arithmetic_operation.hpp"
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy {
+namespace {
+namespace operations = instructions::operations;
+using Idiom = FusingOpcodeTranslator::Idiom;
+using Hits = FusingOpcodeTranslator::Hits;
+
+constexpr byte load_indirect_from_hl_increment{0x2a};
+constexpr byte load_indirect_de{0x12};
+constexpr byte increment_de{0x13};
+constexpr byte compare_immediate{0xfe};
+constexpr byte load_high_page{0xf0};
+constexpr byte jump_relative_not_zero{0x20};
+
+void count(Hits &hits, Idiom idiom) noexcept {
+  ++hits[static_cast<std::size_t>(idiom)];
+}
+
+// Consumes the opcode at pc if it is the expected one
+bool next_is(CPU::RegisterSet &registers, const MemoryBus &memory,
+             byte opcode) {
+  if (memory.read(registers.pc) != opcode) {
+    return false;
+  }
+  ++registers.pc;
+  return true;
+}
+
+// Consumes the opcode of a JR cc,e at pc, if there is one, and evaluates its
+// condition
+bool next_is_conditional_jump(CPU::RegisterSet &registers,
+                              const MemoryBus &memory, bool &taken) {
+  switch (to_integer<unsigned>(memory.read(registers.pc))) {
+  case 0x20:
+    taken = !registers.f.zero;
+    break;
+  case 0x28:
+    taken = registers.f.zero;
+    break;
+  case 0x30:
+    taken = !registers.f.carry;
+    break;
+  case 0x38:
+    taken = registers.f.carry;
+    break;
+  default:
+    return false;
+  }
+  ++registers.pc;
+  return true;
+}
+
+// The rest of a JR whose opcode has been consumed, including its fetch
+cycles jump_relative(CPU::RegisterSet &registers, const MemoryBus &memory,
+                     bool taken) {
+  const auto offset = static_cast<std::int8_t>(memory.read(registers.pc++));
+  if (!taken) {
+    return cycles{8};
+  }
+  registers.pc = static_cast<word>(registers.pc + offset);
+  return cycles{12};
+}
+
+void compare(CPU::RegisterSet &registers, const MemoryBus &memory) {
+  operations::compare(registers.a, memory.read(registers.pc++), registers.f);
+}
+
+class CopyByte final : public Instruction {
+  Hits &m_hits;
+
+public:
+  explicit CopyByte(Hits &hits) noexcept : m_hits(hits) {}
+
+  cycles execute(CPU::RegisterSet &registers,
+                 MemoryBus &memory) const override {
+    const auto source = to_word(registers.h, registers.l);
+    registers.a = memory.read(source);
+    const auto next_source = static_cast<word>(source + 1);
+    registers.h = high_byte(next_source);
+    registers.l = low_byte(next_source);
+    if (!next_is(registers, memory, load_indirect_de)) {
+      return cycles{4};
+    }
+    const auto destination = to_word(registers.d, registers.e);
+    memory.write(destination, registers.a);
+    if (!next_is(registers, memory, increment_de)) {
+      count(m_hits, Idiom::CopyByte);
+      return cycles{4 + 8};
+    }
+    const auto next_destination = static_cast<word>(destination + 1);
+    registers.d = high_byte(next_destination);
+    registers.e = low_byte(next_destination);
+    count(m_hits, Idiom::CopyByteAndAdvance);
+    return cycles{4 + 8 + 8};
+  }
+};
+
+class DecrementAndBranch final : public Instruction {
+  byte CPU::RegisterSet::*m_register;
+  Hits &m_hits;
+
+public:
+  DecrementAndBranch(byte CPU::RegisterSet::*reg, Hits &hits) noexcept
+      : m_register(reg), m_hits(hits) {}
+
+  cycles execute(CPU::RegisterSet &registers,
+                 MemoryBus &memory) const override {
+    auto &value = registers.*m_register;
+    value = operations::decrement(value, byte{1}, registers.f);
+    if (!next_is(registers, memory, jump_relative_not_zero)) {
+      return cycles{0};
+    }
+    count(m_hits, Idiom::DecrementAndBranch);
+    return jump_relative(registers, memory, !registers.f.zero);
+  }
+};
+
+class CompareAndBranch final : public Instruction {
+  Hits &m_hits;
+
+public:
+  explicit CompareAndBranch(Hits &hits) noexcept : m_hits(hits) {}
+
+  cycles execute(CPU::RegisterSet &registers,
+                 MemoryBus &memory) const override {
+    compare(registers, memory);
+    auto taken = false;
+    if (!next_is_conditional_jump(registers, memory, taken)) {
+      return cycles{4};
+    }
+    count(m_hits, Idiom::CompareAndBranch);
+    return cycles{4} + jump_relative(registers, memory, taken);
+  }
+};
+
+class PollAndBranch final : public Instruction {
+  Hits &m_hits;
+
+public:
+  explicit PollAndBranch(Hits &hits) noexcept : m_hits(hits) {}
+
+  cycles execute(CPU::RegisterSet &registers,
+                 MemoryBus &memory) const override {
+    const auto port = memory.read(registers.pc++);
+    registers.a = memory.read(to_word(byte{0xff}, port));
+    if (!next_is(registers, memory, compare_immediate)) {
+      return cycles{8};
+    }
+    compare(registers, memory);
+    auto taken = false;
+    if (!next_is_conditional_jump(registers, memory, taken)) {
+      return cycles{8 + 8};
+    }
+    count(m_hits, Idiom::PollAndBranch);
+    return cycles{8 + 8} + jump_relative(registers, memory, taken);
+  }
+};
+} // namespace
+
+FusingOpcodeTranslator::FusingOpcodeTranslator(
+    std::unique_ptr<OpcodeTranslator> translator)
+    : m_translator(std::move(translator)) {
+  assert(m_translator != nullptr);
+  const auto fuse = [this](byte opcode, std::unique_ptr<Instruction> fused) {
+    m_fused[to_integer<std::size_t>(opcode)] = std::move(fused);
+  };
+  fuse(load_indirect_from_hl_increment, std::make_unique<CopyByte>(m_hits));
+  fuse(compare_immediate, std::make_unique<CompareAndBranch>(m_hits));
+  fuse(load_high_page, std::make_unique<PollAndBranch>(m_hits));
+
+  constexpr std::array<byte CPU::RegisterSet::*, 8> registers{
+      &CPU::RegisterSet::b, &CPU::RegisterSet::c, &CPU::RegisterSet::d,
+      &CPU::RegisterSet::e, &CPU::RegisterSet::h, &CPU::RegisterSet::l,
+      nullptr,              &CPU::RegisterSet::a};
+  for (auto index = 0u; index < registers.size(); ++index) {
+    if (registers[index] != nullptr) {
+      fuse(static_cast<byte>(0x05u | index << 3u),
+           std::make_unique<DecrementAndBranch>(registers[index], m_hits));
+    }
+  }
+}
+
+FusingOpcodeTranslator::~FusingOpcodeTranslator() = default;
+
+const Instruction &FusingOpcodeTranslator::translate(byte opcode) {
+  if (const auto &fused = m_fused[to_integer<std::size_t>(opcode)]) {
+    return *fused;
+  }
+  return m_translator->translate(opcode);
+}
+
+std::uint64_t FusingOpcodeTranslator::hits(Idiom idiom) const noexcept {
+  return m_hits[static_cast<std::size_t>(idiom)];
+}
+
+void FusingOpcodeTranslator::reset_hits() noexcept { m_hits.fill(0); }
+} // namespace greenboy
@@ -1,19 +1,148 @@
 #include "greenboy/gameboy.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
+#include "greenboy/block_cache_cpu.hpp"
 #include "greenboy/cpu.hpp"
+#include "greenboy/dma.hpp"
+#include "greenboy/fetch_execute_cpu.hpp"
+#include "greenboy/fifo_ppu.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/io_registers.hpp"
+#ifdef GREENBOY_JIT
+#include "greenboy/jit_cpu.hpp"
+#endif
+#include "greenboy/memory_bus.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+#include "greenboy/ppu.hpp"
+#include "greenboy/scanline_ppu.hpp"
+#include "greenboy/switch_cpu.hpp"
+#include "greenboy/table_opcode_translator.hpp"
+#include "greenboy/tracing_memory_bus.hpp"
 #include "greenboy/video.hpp"
 
 namespace greenboy {
+namespace {
+std::unique_ptr<CPU> make_cpu(CPUCore core,
+                              std::unique_ptr<MemoryBus> memory) {
+  switch (core) {
+  case CPUCore::FetchExecute:
+    return std::make_unique<FetchExecuteCPU>(
+        std::move(memory), std::make_unique<TableOpcodeTranslator>());
+  case CPUCore::Switch:
+    return std::make_unique<SwitchCPU>(std::move(memory));
+  case CPUCore::BlockCache:
+    return std::make_unique<BlockCacheCPU>(std::move(memory));
+  case CPUCore::Jit:
+#ifdef GREENBOY_JIT
+    return std::make_unique<JitCPU>(std::move(memory));
+#else
+    throw std::runtime_error("The JIT CPU core is not available on this "
+                             "platform");
+#endif
+  default:
+    throw std::runtime_error("Tried to create an unknown CPU core");
+  }
+}
+
+std::unique_ptr<Ppu> make_ppu(VideoAccuracy accuracy,
+                              PageTableMemoryBus &memory, IoRegisters &io,
+                              Interrupts &interrupts) {
+  switch (accuracy) {
+  case VideoAccuracy::PixelFifo:
+    return std::make_unique<FifoPpu>(memory, io, interrupts);
+  case VideoAccuracy::Scanline:
+    return std::make_unique<ScanlinePpu>(memory, io, interrupts);
+  case VideoAccuracy::TimingOnly:
+    return std::make_unique<TimingPpu>(memory, io, interrupts);
+  default:
+    throw std::runtime_error("Tried to create an unknown video accuracy");
+  }
+}
+
+// A CGB runs cartridges which set bit 7 of the CGB flag in their header in
+// CGB mode
+Dma::Model model(const PageTableMemoryBus &memory) {
+  constexpr word cgb_flag = 0x0143;
+  return (memory.read(cgb_flag) & byte{0x80}) != byte{0} ? Dma::Model::Cgb
+                                                         : Dma::Model::Dmg;
+}
+} // namespace
+
+struct Gameboy::Hardware {
+  std::unique_ptr<Interrupts> interrupts;
+  std::unique_ptr<Ppu> ppu;
+  std::unique_ptr<Dma> dma;
+  std::unique_ptr<PageTableMemoryBus> memory;
+};
+
+Gameboy::Hardware Gameboy::install(VideoAccuracy accuracy,
+                                   std::unique_ptr<PageTableMemoryBus> memory) {
+  Hardware hardware{std::make_unique<Interrupts>(), nullptr, nullptr,
+                    std::move(memory)};
+  auto &io = IoRegisters::install(*hardware.memory);
+  hardware.interrupts->connect(io);
+  hardware.ppu =
+      make_ppu(accuracy, *hardware.memory, io, *hardware.interrupts);
+  hardware.dma = std::make_unique<Dma>(*hardware.memory, io,
+                                      hardware.ppu->oam(),
+                                      model(*hardware.memory));
+  hardware.ppu->attach(*hardware.dma);
+  return hardware;
+}
+
 Gameboy::Gameboy(std::unique_ptr<CPU> cpu,
                  std::unique_ptr<Video> video) noexcept
-    : m_cpu{std::move(cpu)}, m_video(std::move(video)) {
+    : m_video(std::move(video)), m_ppu(dynamic_cast<Ppu *>(m_video.get())),
+      m_cpu{std::move(cpu)} {
   assert(m_cpu != nullptr);
   assert(m_video != nullptr);
+  if (m_ppu != nullptr) {
+    m_ppu->follow(*m_cpu);
+  }
 }
+Gameboy::Gameboy(CPUCore core, std::unique_ptr<MemoryBus> memory,
+                 std::unique_ptr<Video> video)
+    : Gameboy(make_cpu(core, std::move(memory)), std::move(video)) {}
+Gameboy::Gameboy(CPUCore core, VideoAccuracy accuracy,
+                 std::unique_ptr<PageTableMemoryBus> memory)
+    : Gameboy(core, install(accuracy, std::move(memory))) {}
+Gameboy::Gameboy(CPUCore core, Hardware hardware)
+    : m_interrupts(std::move(hardware.interrupts)),
+      m_video(std::move(hardware.ppu)),
+      m_ppu(dynamic_cast<Ppu *>(m_video.get())),
+      m_dma(std::move(hardware.dma)),
+      m_cpu(make_cpu(core, std::move(hardware.memory))) {
+  m_cpu->connect(*m_interrupts);
+  m_ppu->follow(*m_cpu);
+}
+Gameboy::~Gameboy() = default;
 void Gameboy::step() {
-  const auto time_passed = m_cpu->update();
-  m_video->advance(time_passed);
+  cycles time_passed{};
+  if (m_tracing != nullptr) {
+    m_tracing->at(m_cycle, m_cpu->pc());
+    time_passed = m_cpu->update();
+  } else if (m_ppu != nullptr) {
+    time_passed = m_cpu->run(std::max(m_ppu->until_horizon(), cycles{1}));
+  } else {
+    time_passed = m_cpu->update();
+  }
+  if (m_dma != nullptr) {
+    // The CPU is halted while a general purpose transfer copies
+    time_passed += m_dma->take_stall();
+    m_dma->advance(time_passed);
+  }
+  if (m_ppu != nullptr) {
+    m_ppu->advance(time_passed);
+  } else {
+    m_video->advance(time_passed);
+  }
+  m_cycle += static_cast<std::uint64_t>(time_passed.count());
+}
+void Gameboy::trace(TracingMemoryBus &memory) noexcept {
+  m_tracing = &memory;
 }
+Video &Gameboy::video() const noexcept { return *m_video; }
 } // namespace greenboy
@@ -0,0 +1,23 @@
+#include "greenboy/instructions/bit_test.hpp"
+
+#include <cassert>
+
+#include "greenboy/data_access/byte_access.hpp"
+
+namespace greenboy::instructions {
+BitTest::BitTest(std::shared_ptr<const data_access::ByteAccess> operand,
+                 unsigned bit)
+    : m_operand(std::move(operand)),
+      m_mask(static_cast<byte>(1u << bit)) {
+  assert(m_operand != nullptr);
+  assert(bit < 8);
+}
+
+cycles BitTest::execute(CPU::RegisterSet &registers, MemoryBus &memory) const {
+  const auto value = m_operand->read(registers, memory);
+  registers.f.zero = (value & m_mask) == byte{};
+  registers.f.negate = false;
+  registers.f.half_carry = true;
+  return m_operand->access_time();
+}
+} // namespace greenboy::instructions
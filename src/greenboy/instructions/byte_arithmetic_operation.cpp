@@ -19,6 +19,15 @@ cycles ByteArithmeticOperation::execute(CPU::RegisterSet &registers,
   return m_lhs->access_time() + m_rhs->access_time();
 }
 
+template <ByteOperation Operation>
+cycles StaticByteArithmeticOperation<Operation>::execute(
+    CPU::RegisterSet &registers, MemoryBus &memory) const {
+  auto result = Operation(m_lhs->read(registers, memory),
+                          m_rhs->read(registers, memory), registers.f);
+  m_lhs->write(registers, memory, result);
+  return m_lhs->access_time() + m_rhs->access_time();
+}
+
 namespace operations {
 byte add(const byte lhs, const byte rhs, CPU::Flags &f) noexcept {
   const auto a = std::to_integer<unsigned>(lhs);
@@ -132,5 +141,208 @@ byte decrement(const byte lhs, const byte rhs, CPU::Flags &f) noexcept {
   f.carry = carry;
   return result;
 }
+byte rotate_left_circular(const byte lhs, const byte /* rhs */,
+                          CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = ((a << 1u) | (a >> 7u)) & 0xffu;
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = (a & 0x80u) != 0;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte rotate_right_circular(const byte lhs, const byte /* rhs */,
+                           CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = ((a >> 1u) | (a << 7u)) & 0xffu;
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = (a & 0x01u) != 0;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte rotate_left(const byte lhs, const byte /* rhs */, CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = ((a << 1u) | (f.carry ? 1u : 0u)) & 0xffu;
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = (a & 0x80u) != 0;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte rotate_right(const byte lhs, const byte /* rhs */,
+                  CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = (a >> 1u) | (f.carry ? 0x80u : 0u);
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = (a & 0x01u) != 0;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte rotate_left_circular_accumulator(const byte lhs, const byte rhs,
+                                      CPU::Flags &f) noexcept {
+  auto result = rotate_left_circular(lhs, rhs, f);
+  f.zero = false;
+  return result;
+}
+byte rotate_right_circular_accumulator(const byte lhs, const byte rhs,
+                                       CPU::Flags &f) noexcept {
+  auto result = rotate_right_circular(lhs, rhs, f);
+  f.zero = false;
+  return result;
+}
+byte rotate_left_accumulator(const byte lhs, const byte rhs,
+                             CPU::Flags &f) noexcept {
+  auto result = rotate_left(lhs, rhs, f);
+  f.zero = false;
+  return result;
+}
+byte rotate_right_accumulator(const byte lhs, const byte rhs,
+                              CPU::Flags &f) noexcept {
+  auto result = rotate_right(lhs, rhs, f);
+  f.zero = false;
+  return result;
+}
+byte shift_left_arithmetic(const byte lhs, const byte /* rhs */,
+                           CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = (a << 1u) & 0xffu;
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = (a & 0x80u) != 0;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte shift_right_arithmetic(const byte lhs, const byte /* rhs */,
+                            CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = (a >> 1u) | (a & 0x80u);
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = (a & 0x01u) != 0;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte shift_right_logical(const byte lhs, const byte /* rhs */,
+                         CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = a >> 1u;
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = (a & 0x01u) != 0;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte swap(const byte lhs, const byte /* rhs */, CPU::Flags &f) noexcept {
+  const auto a = std::to_integer<unsigned>(lhs);
+  const auto result = ((a << 4u) | (a >> 4u)) & 0xffu;
+
+  f.zero = result == 0;
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = false;
+
+  return byte{static_cast<uint8_t>(result)};
+}
+byte reset_bits(const byte lhs, const byte rhs,
+                CPU::Flags & /* f */) noexcept {
+  return lhs & ~rhs;
+}
+byte set_bits(const byte lhs, const byte rhs, CPU::Flags & /* f */) noexcept {
+  return lhs | rhs;
+}
+byte decimal_adjust(const byte lhs, const byte /* rhs */,
+                    CPU::Flags &f) noexcept {
+  auto a = std::to_integer<unsigned>(lhs);
+  if (f.negate) {
+    if (f.carry) {
+      a -= 0x60u;
+    }
+    if (f.half_carry) {
+      a -= 0x06u;
+    }
+  } else {
+    if (f.carry || a > 0x99u) {
+      a += 0x60u;
+      f.carry = true;
+    }
+    if (f.half_carry || (a & 0x0fu) > 0x09u) {
+      a += 0x06u;
+    }
+  }
+  a &= 0xffu;
+
+  f.zero = a == 0;
+  f.half_carry = false;
+
+  return byte{static_cast<uint8_t>(a)};
+}
+byte complement(const byte lhs, const byte /* rhs */, CPU::Flags &f) noexcept {
+  f.negate = true;
+  f.half_carry = true;
+  return ~lhs;
+}
+byte set_carry(const byte lhs, const byte /* rhs */, CPU::Flags &f) noexcept {
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = true;
+  return lhs;
+}
+byte complement_carry(const byte lhs, const byte /* rhs */,
+                      CPU::Flags &f) noexcept {
+  f.negate = false;
+  f.half_carry = false;
+  f.carry = !f.carry;
+  return lhs;
+}
 } // namespace operations
+
+template class StaticByteArithmeticOperation<operations::add>;
+template class StaticByteArithmeticOperation<operations::add_with_carry>;
+template class StaticByteArithmeticOperation<operations::subtract>;
+template class StaticByteArithmeticOperation<operations::subtract_with_carry>;
+template class StaticByteArithmeticOperation<operations::bitwise_and>;
+template class StaticByteArithmeticOperation<operations::bitwise_or>;
+template class StaticByteArithmeticOperation<operations::bitwise_xor>;
+template class StaticByteArithmeticOperation<operations::compare>;
+template class StaticByteArithmeticOperation<operations::increment>;
+template class StaticByteArithmeticOperation<operations::decrement>;
+template class StaticByteArithmeticOperation<operations::rotate_left_circular>;
+template class StaticByteArithmeticOperation<operations::rotate_right_circular>;
+template class StaticByteArithmeticOperation<operations::rotate_left>;
+template class StaticByteArithmeticOperation<operations::rotate_right>;
+template class StaticByteArithmeticOperation<
+    operations::rotate_left_circular_accumulator>;
+template class StaticByteArithmeticOperation<
+    operations::rotate_right_circular_accumulator>;
+template class StaticByteArithmeticOperation<
+    operations::rotate_left_accumulator>;
+template class StaticByteArithmeticOperation<
+    operations::rotate_right_accumulator>;
+template class StaticByteArithmeticOperation<operations::shift_left_arithmetic>;
+template class StaticByteArithmeticOperation<
+    operations::shift_right_arithmetic>;
+template class StaticByteArithmeticOperation<operations::shift_right_logical>;
+template class StaticByteArithmeticOperation<operations::swap>;
+template class StaticByteArithmeticOperation<operations::reset_bits>;
+template class StaticByteArithmeticOperation<operations::set_bits>;
+template class StaticByteArithmeticOperation<operations::decimal_adjust>;
+template class StaticByteArithmeticOperation<operations::complement>;
+template class StaticByteArithmeticOperation<operations::set_carry>;
+template class StaticByteArithmeticOperation<operations::complement_carry>;
 } // namespace greenboy::instructions
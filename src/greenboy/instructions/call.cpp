@@ -0,0 +1,25 @@
+#include "greenboy/instructions/call.hpp"
+
+#include <cassert>
+
+#include "greenboy/data_access/word_access.hpp"
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy::instructions {
+Call::Call(std::shared_ptr<const data_access::WordAccess> target,
+           Condition condition)
+    : m_target(std::move(target)), m_condition(condition) {
+  assert(m_target != nullptr);
+}
+
+cycles Call::execute(CPU::RegisterSet &registers, MemoryBus &memory) const {
+  const auto target = m_target->read(registers, memory);
+  if (!is_satisfied(m_condition, registers.f)) {
+    return m_target->access_time();
+  }
+  memory.write(--registers.sp, high_byte(registers.pc));
+  memory.write(--registers.sp, low_byte(registers.pc));
+  registers.pc = target;
+  return m_target->access_time() + cycles{12};
+}
+} // namespace greenboy::instructions
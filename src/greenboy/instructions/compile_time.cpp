@@ -0,0 +1 @@
+#include "greenboy/instructions/compile_time.hpp"
@@ -0,0 +1 @@
+#include "greenboy/instructions/condition.hpp"
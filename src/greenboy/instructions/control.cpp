@@ -0,0 +1,38 @@
+#include "greenboy/instructions/control.hpp"
+
+#include <stdexcept>
+
+namespace greenboy::instructions {
+cycles Nop::execute(CPU::RegisterSet & /* registers */,
+                    MemoryBus & /* memory */) const {
+  return cycles{0};
+}
+
+cycles Halt::execute(CPU::RegisterSet &registers,
+                     MemoryBus & /* memory */) const {
+  registers.halted = true;
+  return cycles{0};
+}
+
+cycles Stop::execute(CPU::RegisterSet &registers,
+                     MemoryBus & /* memory */) const {
+  // STOP is encoded with a padding byte which is skipped without being read
+  ++registers.pc;
+  registers.halted = true;
+  return cycles{0};
+}
+
+InterruptMasterEnable::InterruptMasterEnable(bool enable) noexcept
+    : m_enable(enable) {}
+cycles InterruptMasterEnable::execute(CPU::RegisterSet &registers,
+                                      MemoryBus & /* memory */) const {
+  registers.interrupts_enabled = m_enable;
+  registers.interrupts_delayed = m_enable;
+  return cycles{0};
+}
+
+cycles IllegalInstruction::execute(CPU::RegisterSet & /* registers */,
+                                   MemoryBus & /* memory */) const {
+  throw std::runtime_error("Tried to execute an illegal opcode");
+}
+} // namespace greenboy::instructions
@@ -0,0 +1,22 @@
+#include "greenboy/instructions/jump.hpp"
+
+#include <cassert>
+
+#include "greenboy/data_access/word_access.hpp"
+
+namespace greenboy::instructions {
+Jump::Jump(std::shared_ptr<const data_access::WordAccess> target,
+           Condition condition)
+    : m_target(std::move(target)), m_condition(condition) {
+  assert(m_target != nullptr);
+}
+
+cycles Jump::execute(CPU::RegisterSet &registers, MemoryBus &memory) const {
+  const auto target = m_target->read(registers, memory);
+  if (!is_satisfied(m_condition, registers.f)) {
+    return m_target->access_time();
+  }
+  registers.pc = target;
+  return m_target->access_time() + cycles{4};
+}
+} // namespace greenboy::instructions
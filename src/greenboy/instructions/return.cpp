@@ -0,0 +1,23 @@
+#include "greenboy/instructions/return.hpp"
+
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy::instructions {
+Return::Return(Condition condition, bool enable_interrupts) noexcept
+    : m_condition(condition), m_enable_interrupts(enable_interrupts) {}
+
+cycles Return::execute(CPU::RegisterSet &registers, MemoryBus &memory) const {
+  // Conditional returns spend an extra cycle evaluating the condition
+  const auto evaluation_time =
+      m_condition == Condition::Always ? cycles{0} : cycles{4};
+  if (!is_satisfied(m_condition, registers.f)) {
+    return evaluation_time;
+  }
+  registers.pc = memory.read_word(registers.sp);
+  registers.sp = static_cast<word>(registers.sp + 2);
+  if (m_enable_interrupts) {
+    registers.interrupts_enabled = true;
+  }
+  return evaluation_time + cycles{12};
+}
+} // namespace greenboy::instructions
@@ -0,0 +1,37 @@
+#include "greenboy/instructions/word_arithmetic_operation.hpp"
+
+#include "greenboy/data_access/word_access.hpp"
+
+namespace greenboy::instructions {
+WordArithmeticOperation::WordArithmeticOperation(
+    std::shared_ptr<data_access::WordAccess> lhs,
+    std::shared_ptr<const data_access::WordAccess> rhs,
+    std::function<word(const word, const word, CPU::Flags &)>
+        operation) noexcept
+    : m_lhs(std::move(lhs)), m_rhs(std::move(rhs)),
+      m_operation(std::move(operation)) {}
+
+cycles WordArithmeticOperation::execute(CPU::RegisterSet &registers,
+                                        MemoryBus &memory) const {
+  auto result = m_operation(m_lhs->read(registers, memory),
+                            m_rhs->read(registers, memory), registers.f);
+  m_lhs->write(registers, memory, result);
+  return m_lhs->access_time() + m_rhs->access_time();
+}
+
+namespace operations {
+word add_words(const word lhs, const word rhs, CPU::Flags &f) noexcept {
+  const auto a = static_cast<unsigned>(lhs);
+  const auto b = static_cast<unsigned>(rhs);
+  auto result = a + b;
+  const auto carry = result ^ a ^ b;
+  result &= 0xffff;
+
+  f.negate = false;
+  f.half_carry = (carry & (1u << 12u)) != 0;
+  f.carry = (carry & (1u << 16u)) != 0;
+
+  return static_cast<word>(result);
+}
+} // namespace operations
+} // namespace greenboy::instructions
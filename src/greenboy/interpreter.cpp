@@ -0,0 +1 @@
+#include "greenboy/interpreter.hpp"
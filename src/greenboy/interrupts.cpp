@@ -0,0 +1,21 @@
+#include "greenboy/interrupts.hpp"
+
+#include "greenboy/io_registers.hpp"
+
+namespace greenboy {
+void Interrupts::connect(IoRegisters &io) {
+  io.connect<&Interrupts::read_requested, &Interrupts::write_requested>(
+      requested_address, *this);
+  io.bind(enabled_address, enabled);
+}
+
+void Interrupts::request(byte interrupt) noexcept { requested |= interrupt; }
+
+byte Interrupts::read_requested(word /* address */) const noexcept {
+  return requested | ~requested_mask;
+}
+
+void Interrupts::write_requested(word /* address */, byte value) noexcept {
+  requested = value & requested_mask;
+}
+} // namespace greenboy
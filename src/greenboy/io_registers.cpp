@@ -0,0 +1,58 @@
+#include "greenboy/io_registers.hpp"
+
+#include <stdexcept>
+
+namespace greenboy {
+namespace {
+byte read_open_bus(void * /* component */, word /* address */) {
+  return byte{0xff};
+}
+
+void write_open_bus(void * /* component */, word /* address */,
+                    byte /* value */) {}
+
+byte read_value(void *component, word /* address */) {
+  return *static_cast<const byte *>(component);
+}
+
+void write_value(void *component, word /* address */, byte value) {
+  *static_cast<byte *>(component) = value;
+}
+} // namespace
+
+IoRegisters::IoRegisters() noexcept {
+  m_page.ports.fill({nullptr, read_open_bus, write_open_bus});
+}
+
+std::size_t IoRegisters::index(word address) {
+  if (address < first_address ||
+      PageTableMemoryBus::IoPage::in_high_ram(address & 0xffu)) {
+    throw std::runtime_error(
+        "I/O registers have to lie in 0xff00-0xff7f or at 0xffff");
+  }
+  return address & 0xffu;
+}
+
+IoRegisters &IoRegisters::install(PageTableMemoryBus &bus) {
+  auto registers = std::make_unique<IoRegisters>();
+  auto &installed = *registers;
+  bus.map_io(bus.add_handler(std::move(registers)), installed.m_page);
+  return installed;
+}
+
+void IoRegisters::connect(word address, void *component, Reader reader,
+                          Writer writer) {
+  if (reader == nullptr || writer == nullptr) {
+    throw std::runtime_error("I/O registers need both a reader and a writer");
+  }
+  m_page.ports[index(address)] = {component, reader, writer};
+}
+
+void IoRegisters::bind(word address, byte &value) {
+  connect(address, &value, read_value, write_value);
+}
+
+void IoRegisters::disconnect(word address) {
+  m_page.ports[index(address)] = {nullptr, read_open_bus, write_open_bus};
+}
+} // namespace greenboy
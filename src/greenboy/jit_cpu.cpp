@@ -0,0 +1,816 @@
+#include "greenboy/jit_cpu.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "greenboy/interpreter.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/memory_bus.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+
+namespace greenboy {
+class ExecutableArena {
+  std::uint8_t *m_memory;
+  std::size_t m_size;
+  std::size_t m_used = 0;
+
+  void protect(int protection) {
+    if (mprotect(m_memory, m_size, protection) != 0) {
+      throw std::runtime_error("Could not change the protection of the JIT "
+                               "code arena");
+    }
+  }
+
+public:
+  explicit ExecutableArena(std::size_t size) : m_size(size) {
+    auto *memory = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::runtime_error("Could not allocate the JIT code arena");
+    }
+    m_memory = static_cast<std::uint8_t *>(memory);
+  }
+  ExecutableArena(const ExecutableArena &) = delete;
+  ExecutableArena(ExecutableArena &&) = delete;
+  ~ExecutableArena() noexcept { munmap(m_memory, m_size); }
+
+  ExecutableArena &operator=(const ExecutableArena &) = delete;
+  ExecutableArena &operator=(ExecutableArena &&) = delete;
+
+  // Returns nullptr when the arena is full
+  void *add(const std::vector<std::uint8_t> &code) {
+    if (code.size() > m_size - m_used) {
+      return nullptr;
+    }
+    auto *destination = m_memory + m_used;
+    protect(PROT_READ | PROT_WRITE);
+    std::memcpy(destination, code.data(), code.size());
+    protect(PROT_READ | PROT_EXEC);
+    m_used += code.size();
+    return destination;
+  }
+
+  void reset() noexcept { m_used = 0; }
+};
+
+namespace {
+// The guest registers as they are handed to and from the native code. The
+// field order matches the host registers they are kept in: A in r8b, B in
+// r9b and so on up to F in r15b.
+struct NativeRegisters {
+  byte a;
+  byte b;
+  byte c;
+  byte d;
+  byte e;
+  byte h;
+  byte l;
+  byte f;
+};
+
+// What the native code runs with. It keeps a pointer to this in rbx and
+// passes it on to the functions it calls out to.
+struct NativeState {
+  NativeRegisters registers;
+  MemoryBus *memory;
+  const BlockCache::Block *block;
+  // What the bus threw, to be thrown again once the native code returned
+  std::exception_ptr error;
+};
+
+// Native code returns the time its instructions took in the upper and their
+// length in the lower 16 bits. It returns early, after the instruction which
+// did it, when the bus threw or a write dropped the block being run.
+using NativeCode = std::uint32_t (*)(NativeState *);
+
+constexpr std::uint32_t progress(word length, cycles time) noexcept {
+  return static_cast<std::uint32_t>(time.count()) << 16u | length;
+}
+
+// Returned by the functions below, in place of the byte read, when the
+// native code has to return early
+constexpr std::uint32_t stop = 0x100;
+
+// Called from native code for the accesses it cannot make in place
+std::uint32_t read_memory(NativeState *state, std::uint32_t address) noexcept {
+  try {
+    return to_integer<std::uint32_t>(
+        state->memory->read(static_cast<word>(address)));
+  } catch (...) {
+    state->error = std::current_exception();
+    return stop;
+  }
+}
+
+std::uint32_t write_memory(NativeState *state, std::uint32_t address,
+                           std::uint32_t value) noexcept {
+  try {
+    state->memory->write(static_cast<word>(address), static_cast<byte>(value));
+  } catch (...) {
+    state->error = std::current_exception();
+    return stop;
+  }
+  return state->block->valid ? 0 : stop;
+}
+
+// The page tables native code reads and writes memory through in place, all
+// null when the bus has none and every access calls out
+struct NativeMemory {
+  const byte *const *reads;
+  byte *const *writes;
+  const bool *pages_with_code;
+};
+
+constexpr std::uint8_t A = 0;
+constexpr std::uint8_t H = 5;
+constexpr std::uint8_t L = 6;
+constexpr std::uint8_t F = 7;
+// Stands for the byte at HL, which is loaded into al
+constexpr std::uint8_t M = 0xff;
+
+// Host register holding each operand in the opcode encoding: B, C, D, E, H, L,
+// (HL), A
+constexpr std::array<std::uint8_t, 8> host_register{1, 2, 3, 4, H, L, M, A};
+
+// Maps the flags LAHF stores in AH (SF ZF - AF - PF 1 CF) to Z - H C
+constexpr std::array<std::uint8_t, 256> flags_from_lahf = [] {
+  std::array<std::uint8_t, 256> table{};
+  for (auto ah = 0u; ah < table.size(); ++ah) {
+    table[ah] = static_cast<std::uint8_t>(((ah & 0x40u) != 0 ? 0x80u : 0u) |
+                                          ((ah & 0x10u) != 0 ? 0x20u : 0u) |
+                                          ((ah & 0x01u) != 0 ? 0x10u : 0u));
+  }
+  return table;
+}();
+
+enum class FlagRule { Add, Subtract, And, Logical, Increment, Decrement };
+
+class Assembler {
+  // The jumps to patch once the code they jump to is emitted
+  using Jumps = std::vector<std::size_t>;
+
+  // The jumps out of an instruction which return early, with the progress
+  // up to and including that instruction
+  struct Stop {
+    Jumps jumps;
+    std::uint32_t progress;
+  };
+
+  NativeMemory m_memory;
+  std::vector<std::uint8_t> m_code;
+  Jumps m_stops;
+  std::vector<Stop> m_early_returns;
+
+  void emit(std::initializer_list<std::uint8_t> bytes) {
+    m_code.insert(m_code.end(), bytes);
+  }
+
+  void emit_immediate(std::uint64_t value, unsigned size) {
+    for (auto shift = 0u; shift < size * 8u; shift += 8u) {
+      m_code.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+  }
+
+  // mov rcx, pointer
+  void load_pointer(const void *pointer) {
+    emit({0x48, 0xb9});
+    emit_immediate(reinterpret_cast<std::uintptr_t>(pointer), 8);
+  }
+
+  static std::uint8_t direct(unsigned reg, unsigned rm) noexcept {
+    return static_cast<std::uint8_t>(0xc0u | (reg << 3u) | rm);
+  }
+
+  // Emits a jump, unconditional or on a condition code, whose target is
+  // set by land
+  std::size_t jump() {
+    emit({0xe9});
+    emit_immediate(0, 4);
+    return m_code.size() - 4;
+  }
+
+  std::size_t jump_if(std::uint8_t condition) {
+    emit({0x0f, static_cast<std::uint8_t>(0x80u | condition)});
+    emit_immediate(0, 4);
+    return m_code.size() - 4;
+  }
+
+  void land(std::size_t jump, std::size_t target) {
+    // Wraps around for jumps backwards
+    const auto offset = static_cast<std::uint32_t>(target - jump - 4);
+    for (auto i = 0u; i < 4u; ++i) {
+      m_code[jump + i] = static_cast<std::uint8_t>(offset >> (i * 8u));
+    }
+  }
+
+  void land(std::size_t jump) { land(jump, m_code.size()); }
+
+  // Calls function with the state, the address in esi and the value in
+  // edx, keeping the guest registers the calling convention does not
+  void call(std::uintptr_t function) {
+    emit({0x41, 0x50, 0x41, 0x51, 0x41, 0x52, 0x41, 0x53}); // push r8-r11
+    emit({0x48, 0x89, 0xdf});                               // mov rdi, rbx
+    emit({0x48, 0xb8});                                     // mov rax, ...
+    emit_immediate(function, 8);
+    emit({0xff, 0xd0});                                     // call rax
+    emit({0x41, 0x5b, 0x41, 0x5a, 0x41, 0x59, 0x41, 0x58}); // pop r11-r8
+    emit({0xa9});                                           // test eax, stop
+    emit_immediate(stop, 4);
+    m_stops.push_back(jump_if(0x05));                       // jnz
+  }
+
+  // Loads the page of the address in esi into eax and the pointer to it in
+  // the table into rcx, and jumps to the returned address if that is null
+  std::size_t look_up(const void *table) {
+    emit({0x89, 0xf0});       // mov eax, esi
+    emit({0xc1, 0xe8, 0x08}); // shr eax, 8
+    load_pointer(table);
+    emit({0x48, 0x8b, 0x0c, 0xc1}); // mov rcx, [rcx + rax*8]
+    emit({0x48, 0x85, 0xc9});       // test rcx, rcx
+    return jump_if(0x04);           // jz
+  }
+
+public:
+  explicit Assembler(const NativeMemory &memory) noexcept
+      : m_memory(memory) {}
+
+  [[nodiscard]] const std::vector<std::uint8_t> &code() const noexcept {
+    return m_code;
+  }
+
+  void prologue() {
+    emit({0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57}); // push r12-r15
+    emit({0x53});                                           // push rbx
+    emit({0x48, 0x89, 0xfb});                               // mov rbx, rdi
+    for (std::uint8_t index = 0; index < 8; ++index) {
+      // mov r8b+index, [rbx + index]
+      emit({0x44, 0x8a, static_cast<std::uint8_t>(0x43u | (index << 3u)),
+            index});
+    }
+  }
+
+  // Makes the jumps out of the instruction just emitted return progress
+  void end_instruction(std::uint32_t progress) {
+    if (!m_stops.empty()) {
+      m_early_returns.push_back({std::move(m_stops), progress});
+      m_stops.clear();
+    }
+  }
+
+  // Returns progress, or that of the instruction which returned early
+  void epilogue(std::uint32_t progress) {
+    emit({0xb8}); // mov eax, progress
+    emit_immediate(progress, 4);
+    const auto end = m_code.size();
+    for (std::uint8_t index = 0; index < 8; ++index) {
+      // mov [rbx + index], r8b+index
+      emit({0x44, 0x88, static_cast<std::uint8_t>(0x43u | (index << 3u)),
+            index});
+    }
+    emit({0x5b});                                           // pop rbx
+    emit({0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c}); // pop r15-r12
+    emit({0xc3});                                           // ret
+    for (const auto &early : m_early_returns) {
+      for (const auto at : early.jumps) {
+        land(at);
+      }
+      emit({0xb8});
+      emit_immediate(early.progress, 4);
+      land(jump(), end);
+    }
+  }
+
+  // Puts a register pair into esi, high being the host register of the
+  // high byte
+  void address_of_pair(std::uint8_t high) {
+    emit({0x41, 0x0f, 0xb6, direct(6, high)}); // movzx esi, r8b+high
+    emit({0xc1, 0xe6, 0x08});                  // shl esi, 8
+    // movzx eax, r8b+high+1
+    emit({0x41, 0x0f, 0xb6, direct(0, static_cast<std::uint8_t>(high + 1))});
+    emit({0x09, 0xc6}); // or esi, eax
+  }
+
+  void address_immediate(word address) {
+    emit({0xbe}); // mov esi, address
+    emit_immediate(address, 4);
+  }
+
+  // Puts 0xff00 plus the register low into esi
+  void address_high_page(std::uint8_t low) {
+    emit({0x41, 0x0f, 0xb6, direct(6, low)});      // movzx esi, r8b+low
+    emit({0x81, 0xce, 0x00, 0xff, 0x00, 0x00}); // or esi, 0xff00
+  }
+
+  // Reads the byte at the address in esi into al
+  void load() {
+    std::size_t done = 0;
+    if (m_memory.reads != nullptr) {
+      const auto unmapped = look_up(m_memory.reads);
+      emit({0x40, 0x0f, 0xb6, 0xc6}); // movzx eax, sil
+      emit({0x8a, 0x04, 0x01});       // mov al, [rcx + rax]
+      done = jump();
+      land(unmapped);
+    }
+    call(reinterpret_cast<std::uintptr_t>(&read_memory));
+    if (m_memory.reads != nullptr) {
+      land(done);
+    }
+  }
+
+  // Writes dl to the address in esi. Pages which blocks were decoded from
+  // are written through the bus, which drops those blocks.
+  void store() {
+    std::size_t done = 0;
+    std::size_t code = 0;
+    std::size_t unmapped = 0;
+    if (m_memory.writes != nullptr) {
+      emit({0x89, 0xf0});       // mov eax, esi
+      emit({0xc1, 0xe8, 0x08}); // shr eax, 8
+      load_pointer(m_memory.pages_with_code);
+      emit({0x80, 0x3c, 0x01, 0x00}); // cmp byte [rcx + rax], 0
+      code = jump_if(0x05);           // jnz
+      unmapped = look_up(m_memory.writes);
+      emit({0x40, 0x0f, 0xb6, 0xc6}); // movzx eax, sil
+      emit({0x88, 0x14, 0x01});       // mov [rcx + rax], dl
+      done = jump();
+      land(code);
+      land(unmapped);
+    }
+    emit({0x0f, 0xb6, 0xd2}); // movzx edx, dl
+    call(reinterpret_cast<std::uintptr_t>(&write_memory));
+    if (m_memory.writes != nullptr) {
+      land(done);
+    }
+  }
+
+  // mov dl, r8b+source
+  void value_from(std::uint8_t source) {
+    emit({0x44, 0x88, direct(source, 2)});
+  }
+
+  void value_immediate(byte value) {
+    emit({0xb2, to_integer<std::uint8_t>(value)}); // mov dl, value
+  }
+
+  // mov r8b+destination, al
+  void move_loaded(std::uint8_t destination) {
+    emit({0x41, 0x88, direct(0, destination)});
+  }
+
+  void move(std::uint8_t destination, std::uint8_t source) {
+    emit({0x45, 0x88, direct(source, destination)});
+  }
+
+  void move_immediate(std::uint8_t destination, byte value) {
+    emit({0x41, static_cast<std::uint8_t>(0xb0u + destination),
+          to_integer<std::uint8_t>(value)});
+  }
+
+  void arithmetic(std::uint8_t opcode, std::uint8_t destination,
+                  std::uint8_t source) {
+    emit({0x45, opcode, direct(source, destination)});
+  }
+
+  // The operation on the byte loaded into al
+  void arithmetic_loaded(std::uint8_t opcode, std::uint8_t destination) {
+    emit({0x41, opcode, direct(0, destination)});
+  }
+
+  void arithmetic_immediate(unsigned extension, std::uint8_t destination,
+                            std::uint8_t value) {
+    emit({0x41, 0x80, direct(extension, destination), value});
+  }
+
+  void increment(std::uint8_t destination) {
+    emit({0x41, 0xfe, direct(0, destination)});
+  }
+
+  void decrement(std::uint8_t destination) {
+    emit({0x41, 0xfe, direct(1, destination)});
+  }
+
+  // inc al or dec al, keeping the result in edi while the flags are rebuilt
+  void step_loaded(bool increment) {
+    emit({0xfe, increment ? std::uint8_t{0xc0} : std::uint8_t{0xc8}});
+    emit({0x89, 0xc7}); // mov edi, eax
+  }
+
+  void value_from_step() { emit({0x89, 0xfa}); } // mov edx, edi
+
+  void complement(std::uint8_t destination) {
+    emit({0x41, 0xf6, direct(2, destination)});
+  }
+
+  void and_flags(std::uint8_t mask) { arithmetic_immediate(4, F, mask); }
+  void or_flags(std::uint8_t mask) { arithmetic_immediate(1, F, mask); }
+  void xor_flags(std::uint8_t mask) { arithmetic_immediate(6, F, mask); }
+
+  // Copies the guest carry to the host carry
+  void load_carry() { emit({0x41, 0x0f, 0xba, 0xe7, 0x04}); } // bt r15d, 4
+
+  void save_flags() { emit({0x44, 0x88, 0xfa}); } // mov dl, r15b
+
+  // Rebuilds F from the host flags of the instruction just emitted
+  void store_flags(FlagRule rule) {
+    emit({0x9f});             // lahf
+    emit({0x0f, 0xb6, 0xc4}); // movzx eax, ah
+    load_pointer(flags_from_lahf.data());
+    emit({0x44, 0x8a, 0x3c, 0x01}); // mov r15b, [rcx + rax]
+    switch (rule) {
+    case FlagRule::Add:
+      break;
+    case FlagRule::Subtract:
+      or_flags(0x40);
+      break;
+    case FlagRule::And:
+      and_flags(0x80);
+      or_flags(0x20);
+      break;
+    case FlagRule::Logical:
+      and_flags(0x80);
+      break;
+    case FlagRule::Increment:
+    case FlagRule::Decrement:
+      // The carry is left as it was before the instruction
+      and_flags(0xef);
+      emit({0x80, 0xe2, 0x10}); // and dl, 0x10
+      emit({0x41, 0x08, 0xd7}); // or r15b, dl
+      if (rule == FlagRule::Decrement) {
+        or_flags(0x40);
+      }
+      break;
+    }
+  }
+};
+
+void translate_alu(Assembler &code, unsigned operation, std::uint8_t source,
+                   const byte *immediate) {
+  constexpr std::array<std::uint8_t, 8> register_opcodes{
+      0x00, 0x10, 0x28, 0x18, 0x20, 0x30, 0x08, 0x38};
+  constexpr std::array<unsigned, 8> immediate_extensions{0, 2, 5, 3,
+                                                         4, 6, 1, 7};
+  constexpr std::array<FlagRule, 8> rules{
+      FlagRule::Add,      FlagRule::Add,     FlagRule::Subtract,
+      FlagRule::Subtract, FlagRule::And,     FlagRule::Logical,
+      FlagRule::Logical,  FlagRule::Subtract};
+
+  if (operation == 1 || operation == 3) {
+    code.load_carry();
+  }
+  if (immediate != nullptr) {
+    code.arithmetic_immediate(immediate_extensions.at(operation), A,
+                              to_integer<std::uint8_t>(*immediate));
+  } else if (source == M) {
+    code.arithmetic_loaded(register_opcodes.at(operation), A);
+  } else {
+    code.arithmetic(register_opcodes.at(operation), A, source);
+  }
+  code.store_flags(rules.at(operation));
+}
+
+// Adds or subtracts one to or from HL, as the HL+ and HL- addressing do
+void step_hl(Assembler &code, bool increment) {
+  code.arithmetic_immediate(increment ? 0 : 5, L, 1);
+  code.arithmetic_immediate(increment ? 2 : 3, H, 0);
+}
+
+// Emits the instructions which access memory, addressed in esi
+cycles translate_memory(Assembler &code,
+                        const BlockCache::DecodedInstruction &instruction) {
+  const auto opcode = to_integer<unsigned>(instruction.opcode);
+  const auto y = (opcode >> 3u) & 7u;
+  const auto z = opcode & 7u;
+  const auto &operands = instruction.operands;
+
+  if (opcode >= 0x40 && opcode < 0x80 && opcode != 0x76) {
+    code.address_of_pair(H);
+    if (z == 6) {
+      code.load();
+      code.move_loaded(host_register.at(y));
+    } else {
+      code.value_from(host_register.at(z));
+      code.store();
+    }
+    return cycles{8};
+  }
+  if (opcode >= 0x80 && opcode < 0xc0) {
+    code.address_of_pair(H);
+    code.load();
+    translate_alu(code, y, M, nullptr);
+    return cycles{8};
+  }
+
+  cycles time{};
+  switch (opcode) {
+  case 0x02:
+  case 0x12:
+    code.address_of_pair(host_register.at(y));
+    code.value_from(A);
+    code.store();
+    return cycles{8};
+  case 0x0a:
+  case 0x1a:
+    code.address_of_pair(host_register.at(y - 1));
+    code.load();
+    code.move_loaded(A);
+    return cycles{8};
+  case 0x22:
+  case 0x32:
+    code.address_of_pair(H);
+    step_hl(code, opcode == 0x22);
+    code.value_from(A);
+    code.store();
+    return cycles{8};
+  case 0x2a:
+  case 0x3a:
+    code.address_of_pair(H);
+    step_hl(code, opcode == 0x2a);
+    code.load();
+    code.move_loaded(A);
+    return cycles{8};
+  case 0x34:
+  case 0x35:
+    code.address_of_pair(H);
+    code.load();
+    code.save_flags();
+    code.step_loaded(opcode == 0x34);
+    code.store_flags(opcode == 0x34 ? FlagRule::Increment
+                                    : FlagRule::Decrement);
+    code.value_from_step();
+    code.store();
+    return cycles{12};
+  case 0x36:
+    code.address_of_pair(H);
+    code.value_immediate(operands[0]);
+    code.store();
+    return cycles{12};
+  case 0xe0:
+  case 0xf0:
+    code.address_immediate(
+        static_cast<word>(0xff00u | to_integer<unsigned>(operands[0])));
+    time = cycles{12};
+    break;
+  case 0xe2:
+  case 0xf2:
+    code.address_high_page(host_register.at(1));
+    time = cycles{8};
+    break;
+  case 0xea:
+  case 0xfa:
+    code.address_immediate(to_word(operands[1], operands[0]));
+    time = cycles{16};
+    break;
+  default:
+    return cycles{0};
+  }
+  // The accesses between A and an address
+  if (opcode < 0xf0) {
+    code.value_from(A);
+    code.store();
+  } else {
+    code.load();
+    code.move_loaded(A);
+  }
+  return time;
+}
+
+// Emits the instruction and returns its duration, or returns zero cycles if
+// the instruction has to be interpreted
+cycles translate_instruction(
+    Assembler &code, const BlockCache::DecodedInstruction &instruction) {
+  const auto opcode = to_integer<unsigned>(instruction.opcode);
+  const auto y = (opcode >> 3u) & 7u;
+  const auto z = opcode & 7u;
+
+  if (opcode == 0x00) {
+    return cycles{4};
+  }
+  if ((opcode >= 0x40 && opcode < 0x80 && (y == 6 || z == 6)) ||
+      (opcode >= 0x80 && opcode < 0xc0 && z == 6)) {
+    return translate_memory(code, instruction);
+  }
+  if (opcode >= 0x40 && opcode < 0x80) {
+    code.move(host_register.at(y), host_register.at(z));
+    return cycles{4};
+  }
+  if (opcode >= 0x80 && opcode < 0xc0) {
+    translate_alu(code, y, host_register.at(z), nullptr);
+    return cycles{4};
+  }
+  if ((opcode & 0xc7u) == 0xc6) {
+    translate_alu(code, y, 0, instruction.operands.data());
+    return cycles{8};
+  }
+  if (opcode < 0x40 && y != 6) {
+    switch (z) {
+    case 4:
+      code.save_flags();
+      code.increment(host_register.at(y));
+      code.store_flags(FlagRule::Increment);
+      return cycles{4};
+    case 5:
+      code.save_flags();
+      code.decrement(host_register.at(y));
+      code.store_flags(FlagRule::Decrement);
+      return cycles{4};
+    case 6:
+      code.move_immediate(host_register.at(y), instruction.operands[0]);
+      return cycles{8};
+    default:
+      break;
+    }
+  }
+
+  switch (opcode) {
+  case 0x03:
+  case 0x13:
+  case 0x23: {
+    const auto high = host_register.at(y);
+    code.arithmetic_immediate(0, static_cast<std::uint8_t>(high + 1), 1);
+    code.arithmetic_immediate(2, high, 0);
+    return cycles{8};
+  }
+  case 0x0b:
+  case 0x1b:
+  case 0x2b: {
+    const auto high = host_register.at(y - 1);
+    code.arithmetic_immediate(5, static_cast<std::uint8_t>(high + 1), 1);
+    code.arithmetic_immediate(3, high, 0);
+    return cycles{8};
+  }
+  case 0x2f:
+    code.complement(A);
+    code.or_flags(0x60);
+    return cycles{4};
+  case 0x37:
+    code.and_flags(0x80);
+    code.or_flags(0x10);
+    return cycles{4};
+  case 0x3f:
+    code.and_flags(0x90);
+    code.xor_flags(0x10);
+    return cycles{4};
+  default:
+    return translate_memory(code, instruction);
+  }
+}
+} // namespace
+
+JitCPU::JitCPU(std::unique_ptr<MemoryBus> memory, std::uint32_t hot_threshold)
+    : m_page_table(dynamic_cast<const PageTableMemoryBus *>(memory.get())),
+      m_cache(std::move(memory)),
+      m_arena(std::make_unique<ExecutableArena>(std::size_t{1} << 20u)),
+      m_hot_threshold(hot_threshold) {
+  assert(m_hot_threshold > 0);
+}
+
+JitCPU::~JitCPU() noexcept = default;
+
+void JitCPU::translate(BlockCache::Block &block) {
+  NativeMemory memory{nullptr, nullptr, nullptr};
+  if (m_page_table != nullptr) {
+    memory = {m_page_table->read_pages().data(),
+              m_page_table->write_pages().data(),
+              m_cache.pages_with_code().data()};
+  }
+  // Every run of translatable instructions gets its own native code, and the
+  // interpreter runs the instructions in between
+  const auto &instructions = block.instructions;
+  std::vector<BlockCache::Translation> translations;
+  for (std::size_t first = 0; first < instructions.size(); ++first) {
+    Assembler code{memory};
+    code.prologue();
+    word length = 0;
+    cycles time{};
+    auto last = first;
+    for (; last < instructions.size(); ++last) {
+      const auto &instruction = instructions[last];
+      const auto instruction_time = translate_instruction(code, instruction);
+      if (instruction_time == cycles{0}) {
+        break;
+      }
+      length = static_cast<word>(
+          length + interpreter::instruction_length(instruction.opcode));
+      time += instruction_time;
+      code.end_instruction(progress(length, time));
+    }
+    if (last == first) {
+      continue;
+    }
+    code.epilogue(progress(length, time));
+
+    auto *native = m_arena->add(code.code());
+    if (native == nullptr) {
+      // Start over with an empty arena; the blocks are translated again once
+      // they are hot
+      m_arena->reset();
+      m_cache.invalidate_all();
+      return;
+    }
+    translations.push_back({native, first, last - first});
+    first = last;
+  }
+  if (translations.empty()) {
+    return;
+  }
+  block.translations = std::move(translations);
+  ++m_translations;
+}
+
+cycles JitCPU::update() { return run(cycles{1}); }
+
+cycles JitCPU::run(cycles budget) {
+  PackedRegisterSet registers{m_registers};
+  auto flags = m_registers.f;
+  interpreter::Interpreter<MemoryBus, CPU::Flags> interpreter{
+      registers, flags, m_cache.memory()};
+  const auto store = [&] {
+    registers.set_f(flags);
+    m_registers = registers.unpack();
+    m_cache.release_removed();
+  };
+  NativeState state{{}, &m_cache.memory(), nullptr, nullptr};
+  const auto run_native = [&](const BlockCache::Block &block,
+                              const BlockCache::Translation &translation) {
+    state.registers = {registers.a(), registers.b(),
+                       registers.c(), registers.d(),
+                       registers.e(), registers.h(),
+                       registers.l(), static_cast<byte>(flags)};
+    state.block = &block;
+    const auto done = reinterpret_cast<NativeCode>(translation.code)(&state);
+    const auto &native = state.registers;
+    registers.set_a(native.a);
+    registers.set_b(native.b);
+    registers.set_c(native.c);
+    registers.set_d(native.d);
+    registers.set_e(native.e);
+    registers.set_h(native.h);
+    registers.set_l(native.l);
+    flags = CPU::Flags{native.f};
+    registers.pc = static_cast<word>(registers.pc + (done & 0xffffu));
+    if (state.error != nullptr) {
+      std::rethrow_exception(std::exchange(state.error, nullptr));
+    }
+    return cycles{static_cast<int>(done >> 16u)};
+  };
+  auto *const interrupts = m_interrupts;
+  begin_run(budget);
+  try {
+    while (m_elapsed < m_budget) {
+      if (interrupts != nullptr) {
+        m_elapsed += interrupts->service(registers, m_cache.memory());
+      }
+      if (registers.halted) {
+        m_elapsed += cycles{4};
+        continue;
+      }
+      auto &block = m_cache.block_at(registers.pc);
+      if (block.executions < m_hot_threshold &&
+          ++block.executions == m_hot_threshold) {
+        translate(block);
+      }
+
+      const auto &instructions = block.instructions;
+      auto translation = block.translations.begin();
+      for (std::size_t i = 0; i < instructions.size() && block.valid;) {
+        if (translation != block.translations.end() &&
+            translation->first == i) {
+          m_elapsed += run_native(block, *translation);
+          i += translation->instructions;
+          ++translation;
+          continue;
+        }
+        const auto &instruction = instructions[i++];
+        m_elapsed += interpreter.execute(instruction.opcode,
+                                         instruction.operands.data());
+      }
+      m_cache.release_removed();
+    }
+  } catch (...) {
+    store();
+    end_run();
+    throw;
+  }
+  store();
+  return end_run();
+}
+
+void JitCPU::invalidate(word address) { m_cache.invalidate(address); }
+
+std::size_t JitCPU::translations() const noexcept { return m_translations; }
+
+word JitCPU::pc() const noexcept { return m_registers.pc; }
+
+CPU::RegisterSet &JitCPU::registers() noexcept { return m_registers; }
+
+const CPU::RegisterSet &JitCPU::registers() const noexcept {
+  return m_registers;
+}
+} // namespace greenboy
@@ -0,0 +1 @@
+#include "greenboy/lazy_flags.hpp"
@@ -0,0 +1,37 @@
+#include "greenboy/lcd_registers.hpp"
+
+#include "greenboy/io_registers.hpp"
+
+namespace greenboy {
+namespace {
+constexpr byte stat_writable{0x78};
+} // namespace
+
+void LcdRegisters::connect(IoRegisters &io) {
+  io.bind(lcdc_address, lcdc);
+  io.connect<&LcdRegisters::read_stat, &LcdRegisters::write_stat>(
+      stat_address, *this);
+  io.bind(scy_address, scy);
+  io.bind(scx_address, scx);
+  io.connect<&LcdRegisters::read_ly, &LcdRegisters::write_ly>(ly_address,
+                                                             *this);
+  io.bind(lyc_address, lyc);
+  io.bind(bgp_address, bgp);
+  io.bind(obp0_address, obp0);
+  io.bind(obp1_address, obp1);
+  io.bind(wy_address, wy);
+  io.bind(wx_address, wx);
+}
+
+byte LcdRegisters::read_stat(word /* address */) const noexcept {
+  return stat | byte{0x80};
+}
+
+void LcdRegisters::write_stat(word /* address */, byte value) noexcept {
+  stat = (stat & ~stat_writable) | (value & stat_writable);
+}
+
+byte LcdRegisters::read_ly(word /* address */) const noexcept { return ly; }
+
+void LcdRegisters::write_ly(word /* address */, byte /* value */) noexcept {}
+} // namespace greenboy
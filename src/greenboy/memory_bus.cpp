@@ -1 +1,28 @@
 #include "greenboy/memory_bus.hpp"
+
+namespace greenboy {
+word MemoryBus::read_word(word address) const {
+  const auto low = read(address);
+  const auto high = read(static_cast<word>(address + 1));
+  return to_word(high, low);
+}
+
+void MemoryBus::write_word(word address, word value) {
+  write(address, low_byte(value));
+  write(static_cast<word>(address + 1), high_byte(value));
+}
+
+void MemoryBus::read_block(word start, byte *destination,
+                           std::size_t size) const {
+  for (std::size_t i = 0; i < size; ++i) {
+    destination[i] = read(static_cast<word>(start + i));
+  }
+}
+
+void MemoryBus::write_block(word start, const byte *source,
+                            std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    write(static_cast<word>(start + i), source[i]);
+  }
+}
+} // namespace greenboy
@@ -0,0 +1,31 @@
+#include "greenboy/packed_register_set.hpp"
+
+namespace greenboy {
+PackedRegisterSet::PackedRegisterSet(const CPU::RegisterSet &registers) noexcept
+    : m_bc(to_word(registers.b, registers.c)),
+      m_de(to_word(registers.d, registers.e)),
+      m_hl(to_word(registers.h, registers.l)),
+      m_af(to_word(registers.a, static_cast<byte>(registers.f))),
+      pc(registers.pc), sp(registers.sp),
+      interrupts_enabled(registers.interrupts_enabled),
+      interrupts_delayed(registers.interrupts_delayed),
+      halted(registers.halted) {}
+
+CPU::RegisterSet PackedRegisterSet::unpack() const noexcept {
+  CPU::RegisterSet registers{};
+  registers.pc = pc;
+  registers.sp = sp;
+  registers.b = b();
+  registers.c = c();
+  registers.d = d();
+  registers.e = e();
+  registers.h = h();
+  registers.l = l();
+  registers.a = a();
+  registers.f = f();
+  registers.interrupts_enabled = interrupts_enabled;
+  registers.interrupts_delayed = interrupts_delayed;
+  registers.halted = halted;
+  return registers;
+}
+} // namespace greenboy
@@ -0,0 +1,341 @@
+#include "greenboy/page_table_memory_bus.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GREENBOY_REMAP_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace greenboy {
+namespace {
+class OpenBus final : public PageTableMemoryBus::Handler {
+public:
+  byte read(word /* address */) const override { return byte{0xff}; }
+  void write(word /* address */, byte /* value */) override {}
+};
+} // namespace
+
+class PageTableMemoryBus::DirtyTracker final : public Handler {
+  PageTableMemoryBus &m_bus;
+
+public:
+  explicit DirtyTracker(PageTableMemoryBus &bus) noexcept : m_bus(bus) {}
+
+  byte read(word /* address */) const override { return byte{0xff}; }
+
+  void write(word address, byte value) override {
+    const auto page = static_cast<unsigned>(address) >> 8u;
+    m_bus.mark_dirty(address, 1);
+    if (auto *memory = m_bus.m_tracked_write[page]) {
+      memory[address & 0xffu] = value;
+    } else {
+      m_bus.m_handlers[m_bus.m_tracked_handler[page]]->write(address, value);
+    }
+  }
+};
+
+PageTableMemoryBus::PageTableMemoryBus() {
+  m_handlers.push_back(std::make_unique<OpenBus>());
+  m_handlers.push_back(std::make_unique<DirtyTracker>(*this));
+}
+
+std::size_t PageTableMemoryBus::first_page(word address, std::size_t size) {
+  if (address % page_size != 0 || size % page_size != 0) {
+    throw std::runtime_error("Mappings have to be aligned to whole pages");
+  }
+  if (address + size > page_size * page_count) {
+    throw std::runtime_error("Mappings may not extend past the end of the bus");
+  }
+  return address / page_size;
+}
+
+bool PageTableMemoryBus::set_aside(std::size_t page) const noexcept {
+  return m_locked_out && page < IoPage::page;
+}
+
+const byte *&PageTableMemoryBus::read_entry(std::size_t page) noexcept {
+  return set_aside(page) ? m_saved_read[page] : m_read[page];
+}
+
+byte *&PageTableMemoryBus::write_entry(std::size_t page) noexcept {
+  return set_aside(page) ? m_saved_write[page] : m_write[page];
+}
+
+PageTableMemoryBus::HandlerIndex &
+PageTableMemoryBus::read_handler_entry(std::size_t page) noexcept {
+  return set_aside(page) ? m_saved_read_handler[page] : m_read_handler[page];
+}
+
+PageTableMemoryBus::HandlerIndex &
+PageTableMemoryBus::write_handler_entry(std::size_t page) noexcept {
+  return set_aside(page) ? m_saved_write_handler[page]
+                         : m_write_handler[page];
+}
+
+void PageTableMemoryBus::check_handler(HandlerIndex handler) const {
+  if (handler >= m_handlers.size() || handler == dirty_tracker) {
+    throw std::runtime_error("Tried to map an unknown handler");
+  }
+}
+
+void PageTableMemoryBus::map_write(std::size_t page, byte *memory,
+                                   HandlerIndex handler) {
+  if (m_tracked[page]) {
+    m_tracked_write[page] = memory;
+    m_tracked_handler[page] = handler;
+  } else {
+    write_entry(page) = memory;
+    write_handler_entry(page) = handler;
+  }
+}
+
+void PageTableMemoryBus::unmap_io(std::size_t first,
+                                  std::size_t size) noexcept {
+  if (first + size / page_size > IoPage::page) {
+    m_io_reads = nullptr;
+    m_io_writes = nullptr;
+  }
+}
+
+void PageTableMemoryBus::mark_dirty(std::size_t address, std::size_t size) {
+  const auto last = (address + size - 1) / dirty_block_size;
+  for (auto block = address / dirty_block_size; block <= last; ++block) {
+    m_dirty.set(block % m_dirty.size());
+  }
+}
+
+void PageTableMemoryBus::read_block(word start, byte *destination,
+                                    std::size_t size) const {
+  auto address = static_cast<std::size_t>(start);
+  while (size > 0) {
+    const auto page = (address >> 8u) & 0xffu;
+    const auto offset = address & 0xffu;
+    const auto run = std::min(size, page_size - offset);
+    if (const auto *memory = m_read[page]) {
+      std::memcpy(destination, memory + offset, run);
+    } else {
+      const auto &handler = *m_handlers[m_read_handler[page]];
+      for (std::size_t i = 0; i < run; ++i) {
+        destination[i] = handler.read(static_cast<word>(address + i));
+      }
+    }
+    address += run;
+    destination += run;
+    size -= run;
+  }
+}
+
+void PageTableMemoryBus::write_block(word start, const byte *source,
+                                     std::size_t size) {
+  auto address = static_cast<std::size_t>(start);
+  while (size > 0) {
+    const auto page = (address >> 8u) & 0xffu;
+    const auto offset = address & 0xffu;
+    const auto run = std::min(size, page_size - offset);
+    if (auto *memory = m_write[page]) {
+      std::memcpy(memory + offset, source, run);
+    } else if (m_write_handler[page] == dirty_tracker &&
+               m_tracked_write[page] != nullptr) {
+      std::memcpy(m_tracked_write[page] + offset, source, run);
+      mark_dirty(address, run);
+    } else {
+      auto &handler = *m_handlers[m_write_handler[page]];
+      for (std::size_t i = 0; i < run; ++i) {
+        handler.write(static_cast<word>(address + i), source[i]);
+      }
+    }
+    address += run;
+    source += run;
+    size -= run;
+  }
+}
+
+PageTableMemoryBus::HandlerIndex
+PageTableMemoryBus::add_handler(std::unique_ptr<Handler> handler) {
+  if (handler == nullptr) {
+    throw std::runtime_error("Parameter handler may not be null");
+  }
+  if (m_handlers.size() > std::numeric_limits<HandlerIndex>::max()) {
+    throw std::runtime_error("No more handlers can be added to the bus");
+  }
+  m_handlers.push_back(std::move(handler));
+  return static_cast<HandlerIndex>(m_handlers.size() - 1);
+}
+
+PageTableMemoryBus::Handler &
+PageTableMemoryBus::handler(HandlerIndex index) const {
+  check_handler(index);
+  return *m_handlers[index];
+}
+
+void PageTableMemoryBus::map(word address, std::size_t size, byte *memory) {
+  const auto first = first_page(address, size);
+  unmap_io(first, size);
+  for (std::size_t i = 0; i < size / page_size; ++i) {
+    read_entry(first + i) = memory + i * page_size;
+    map_write(first + i, memory + i * page_size, open_bus);
+  }
+}
+
+void PageTableMemoryBus::map_read_only(word address, std::size_t size,
+                                       const byte *memory,
+                                       HandlerIndex writes) {
+  const auto first = first_page(address, size);
+  check_handler(writes);
+  unmap_io(first, size);
+  for (std::size_t i = 0; i < size / page_size; ++i) {
+    read_entry(first + i) = memory + i * page_size;
+    map_write(first + i, nullptr, writes);
+  }
+}
+
+void PageTableMemoryBus::map_handler(word address, std::size_t size,
+                                     HandlerIndex handler) {
+  const auto first = first_page(address, size);
+  check_handler(handler);
+  unmap_io(first, size);
+  for (std::size_t i = first; i < first + size / page_size; ++i) {
+    read_entry(i) = nullptr;
+    read_handler_entry(i) = handler;
+    map_write(i, nullptr, handler);
+  }
+}
+
+void PageTableMemoryBus::map_io(HandlerIndex handler, IoPage &io) {
+  map_handler(static_cast<word>(IoPage::page * page_size), page_size,
+              handler);
+  m_io_reads = &io;
+  m_io_writes = m_tracked[IoPage::page] ? nullptr : &io;
+}
+
+void PageTableMemoryBus::remap_read(word address, std::size_t size,
+                                    const byte *memory) noexcept {
+  const auto first = static_cast<std::size_t>(address) / page_size;
+  const auto pages = size / page_size;
+  // Only ever used for ROM banks, which lie below page 0xff
+  auto &reads = m_locked_out ? m_saved_read : m_read;
+  std::size_t i = 0;
+#ifdef GREENBOY_REMAP_SIMD
+  // Two page pointers per store, as the compiler does not vectorise stores
+  // of pointers
+  const auto base = reinterpret_cast<long long>(memory);
+  constexpr auto stride = static_cast<long long>(page_size);
+  auto pair = _mm_set_epi64x(base + stride, base);
+  const auto step = _mm_set1_epi64x(2 * stride);
+  for (; i + 2 <= pages; i += 2) {
+    std::memcpy(&reads[first + i], &pair, sizeof(pair));
+    pair = _mm_add_epi64(pair, step);
+  }
+#endif
+  for (; i < pages; ++i) {
+    reads[first + i] = memory + i * page_size;
+  }
+}
+
+void PageTableMemoryBus::track_writes(word address, std::size_t size) {
+  const auto first = first_page(address, size);
+  for (std::size_t i = first; i < first + size / page_size; ++i) {
+    if (!m_tracked[i]) {
+      m_tracked_write[i] = write_entry(i);
+      m_tracked_handler[i] = write_handler_entry(i);
+      m_tracked.set(i);
+      write_entry(i) = nullptr;
+      write_handler_entry(i) = dirty_tracker;
+    }
+  }
+  if (first + size / page_size > IoPage::page) {
+    m_io_writes = nullptr;
+  }
+}
+
+void PageTableMemoryBus::untrack_writes(word address, std::size_t size) {
+  const auto first = first_page(address, size);
+  for (std::size_t i = first; i < first + size / page_size; ++i) {
+    if (m_tracked[i]) {
+      m_tracked.reset(i);
+      write_entry(i) = m_tracked_write[i];
+      write_handler_entry(i) = m_tracked_handler[i];
+    }
+  }
+  if (first + size / page_size > IoPage::page) {
+    m_io_writes = m_io_reads;
+  }
+}
+
+void PageTableMemoryBus::mark_written(word start, std::size_t size) {
+  auto address = static_cast<std::size_t>(start);
+  while (size > 0) {
+    const auto page = (address >> 8u) & 0xffu;
+    const auto run = std::min(size, page_size - (address & 0xffu));
+    if (m_tracked[page]) {
+      mark_dirty(address, run);
+    }
+    address += run;
+    size -= run;
+  }
+}
+
+void PageTableMemoryBus::lock_out() noexcept {
+  if (m_locked_out) {
+    return;
+  }
+  constexpr auto pages = IoPage::page;
+  std::copy_n(m_read.begin(), pages, m_saved_read.begin());
+  std::copy_n(m_write.begin(), pages, m_saved_write.begin());
+  std::copy_n(m_read_handler.begin(), pages, m_saved_read_handler.begin());
+  std::copy_n(m_write_handler.begin(), pages, m_saved_write_handler.begin());
+  std::fill_n(m_read.begin(), pages, nullptr);
+  std::fill_n(m_write.begin(), pages, nullptr);
+  std::fill_n(m_read_handler.begin(), pages, open_bus);
+  std::fill_n(m_write_handler.begin(), pages, open_bus);
+  m_locked_out = true;
+}
+
+void PageTableMemoryBus::unlock() noexcept {
+  if (!m_locked_out) {
+    return;
+  }
+  constexpr auto pages = IoPage::page;
+  std::copy_n(m_saved_read.begin(), pages, m_read.begin());
+  std::copy_n(m_saved_write.begin(), pages, m_write.begin());
+  std::copy_n(m_saved_read_handler.begin(), pages, m_read_handler.begin());
+  std::copy_n(m_saved_write_handler.begin(), pages, m_write_handler.begin());
+  m_locked_out = false;
+}
+
+bool PageTableMemoryBus::locked_out() const noexcept { return m_locked_out; }
+
+const PageTableMemoryBus::DirtyMap &
+PageTableMemoryBus::dirty_map() const noexcept {
+  return m_dirty;
+}
+
+bool PageTableMemoryBus::dirty(word address, std::size_t size) const {
+  if (size == 0) {
+    return false;
+  }
+  const auto last = (address + size - 1) / dirty_block_size;
+  for (auto block = address / dirty_block_size; block <= last; ++block) {
+    if (m_dirty[block % m_dirty.size()]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void PageTableMemoryBus::clear_dirty() noexcept { m_dirty.reset(); }
+
+void PageTableMemoryBus::clear_dirty(word address, std::size_t size) {
+  if (address % dirty_block_size != 0 || size % dirty_block_size != 0) {
+    throw std::runtime_error("Only whole dirty blocks can be cleared");
+  }
+  for (std::size_t block = address / dirty_block_size;
+       block < (address + size) / dirty_block_size; ++block) {
+    m_dirty.reset(block % m_dirty.size());
+  }
+}
+} // namespace greenboy
@@ -0,0 +1,565 @@
+#include "greenboy/ppu.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+#include "greenboy/cpu.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/io_registers.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+#include "greenboy/tile_cache.hpp"
+
+namespace greenboy {
+namespace {
+constexpr word vram_address = 0x8000;
+constexpr word oam_address = 0xfe00;
+constexpr unsigned visible_lines = 144;
+constexpr std::size_t sprite_count = 40;
+constexpr std::size_t tile_size = 16;
+// The window starts on a line only for WX up to 166, and sprites are only
+// fetched up to an OAM position of 167
+constexpr unsigned last_window_x = 166;
+constexpr unsigned last_sprite_x = 167;
+constexpr unsigned sprite_stall = 6;
+
+constexpr byte mode_bits{0x03};
+constexpr byte coincidence{0x04};
+constexpr byte coincidence_source{0x40};
+// The STAT bit which raises the interrupt on entering each mode
+constexpr std::array<byte, 4> mode_sources{byte{0x08}, byte{0x10}, byte{0x20},
+                                           byte{0x00}};
+constexpr cycles frame_time =
+    Ppu::line_time * static_cast<int>(Ppu::line_count);
+
+constexpr byte background_priority{0x80};
+constexpr byte flip_vertically{0x40};
+constexpr byte flip_horizontally{0x20};
+constexpr byte second_palette{0x10};
+
+bool set(byte value, byte mask) noexcept { return (value & mask) != byte{0}; }
+
+unsigned sprite_height(byte lcdc) noexcept {
+  return set(lcdc, LcdRegisters::tall_sprites) ? 16u : 8u;
+}
+} // namespace
+
+class Ppu::OamWrites final : public PageTableMemoryBus::Handler {
+  Ppu &m_ppu;
+
+public:
+  explicit OamWrites(Ppu &ppu) noexcept : m_ppu(ppu) {}
+
+  byte read(word address) const override {
+    return m_ppu.m_oam[address - oam_address];
+  }
+  void write(word address, byte value) override {
+    m_ppu.write_oam(address, value);
+  }
+};
+
+Ppu::Ppu(PageTableMemoryBus &bus, IoRegisters &io, Interrupts &interrupts,
+         Drawing drawing)
+    : m_bus(bus), m_interrupts(interrupts), m_io(io), m_drawing(drawing),
+      m_oam_writes(bus.add_handler(std::make_unique<OamWrites>(*this))) {
+  bus.map(vram_address, m_vram.size(), m_vram.data());
+  if (drawing != Drawing::None) {
+    m_tiles = &TileCache::install(bus, m_vram.data());
+  }
+  lock_oam(false);
+  m_registers.connect(io);
+  io.connect<&Ppu::read_lcdc, &Ppu::write_lcdc>(LcdRegisters::lcdc_address,
+                                                *this);
+  io.connect<&Ppu::read_stat, &Ppu::write_stat>(LcdRegisters::stat_address,
+                                                *this);
+  io.connect<&Ppu::read_scx, &Ppu::write_scx>(LcdRegisters::scx_address,
+                                              *this);
+  for (auto address : {LcdRegisters::wy_address, LcdRegisters::wx_address}) {
+    io.connect<&Ppu::read_window, &Ppu::write_window>(address, *this);
+  }
+  io.connect<&Ppu::read_ly, &Ppu::write_ly>(LcdRegisters::ly_address, *this);
+  io.connect<&Ppu::read_lyc, &Ppu::write_lyc>(LcdRegisters::lyc_address,
+                                              *this);
+  update_stat();
+  lock(m_mode);
+  update_horizon();
+}
+
+void Ppu::attach(Dma &dma) {
+  m_dma = &dma;
+  if (dma.model() == Dma::Model::Cgb) {
+    m_io.connect<&Ppu::read_hdma5, &Ppu::write_hdma5>(Dma::hdma5_address,
+                                                      *this);
+  }
+  m_io.connect<&Ppu::read_oam_dma, &Ppu::write_oam_dma>(Dma::oam_dma_address,
+                                                        *this);
+}
+
+void Ppu::follow(CPU &cpu) noexcept { m_cpu = &cpu; }
+
+void Ppu::catch_up() {
+  // Between the end of a run and the advance by it, the run has been left
+  if (m_cpu != nullptr && m_cpu->elapsed() > m_followed) {
+    m_pending += m_cpu->elapsed() - m_followed;
+    m_followed = m_cpu->elapsed();
+  }
+  const auto pending = m_pending;
+  m_pending = cycles{0};
+  run(pending);
+  update_horizon();
+}
+
+void Ppu::run(cycles c) {
+  if (!set(m_registers.lcdc, LcdRegisters::lcd_enable)) {
+    if (m_enabled) {
+      switch_off();
+    }
+    return;
+  }
+  if (!m_enabled) {
+    m_enabled = true;
+    enter(Mode::OamScan);
+  }
+  m_dot += c;
+  for (;;) {
+    if (m_mode == Mode::Transfer) {
+      // Until the subclass leaves the end of mode 3 where it is
+      const auto end = m_next;
+      transfer(std::min(m_dot, m_next) - oam_scan_time);
+      if (m_next != end) {
+        continue;
+      }
+    }
+    if (m_dot < m_next) {
+      break;
+    }
+    switch (m_mode) {
+    case Mode::OamScan:
+      enter(Mode::Transfer);
+      begin_transfer();
+      break;
+    case Mode::Transfer:
+      end_transfer();
+      enter(Mode::HBlank);
+      if (m_dma != nullptr) {
+        m_dma->hblank();
+      }
+      break;
+    case Mode::HBlank:
+    case Mode::VBlank:
+      next_line();
+      break;
+    }
+  }
+}
+
+cycles Ppu::horizon() const noexcept {
+  if (set(m_registers.lcdc, LcdRegisters::lcd_enable) != m_enabled) {
+    return cycles{0};
+  }
+  if (!m_enabled) {
+    return frame_time;
+  }
+  if (m_drawing == Drawing::PerDot && m_mode == Mode::Transfer) {
+    return cycles{0};
+  }
+  // The VBlank interrupt, which is also the end of the frame
+  auto horizon = until_line(visible_lines);
+  const auto stat = m_registers.stat;
+  if (m_drawing != Drawing::None ||
+      set(stat, mode_sources[0] | mode_sources[2]) ||
+      (m_dma != nullptr && m_dma->hblank_transfer())) {
+    horizon = std::min(horizon, m_next - m_dot);
+  }
+  const auto lyc = to_integer<unsigned>(m_registers.lyc);
+  if (set(stat, coincidence_source) && lyc < line_count) {
+    horizon = std::min(horizon, until_line(lyc));
+  }
+  return horizon;
+}
+
+void Ppu::update_horizon() noexcept {
+  m_horizon = horizon();
+  if (m_cpu != nullptr) {
+    m_cpu->limit(m_horizon);
+  }
+}
+
+cycles Ppu::until_line(unsigned line) const noexcept {
+  const auto current = to_integer<unsigned>(m_registers.ly);
+  const auto lines = (line + line_count - current - 1) % line_count + 1;
+  return line_time * static_cast<int>(lines) - m_dot;
+}
+
+void Ppu::enter(Mode mode) {
+  m_mode = mode;
+  switch (mode) {
+  case Mode::OamScan:
+    m_next = oam_scan_time;
+    break;
+  case Mode::Transfer:
+    m_next = oam_scan_time + transfer_time +
+             cycles{to_integer<int>(m_registers.scx & byte{0x07})} +
+             transfer_stalls();
+    break;
+  case Mode::HBlank:
+  case Mode::VBlank:
+    m_next = line_time;
+    break;
+  }
+  lock(mode);
+  update_stat();
+}
+
+cycles Ppu::transfer_stalls() const {
+  const auto &registers = m_registers;
+  const auto lcdc = registers.lcdc;
+  const auto wx = to_integer<unsigned>(registers.wx);
+  const auto window = set(lcdc, LcdRegisters::background_enable) &&
+                      set(lcdc, LcdRegisters::window_enable) &&
+                      registers.wy <= registers.ly && wx <= last_window_x;
+  unsigned stalls = 0;
+  if (window) {
+    // The fetcher throws away the pixels of the window left of the screen
+    stalls += window_stall + (wx < 7 ? 7 - wx : 0);
+  }
+  if (set(lcdc, LcdRegisters::sprites_enable)) {
+    std::array<std::size_t, sprites_per_line> found{};
+    std::array<unsigned, sprites_per_line> positions{};
+    const auto count = scan_oam(found);
+    for (std::size_t i = 0; i < count; ++i) {
+      positions[i] = to_integer<unsigned>(m_oam[found[i] * 4 + 1]);
+    }
+    std::sort(positions.begin(), positions.begin() + count);
+    SpriteStalls sprites;
+    for (std::size_t i = 0; i < count && positions[i] <= last_sprite_x; ++i) {
+      const auto x = positions[i];
+      const auto in_window = window && std::max(x, 8u) - 1 >= wx;
+      stalls += sprites.next(x, registers, in_window);
+    }
+  }
+  return cycles{static_cast<int>(stalls)};
+}
+
+// Only the tiers which draw per dot can tell when the CPU accesses VRAM or
+// OAM within a mode, so the others leave them open
+void Ppu::lock(Mode mode) {
+  if (m_drawing != Drawing::PerDot) {
+    return;
+  }
+  const auto vram = mode == Mode::Transfer;
+  if (vram != m_vram_locked) {
+    m_vram_locked = vram;
+    if (vram) {
+      m_bus.map_handler(vram_address, m_vram.size(),
+                        PageTableMemoryBus::open_bus);
+    } else {
+      m_bus.map(vram_address, m_vram.size(), m_vram.data());
+      tiles().map(m_bus);
+    }
+  }
+  const auto oam = vram || mode == Mode::OamScan;
+  if (oam != m_oam_locked) {
+    m_oam_locked = oam;
+    lock_oam(oam);
+  }
+}
+
+void Ppu::lock_oam(bool locked) {
+  if (locked) {
+    m_bus.map_handler(oam_address, PageTableMemoryBus::page_size,
+                      PageTableMemoryBus::open_bus);
+  } else {
+    m_bus.map_read_only(oam_address, PageTableMemoryBus::page_size,
+                        m_oam.data(), m_oam_writes);
+  }
+}
+
+void Ppu::next_line() {
+  m_dot -= line_time;
+  auto line = to_integer<unsigned>(m_registers.ly) + 1;
+  if (line == line_count) {
+    line = 0;
+    m_window_line = 0;
+  }
+  m_registers.ly = static_cast<byte>(line);
+  if (line == visible_lines) {
+    ++m_frames;
+    m_interrupts.request(Interrupts::vblank);
+    enter(Mode::VBlank);
+  } else if (line < visible_lines) {
+    enter(Mode::OamScan);
+  } else {
+    update_stat();
+  }
+}
+
+void Ppu::switch_off() noexcept {
+  m_enabled = false;
+  m_mode = Mode::HBlank;
+  m_dot = cycles{0};
+  m_window_line = 0;
+  m_stat_line = false;
+  m_registers.ly = byte{0};
+  m_registers.stat &= ~mode_bits;
+  lock(m_mode);
+}
+
+void Ppu::update_stat() noexcept {
+  auto stat = m_registers.stat & ~(mode_bits | coincidence);
+  stat |= static_cast<byte>(m_mode);
+  const auto matches = m_registers.ly == m_registers.lyc;
+  if (matches) {
+    stat |= coincidence;
+  }
+  m_registers.stat = stat;
+
+  // The interrupt is raised when any of the enabled sources becomes active
+  const auto line = (matches && set(stat, coincidence_source)) ||
+                    set(stat, mode_sources[static_cast<std::size_t>(m_mode)]);
+  if (line && !m_stat_line) {
+    m_interrupts.request(Interrupts::stat);
+  }
+  m_stat_line = line;
+}
+
+byte Ppu::shade(byte palette, unsigned colour) noexcept {
+  return static_cast<byte>(to_integer<unsigned>(palette) >> (colour * 2u) &
+                           0x03u);
+}
+
+std::size_t Ppu::tile_row(byte tile, unsigned row) const noexcept {
+  const auto offset = row * 2u;
+  if (set(m_registers.lcdc, LcdRegisters::unsigned_tiles)) {
+    return to_integer<std::size_t>(tile) * tile_size + offset;
+  }
+  return static_cast<std::size_t>(
+             0x1000 +
+             static_cast<std::int8_t>(tile) * static_cast<int>(tile_size)) +
+         offset;
+}
+
+std::size_t Ppu::scan_oam(
+    std::array<std::size_t, sprites_per_line> &found) const noexcept {
+  const auto line = to_integer<unsigned>(m_registers.ly);
+  const auto height = sprite_height(m_registers.lcdc);
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < sprite_count && count < found.size(); ++i) {
+    if (line + 16u - to_integer<unsigned>(m_oam[i * 4]) < height) {
+      found[count++] = i;
+    }
+  }
+  return count;
+}
+
+Ppu::Sprites Ppu::line_sprites() {
+  const auto line = to_integer<unsigned>(m_registers.ly);
+  const auto height = sprite_height(m_registers.lcdc);
+  auto &tiles = this->tiles();
+  std::array<std::size_t, sprites_per_line> found{};
+  Sprites sprites{};
+  sprites.count = scan_oam(found);
+  for (std::size_t i = 0; i < sprites.count; ++i) {
+    const auto *sprite = m_oam.data() + found[i] * 4;
+    auto row = line + 16u - to_integer<unsigned>(sprite[0]);
+    const auto attributes = sprite[3];
+    if (set(attributes, flip_vertically)) {
+      row = height - 1 - row;
+    }
+    auto tile = to_integer<std::size_t>(sprite[2]);
+    if (height == 16) {
+      tile &= 0xfeu;
+    }
+    auto &sprite_row = sprites.rows[i];
+    std::copy_n(tiles.row(tile * tile_size + row * 2u,
+                          set(attributes, flip_horizontally)),
+                sprite_row.colours.size(), sprite_row.colours.begin());
+    sprite_row.attributes = attributes;
+    sprite_row.x = to_integer<unsigned>(sprite[1]);
+  }
+  // Further left is in front, and earlier in OAM for equal positions
+  std::stable_sort(sprites.rows.begin(), sprites.rows.begin() + sprites.count,
+                   [](const SpriteRow &left, const SpriteRow &right) {
+                     return left.x < right.x;
+                   });
+  return sprites;
+}
+
+cycles Ppu::transfer_length() const noexcept {
+  return m_next - oam_scan_time;
+}
+
+void Ppu::set_transfer_length(cycles length) noexcept {
+  m_next = oam_scan_time + length;
+}
+
+unsigned Ppu::next_window_line() noexcept { return m_window_line++; }
+
+byte *Ppu::line_pixels() noexcept {
+  return m_frame.data() + to_integer<std::size_t>(m_registers.ly) *
+                              screen_width;
+}
+
+TileCache &Ppu::tiles() noexcept {
+  assert(m_tiles != nullptr);
+  return *m_tiles;
+}
+
+const LcdRegisters &Ppu::lcd() const noexcept { return m_registers; }
+
+bool Ppu::SpriteRow::behind_background() const noexcept {
+  return set(attributes, background_priority);
+}
+
+unsigned Ppu::SpriteStalls::next(unsigned x, const LcdRegisters &registers,
+                                 bool in_window) noexcept {
+  // The position of the fetcher at the left edge of the sprite, where that
+  // of the window is kept apart from any of the background
+  const auto position = in_window
+                            ? x + 0x1ffu - to_integer<unsigned>(registers.wx)
+                            : x + to_integer<unsigned>(registers.scx);
+  auto stall = sprite_stall;
+  if (position / 8u != m_tile) {
+    m_tile = position / 8u;
+    stall += 5u - std::min(5u, position % 8u);
+  }
+  return stall;
+}
+
+byte Ppu::SpriteRow::palette(const LcdRegisters &registers) const noexcept {
+  return set(attributes, second_palette) ? registers.obp1 : registers.obp0;
+}
+
+byte Ppu::read_lcdc(word /* address */) const noexcept {
+  return m_registers.lcdc;
+}
+
+void Ppu::write_lcdc(word /* address */, byte value) {
+  catch_up();
+  m_registers.lcdc = value;
+  update_horizon();
+}
+
+byte Ppu::read_stat(word address) {
+  catch_up();
+  return m_registers.read_stat(address);
+}
+
+void Ppu::write_stat(word address, byte value) {
+  catch_up();
+  m_registers.write_stat(address, value);
+  if (m_enabled) {
+    update_stat();
+  }
+  update_horizon();
+}
+
+byte Ppu::read_scx(word /* address */) const noexcept {
+  return m_registers.scx;
+}
+
+void Ppu::write_scx(word /* address */, byte value) {
+  catch_up();
+  m_registers.scx = value;
+}
+
+byte Ppu::read_window(word address) const noexcept {
+  return address == LcdRegisters::wy_address ? m_registers.wy
+                                             : m_registers.wx;
+}
+
+void Ppu::write_window(word address, byte value) {
+  catch_up();
+  if (address == LcdRegisters::wy_address) {
+    m_registers.wy = value;
+  } else {
+    m_registers.wx = value;
+  }
+}
+
+byte Ppu::read_ly(word /* address */) {
+  catch_up();
+  return m_registers.ly;
+}
+
+void Ppu::write_ly(word address, byte value) noexcept {
+  m_registers.write_ly(address, value);
+}
+
+byte Ppu::read_lyc(word /* address */) const noexcept {
+  return m_registers.lyc;
+}
+
+void Ppu::write_lyc(word /* address */, byte value) {
+  catch_up();
+  m_registers.lyc = value;
+  if (m_enabled) {
+    update_stat();
+  }
+  update_horizon();
+}
+
+byte Ppu::read_hdma5(word address) {
+  catch_up();
+  return m_dma->read_hdma(address);
+}
+
+void Ppu::write_hdma5(word address, byte value) {
+  catch_up();
+  m_dma->write_hdma(address, value);
+  update_horizon();
+  // The CPU is halted by a general purpose transfer from the next
+  // instruction on
+  if (m_cpu != nullptr) {
+    m_cpu->limit(cycles{0});
+  }
+}
+
+byte Ppu::read_oam_dma(word address) const noexcept {
+  return m_dma->read_oam_dma(address);
+}
+
+void Ppu::write_oam_dma(word address, byte value) {
+  catch_up();
+  m_dma->write_oam_dma(address, value);
+  // The DMA only unlocks the bus when advanced, so the run ends with it
+  if (m_cpu != nullptr) {
+    m_cpu->limit(Dma::oam_transfer_time);
+  }
+}
+
+void Ppu::write_oam(word address, byte value) {
+  catch_up();
+  m_oam[address - oam_address] = value;
+}
+
+Ppu::Mode Ppu::mode() {
+  catch_up();
+  return m_mode;
+}
+
+LcdRegisters &Ppu::registers() {
+  catch_up();
+  // Whatever is written may move the horizon closer
+  m_horizon = cycles{0};
+  return m_registers;
+}
+
+const Ppu::Vram &Ppu::vram() const noexcept { return m_vram; }
+
+Dma::Oam &Ppu::oam() noexcept { return m_oam; }
+
+const Video::Frame &Ppu::frame() {
+  catch_up();
+  return m_frame;
+}
+
+std::uint64_t Ppu::frames() {
+  catch_up();
+  return m_frames;
+}
+
+TimingPpu::TimingPpu(PageTableMemoryBus &bus, IoRegisters &io,
+                     Interrupts &interrupts)
+    : Ppu(bus, io, interrupts, Drawing::None) {}
+} // namespace greenboy
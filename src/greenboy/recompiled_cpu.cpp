@@ -0,0 +1,85 @@
+#include "greenboy/recompiled_cpu.hpp"
+
+#include <cassert>
+
+#include "greenboy/interrupts.hpp"
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy {
+namespace {
+constexpr std::size_t rom_size = 0x8000;
+constexpr word switchable_bank = 0x4000;
+} // namespace
+
+RecompiledCPU::RecompiledCPU(std::unique_ptr<MemoryBus> memory,
+                             const recompiled::Program &program)
+    : m_memory(std::move(memory)), m_blocks(rom_size, nullptr) {
+  assert(m_memory != nullptr);
+  for (std::size_t i = 0; i < program.size; ++i) {
+    const auto &block = program.blocks[i];
+    if (block.start < rom_size) {
+      m_blocks[block.start] = &block;
+    }
+  }
+}
+
+const recompiled::Block *RecompiledCPU::block_at(word address) const {
+  if (address >= rom_size) {
+    return nullptr;
+  }
+  const auto *block = m_blocks[address];
+  if (block == nullptr || block->start < switchable_bank) {
+    return block;
+  }
+  for (word offset = 0; offset < block->length; ++offset) {
+    if (m_memory->read(static_cast<word>(address + offset)) !=
+        block->code[offset]) {
+      return nullptr;
+    }
+  }
+  return block;
+}
+
+cycles RecompiledCPU::update() { return run(cycles{1}); }
+
+cycles RecompiledCPU::run(cycles budget) {
+  PackedRegisterSet registers{m_registers};
+  LazyFlags flags{m_registers.f};
+  recompiled::Interpreter interpreter{registers, flags, *m_memory};
+  recompiled::Context context{registers, flags, *m_memory, interpreter};
+  const auto store = [&] {
+    registers.set_f(flags.get());
+    m_registers = registers.unpack();
+  };
+  auto *const interrupts = m_interrupts;
+  begin_run(budget);
+  try {
+    while (m_elapsed < m_budget) {
+      if (interrupts != nullptr) {
+        m_elapsed += interrupts->service(registers, *m_memory);
+      }
+      if (registers.halted) {
+        m_elapsed += cycles{4};
+        continue;
+      }
+      const auto *block = block_at(registers.pc);
+      m_elapsed += block != nullptr ? block->function(context)
+                                    : interpreter.step();
+    }
+  } catch (...) {
+    store();
+    end_run();
+    throw;
+  }
+  store();
+  return end_run();
+}
+
+word RecompiledCPU::pc() const noexcept { return m_registers.pc; }
+
+CPU::RegisterSet &RecompiledCPU::registers() noexcept { return m_registers; }
+
+const CPU::RegisterSet &RecompiledCPU::registers() const noexcept {
+  return m_registers;
+}
+} // namespace greenboy
@@ -0,0 +1,418 @@
+#include "greenboy/recompiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+
+#include "greenboy/interpreter.hpp"
+
+namespace greenboy {
+namespace {
+using interpreter::ends_block;
+using interpreter::instruction_length;
+
+constexpr std::size_t mapped_rom_size = 0x8000;
+constexpr word switchable_bank = 0x4000;
+
+std::string hex(unsigned value, int digits) {
+  std::ostringstream out;
+  out << "0x" << std::hex << std::setfill('0') << std::setw(digits) << value;
+  return out.str();
+}
+
+std::string byte_literal(byte value) {
+  return "byte{" + hex(to_integer<unsigned>(value), 2) + "}";
+}
+
+std::string word_literal(word value) { return "word{" + hex(value, 4) + "}"; }
+
+std::string block_name(word start) {
+  return "block_" + hex(start, 4).substr(2);
+}
+
+std::string code_name(word start) { return "code_" + hex(start, 4).substr(2); }
+
+std::string read_operand(unsigned index) {
+  constexpr std::array<const char *, 8> operands{
+      "r.b()", "r.c()", "r.d()", "r.e()",
+      "r.h()", "r.l()", "m.read(r.hl())", "r.a()"};
+  return operands[index];
+}
+
+std::string write_operand(unsigned index, const std::string &value) {
+  constexpr std::array<const char *, 8> setters{"r.set_b(", "r.set_c(",
+                                                "r.set_d(", "r.set_e(",
+                                                "r.set_h(", "r.set_l(",
+                                                "m.write(r.hl(), ", "r.set_a("};
+  return setters[index] + value + ");";
+}
+
+std::string apply(const std::string &operation, const std::string &lhs,
+                  const std::string &rhs) {
+  return "apply<operations::" + operation + ">(f, " + lhs + ", " + rhs + ")";
+}
+
+struct Translation {
+  std::string statement;
+  unsigned time;
+};
+
+// The C++ for an instruction which neither reads pc nor transfers control.
+// Everything else is left to the interpreter. The timings are the ones of
+// interpreter::Interpreter.
+std::optional<Translation>
+translate(const Recompiler::Instruction &instruction) {
+  constexpr std::array<const char *, 8> alu{
+      "add",         "add_with_carry", "subtract",   "subtract_with_carry",
+      "bitwise_and", "bitwise_xor",    "bitwise_or", "compare"};
+  constexpr std::array<const char *, 8> accumulator{
+      "rotate_left_circular_accumulator",
+      "rotate_right_circular_accumulator",
+      "rotate_left_accumulator",
+      "rotate_right_accumulator",
+      "decimal_adjust",
+      "complement",
+      "set_carry",
+      "complement_carry"};
+  constexpr std::array<const char *, 4> pairs{"r.bc()", "r.de()", "r.hl()",
+                                              "r.sp"};
+  constexpr std::array<const char *, 4> indirect{"r.bc()", "r.de()",
+                                                 "r.hl()++", "r.hl()--"};
+
+  const auto opcode = to_integer<unsigned>(instruction.opcode);
+  const auto x = opcode >> 6u;
+  const auto y = (opcode >> 3u) & 7u;
+  const auto z = opcode & 7u;
+  const auto p = y >> 1u;
+  const auto q = y & 1u;
+  const auto n = instruction.operands[0];
+  const auto nn = to_word(instruction.operands[1], instruction.operands[0]);
+
+  if (opcode == 0x00) {
+    return Translation{"", 4};
+  }
+  if (x == 1 && opcode != 0x76) {
+    return Translation{write_operand(y, read_operand(z)),
+                       y == 6 || z == 6 ? 8u : 4u};
+  }
+  if (x == 2) {
+    return Translation{
+        "r.set_a(" + apply(alu[y], "r.a()", read_operand(z)) + ");",
+        z == 6 ? 8u : 4u};
+  }
+  if (x == 3 && z == 6) {
+    return Translation{
+        "r.set_a(" + apply(alu[y], "r.a()", byte_literal(n)) + ");", 8};
+  }
+  if (x == 0) {
+    switch (z) {
+    case 1:
+      if (q == 0) {
+        return Translation{std::string{pairs[p]} + " = " + word_literal(nn) +
+                               ";",
+                           12};
+      }
+      break;
+    case 2:
+      if (q == 0) {
+        return Translation{
+            "m.write(" + std::string{indirect[p]} + ", r.a());", 8};
+      }
+      return Translation{"r.set_a(m.read(" + std::string{indirect[p]} + "));",
+                         8};
+    case 3:
+      return Translation{(q == 0 ? "++" : "--") + std::string{pairs[p]} + ";",
+                         8};
+    case 4:
+      return Translation{
+          write_operand(y, apply("increment", read_operand(y), "byte{1}")),
+          y == 6 ? 12u : 4u};
+    case 5:
+      return Translation{
+          write_operand(y, apply("decrement", read_operand(y), "byte{1}")),
+          y == 6 ? 12u : 4u};
+    case 6:
+      return Translation{write_operand(y, byte_literal(n)), y == 6 ? 12u : 8u};
+    case 7:
+      return Translation{
+          "r.set_a(" + apply(accumulator[y], "r.a()", "byte{}") + ");", 4};
+    default:
+      break;
+    }
+    return std::nullopt;
+  }
+
+  const auto high_page = word_literal(to_word(byte{0xff}, n));
+  switch (opcode) {
+  case 0xe0:
+    return Translation{"m.write(" + high_page + ", r.a());", 12};
+  case 0xf0:
+    return Translation{"r.set_a(m.read(" + high_page + "));", 12};
+  case 0xe2:
+    return Translation{"m.write(to_word(byte{0xff}, r.c()), r.a());", 8};
+  case 0xf2:
+    return Translation{"r.set_a(m.read(to_word(byte{0xff}, r.c())));", 8};
+  case 0xea:
+    return Translation{"m.write(" + word_literal(nn) + ", r.a());", 16};
+  case 0xfa:
+    return Translation{"r.set_a(m.read(" + word_literal(nn) + "));", 16};
+  case 0xf3:
+    return Translation{"r.interrupts_enabled = false;", 4};
+  case 0xfb:
+    return Translation{
+        "r.interrupts_enabled = true; r.interrupts_delayed = true;", 4};
+  case 0xf9:
+    return Translation{"r.sp = r.hl();", 8};
+  default:
+    return std::nullopt;
+  }
+}
+
+// Where execution may continue after the last instruction of a block
+std::vector<word> successors(const Recompiler::Instruction &instruction) {
+  const auto opcode = to_integer<unsigned>(instruction.opcode);
+  const auto next = static_cast<word>(instruction.address +
+                                      instruction_length(instruction.opcode));
+  const auto absolute =
+      to_word(instruction.operands[1], instruction.operands[0]);
+  const auto relative = static_cast<word>(
+      next + static_cast<std::int8_t>(instruction.operands[0]));
+  switch (opcode) {
+  case 0x18:
+    return {relative};
+  case 0x20:
+  case 0x28:
+  case 0x30:
+  case 0x38:
+    return {next, relative};
+  case 0xc3:
+    return {absolute};
+  case 0xc2:
+  case 0xc4:
+  case 0xca:
+  case 0xcc:
+  case 0xcd:
+  case 0xd2:
+  case 0xd4:
+  case 0xda:
+  case 0xdc:
+    return {next, absolute};
+  case 0xc7:
+  case 0xcf:
+  case 0xd7:
+  case 0xdf:
+  case 0xe7:
+  case 0xef:
+  case 0xf7:
+  case 0xff:
+    return {next, static_cast<word>(opcode & 0x38u)};
+  case 0x10:
+  case 0x76:
+  case 0xc0:
+  case 0xc8:
+  case 0xd0:
+  case 0xd8:
+    return {next};
+  default:
+    return {};
+  }
+}
+
+void emit_block(std::ostream &out, const Recompiler::Block &block) {
+  std::ostringstream body;
+  unsigned time = 0;
+  auto pc = block.start;
+  auto pc_is_current = true;
+  for (const auto &instruction : block.instructions) {
+    const auto length = instruction_length(instruction.opcode);
+    body << "  // " << hex(instruction.address, 4).substr(2) << ":";
+    body << " " << hex(to_integer<unsigned>(instruction.opcode), 2).substr(2);
+    for (auto i = 1u; i < length; ++i) {
+      body << " "
+           << hex(to_integer<unsigned>(instruction.operands[i - 1]), 2)
+                  .substr(2);
+    }
+    body << "\n";
+    const auto next = static_cast<word>(instruction.address + length);
+    if (const auto translation = translate(instruction)) {
+      if (!translation->statement.empty()) {
+        body << "  " << translation->statement << "\n";
+      }
+      time += translation->time;
+      pc = next;
+      pc_is_current = false;
+      continue;
+    }
+    if (!pc_is_current) {
+      body << "  r.pc = " << word_literal(instruction.address) << ";\n";
+    }
+    if (length == 1) {
+      body << "  time += context.interpreter.execute("
+           << byte_literal(instruction.opcode) << ", nullptr);\n";
+    } else {
+      body << "  {\n    static constexpr byte operands[] = {"
+           << byte_literal(instruction.operands[0]) << ", "
+           << byte_literal(instruction.operands[1]) << "};\n"
+           << "    time += context.interpreter.execute("
+           << byte_literal(instruction.opcode) << ", operands);\n  }\n";
+    }
+    pc = next;
+    pc_is_current = true;
+  }
+  if (!pc_is_current) {
+    body << "  r.pc = " << word_literal(pc) << ";\n";
+  }
+
+  out << "cycles " << block_name(block.start)
+      << "(recompiled::Context &context) {\n"
+      << "  [[maybe_unused]] auto &r = context.registers;\n"
+      << "  [[maybe_unused]] auto &f = context.flags;\n"
+      << "  [[maybe_unused]] auto &m = context.memory;\n"
+      << "  cycles time{" << time << "};\n"
+      << body.str() << "  return time;\n}\n\n";
+}
+
+void emit_code(std::ostream &out, const Recompiler::Block &block) {
+  out << "constexpr byte " << code_name(block.start) << "[] = {";
+  auto count = 0u;
+  for (const auto &instruction : block.instructions) {
+    const auto length = instruction_length(instruction.opcode);
+    for (auto i = 0u; i < length; ++i) {
+      const auto value =
+          i == 0 ? instruction.opcode : instruction.operands[i - 1];
+      out << (count % 8 == 0 ? "\n    " : " ") << byte_literal(value) << ",";
+      ++count;
+    }
+  }
+  out << "};\n\n";
+}
+} // namespace
+
+word Recompiler::Block::length() const noexcept {
+  if (instructions.empty()) {
+    return 0;
+  }
+  const auto &last = instructions.back();
+  return static_cast<word>(last.address + instruction_length(last.opcode) -
+                           start);
+}
+
+const std::vector<word> &Recompiler::default_entry_points() {
+  static const std::vector<word> entry_points{
+      0x0100, 0x0000, 0x0008, 0x0010, 0x0018, 0x0020, 0x0028,
+      0x0030, 0x0038, 0x0040, 0x0048, 0x0050, 0x0058, 0x0060};
+  return entry_points;
+}
+
+Recompiler::Recompiler(std::vector<byte> rom) : m_rom(std::move(rom)) {
+  if (m_rom.size() > mapped_rom_size) {
+    m_rom.resize(mapped_rom_size);
+  }
+}
+
+// Blocks in the fixed bank end where it does, so that none of them runs
+// code of whichever bank is mapped after it unchecked
+Recompiler::Block Recompiler::decode(word start) const {
+  Block block{start, {}};
+  const auto end = start < switchable_bank
+                       ? std::min<std::size_t>(switchable_bank, m_rom.size())
+                       : m_rom.size();
+  std::size_t address = start;
+  while (address < end) {
+    const auto opcode = m_rom[address];
+    const auto length = instruction_length(opcode);
+    if (address + length > end) {
+      break;
+    }
+    Instruction instruction{static_cast<word>(address), opcode, {}};
+    for (auto i = 1u; i < length; ++i) {
+      instruction.operands[i - 1] = m_rom[address + i];
+    }
+    block.instructions.push_back(instruction);
+    if (ends_block(opcode)) {
+      break;
+    }
+    address += length;
+  }
+  return block;
+}
+
+void Recompiler::discover(word entry_point) {
+  std::vector<word> pending{entry_point};
+  while (!pending.empty()) {
+    const auto start = pending.back();
+    pending.pop_back();
+    if (start >= m_rom.size() || m_blocks.count(start) != 0) {
+      continue;
+    }
+    auto block = decode(start);
+    if (block.instructions.empty()) {
+      continue;
+    }
+    const auto &last = block.instructions.back();
+    if (ends_block(last.opcode)) {
+      const auto next = successors(last);
+      pending.insert(pending.end(), next.begin(), next.end());
+    } else {
+      // Cut short at the end of a bank, the code goes on in the next block
+      pending.push_back(static_cast<word>(start + block.length()));
+    }
+    m_blocks.emplace(start, std::move(block));
+  }
+}
+
+const std::map<word, Recompiler::Block> &Recompiler::blocks() const noexcept {
+  return m_blocks;
+}
+
+void Recompiler::emit(std::ostream &out, const std::string &name) const {
+  const auto separator = name.rfind("::");
+  const auto scope =
+      separator == std::string::npos ? "" : name.substr(0, separator);
+  const auto function =
+      separator == std::string::npos ? name : name.substr(separator + 2);
+
+  out << "// Generated by greenboy-recompile, do not edit\n"
+      << "#include \"greenboy/memory_bus.hpp\"\n"
+      << "#include \"greenboy/recompiled_cpu.hpp\"\n\n"
+      << "namespace {\n"
+      << "using namespace greenboy;\n"
+      << "using interpreter::apply;\n"
+      << "namespace operations = instructions::operations;\n\n";
+  for (const auto &[start, block] : m_blocks) {
+    emit_block(out, block);
+  }
+  for (const auto &[start, block] : m_blocks) {
+    if (start >= switchable_bank) {
+      emit_code(out, block);
+    }
+  }
+  if (!m_blocks.empty()) {
+    out << "constexpr recompiled::Block blocks[] = {\n";
+    for (const auto &[start, block] : m_blocks) {
+      out << "    {" << word_literal(start) << ", " << block_name(start) << ", "
+          << (start >= switchable_bank ? code_name(start) : "nullptr") << ", "
+          << word_literal(block.length()) << "},\n";
+    }
+    out << "};\n";
+  }
+  out << "} // namespace\n\n";
+
+  if (!scope.empty()) {
+    out << "namespace " << scope << " {\n";
+  }
+  out << "const greenboy::recompiled::Program &" << function
+      << "() noexcept {\n"
+      << "  static constexpr greenboy::recompiled::Program program{";
+  if (m_blocks.empty()) {
+    out << "nullptr, 0";
+  } else {
+    out << "blocks, sizeof(blocks) / sizeof(blocks[0])";
+  }
+  out << "};\n  return program;\n}\n";
+  if (!scope.empty()) {
+    out << "} // namespace " << scope << "\n";
+  }
+}
+} // namespace greenboy
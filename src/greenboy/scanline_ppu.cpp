@@ -0,0 +1,90 @@
+#include "greenboy/scanline_ppu.hpp"
+
+#include <algorithm>
+
+#include "greenboy/tile_cache.hpp"
+
+namespace greenboy {
+namespace {
+using Colours = std::array<std::uint8_t, Video::screen_width>;
+
+constexpr std::size_t map_width = 32;
+
+bool set(byte value, byte mask) noexcept { return (value & mask) != byte{0}; }
+} // namespace
+
+ScanlinePpu::ScanlinePpu(PageTableMemoryBus &bus, IoRegisters &io,
+                         Interrupts &interrupts)
+    : Ppu(bus, io, interrupts, Drawing::PerMode) {}
+
+void ScanlinePpu::end_transfer() {
+  const auto &registers = this->lcd();
+  const auto &vram = this->vram();
+  auto &tiles = this->tiles();
+  const auto line = to_integer<unsigned>(registers.ly);
+  const auto lcdc = registers.lcdc;
+  auto *const shades = line_pixels();
+
+  // Fills colours from pixel start on with row y of a tile map, starting at
+  // pixel x of the row
+  const auto draw_map_row = [&](std::size_t map, unsigned y, unsigned x,
+                                std::size_t start, Colours &colours) {
+    const auto row = map + (y / 8u) * map_width;
+    for (auto pixel = start; pixel < colours.size();) {
+      const auto *decoded =
+          tiles.row(tile_row(vram[row + (x / 8u) % map_width], y % 8u));
+      const auto count =
+          std::min<std::size_t>(8u - x % 8u, colours.size() - pixel);
+      std::copy_n(decoded + x % 8u, count, colours.begin() + pixel);
+      pixel += count;
+      x += static_cast<unsigned>(count);
+    }
+  };
+
+  Colours colours{};
+  if (set(lcdc, LcdRegisters::background_enable)) {
+    const std::size_t map =
+        set(lcdc, LcdRegisters::background_map) ? 0x1c00 : 0x1800;
+    draw_map_row(map, (to_integer<unsigned>(registers.scy) + line) & 0xffu,
+                 to_integer<unsigned>(registers.scx), 0, colours);
+
+    const auto wx = to_integer<unsigned>(registers.wx);
+    const auto wy = to_integer<unsigned>(registers.wy);
+    if (set(lcdc, LcdRegisters::window_enable) && wy <= line &&
+        wx < screen_width + 7) {
+      const std::size_t window =
+          set(lcdc, LcdRegisters::window_map) ? 0x1c00 : 0x1800;
+      draw_map_row(window, next_window_line(), wx < 7 ? 7 - wx : 0,
+                   wx < 7 ? 0 : wx - 7, colours);
+    }
+    for (std::size_t x = 0; x < screen_width; ++x) {
+      shades[x] = shade(registers.bgp, colours[x]);
+    }
+  } else {
+    std::fill_n(shades, screen_width, byte{0});
+  }
+
+  if (!set(lcdc, LcdRegisters::sprites_enable)) {
+    return;
+  }
+  const auto sprites = line_sprites();
+  std::array<bool, screen_width> covered{};
+  for (std::size_t i = 0; i < sprites.count; ++i) {
+    const auto &sprite = sprites.rows[i];
+    for (unsigned pixel = 0; pixel < 8u; ++pixel) {
+      const auto x = sprite.x + pixel;
+      if (x < 8 || x >= screen_width + 8 || covered[x - 8]) {
+        continue;
+      }
+      const auto sprite_colour = sprite.colours[pixel];
+      if (sprite_colour == 0) {
+        continue;
+      }
+      covered[x - 8] = true;
+      if (!sprite.behind_background() || colours[x - 8] == 0) {
+        shades[x - 8] = shade(sprite.palette(registers), sprite_colour);
+      }
+    }
+  }
+}
+} // namespace greenboy
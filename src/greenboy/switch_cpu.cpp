@@ -0,0 +1,75 @@
+#include "greenboy/switch_cpu.hpp"
+
+#include <cassert>
+
+#include "greenboy/interpreter.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/lazy_flags.hpp"
+#include "greenboy/memory_bus.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+
+namespace greenboy {
+using interpreter::Interpreter;
+using interpreter::materialize;
+
+SwitchCPU::SwitchCPU(std::unique_ptr<MemoryBus> memory,
+                     FlagEvaluation flag_evaluation) noexcept
+    : m_memory(std::move(memory)),
+      m_page_table(dynamic_cast<PageTableMemoryBus *>(m_memory.get())),
+      m_flag_evaluation(flag_evaluation) {
+  assert(m_memory != nullptr);
+}
+
+cycles SwitchCPU::update() { return run(cycles{1}); }
+
+cycles SwitchCPU::run(cycles budget) {
+  if (m_flag_evaluation == FlagEvaluation::Lazy) {
+    return run<LazyFlags>(budget);
+  }
+  return run<CPU::Flags>(budget);
+}
+
+template <class Flags> cycles SwitchCPU::run(cycles budget) {
+  if (m_page_table != nullptr) {
+    return run<Flags>(*m_page_table, budget);
+  }
+  return run<Flags>(*m_memory, budget);
+}
+
+template <class Flags, class Memory>
+cycles SwitchCPU::run(Memory &memory, cycles budget) {
+  // Working on a local copy lets the compiler keep the registers out of
+  // memory for the duration of the loop
+  PackedRegisterSet registers{m_registers};
+  Flags flags{m_registers.f};
+  Interpreter<Memory, Flags> interpreter{registers, flags, memory};
+  const auto store = [&] {
+    registers.set_f(materialize(flags));
+    m_registers = registers.unpack();
+  };
+  auto *const interrupts = m_interrupts;
+  begin_run(budget);
+  try {
+    while (m_elapsed < m_budget) {
+      if (interrupts != nullptr) {
+        m_elapsed += interrupts->service(registers, memory);
+      }
+      m_elapsed += interpreter.step();
+    }
+  } catch (...) {
+    store();
+    end_run();
+    throw;
+  }
+  store();
+  return end_run();
+}
+
+word SwitchCPU::pc() const noexcept { return m_registers.pc; }
+
+CPU::RegisterSet &SwitchCPU::registers() noexcept { return m_registers; }
+
+const CPU::RegisterSet &SwitchCPU::registers() const noexcept {
+  return m_registers;
+}
+} // namespace greenboy
@@ -0,0 +1,430 @@
+#include "greenboy/table_opcode_translator.hpp"
+
+#include "greenboy/data_access/byte_register.hpp"
+#include "greenboy/data_access/constant_byte.hpp"
+#include "greenboy/data_access/decrementing_word.hpp"
+#include "greenboy/data_access/delayed_word_access.hpp"
+#include "greenboy/data_access/double_byte_word.hpp"
+#include "greenboy/data_access/immediate_byte.hpp"
+#include "greenboy/data_access/immediate_word.hpp"
+#include "greenboy/data_access/incrementing_word.hpp"
+#include "greenboy/data_access/indirect_byte.hpp"
+#include "greenboy/data_access/indirect_word.hpp"
+#include "greenboy/data_access/offsat_word.hpp"
+#include "greenboy/data_access/pre_decrementing_word.hpp"
+#include "greenboy/data_access/pre_incrementing_word.hpp"
+#include "greenboy/data_access/relative_address.hpp"
+#include "greenboy/data_access/stack_word.hpp"
+#include "greenboy/data_access/word_register.hpp"
+#include "greenboy/instructions/bit_test.hpp"
+#include "greenboy/instructions/byte_arithmetic_operation.hpp"
+#include "greenboy/instructions/byte_load.hpp"
+#include "greenboy/instructions/call.hpp"
+#include "greenboy/instructions/control.hpp"
+#include "greenboy/instructions/jump.hpp"
+#include "greenboy/instructions/return.hpp"
+#include "greenboy/instructions/word_arithmetic_operation.hpp"
+#include "greenboy/instructions/word_load.hpp"
+#include "greenboy/memory_bus.hpp"
+
+namespace greenboy {
+namespace {
+using namespace data_access;
+using namespace instructions;
+
+class PrefixedInstruction final : public Instruction {
+  const TableOpcodeTranslator::Table &m_table;
+
+public:
+  explicit PrefixedInstruction(
+      const TableOpcodeTranslator::Table &table) noexcept
+      : m_table(table) {}
+
+  cycles execute(CPU::RegisterSet &registers,
+                 MemoryBus &memory) const override {
+    const auto opcode = memory.read(registers.pc++);
+    return cycles{4} +
+           m_table[to_integer<std::size_t>(opcode)]->execute(registers,
+                                                              memory);
+  }
+};
+
+std::shared_ptr<ByteAccess> byte_operand(unsigned index) {
+  switch (index) {
+  case 0:
+    return ByteRegister::b();
+  case 1:
+    return ByteRegister::c();
+  case 2:
+    return ByteRegister::d();
+  case 3:
+    return ByteRegister::e();
+  case 4:
+    return ByteRegister::h();
+  case 5:
+    return ByteRegister::l();
+  case 6:
+    return IndirectByte::from(WordRegister::hl());
+  default:
+    return ByteRegister::a();
+  }
+}
+
+// Read-modify-write accesses to (HL) take an extra memory cycle
+std::shared_ptr<ByteAccess> modified_byte_operand(unsigned index) {
+  if (index == 6) {
+    return IndirectByte::from(DelayedWordAccess::from(WordRegister::hl()));
+  }
+  return byte_operand(index);
+}
+
+std::shared_ptr<WordRegister> word_operand(unsigned index) {
+  switch (index) {
+  case 0:
+    return WordRegister::bc();
+  case 1:
+    return WordRegister::de();
+  case 2:
+    return WordRegister::hl();
+  default:
+    return WordRegister::sp();
+  }
+}
+
+std::shared_ptr<WordRegister> stack_operand(unsigned index) {
+  return index == 3 ? WordRegister::af() : word_operand(index);
+}
+
+Condition condition(unsigned index) {
+  switch (index) {
+  case 0:
+    return Condition::NotZero;
+  case 1:
+    return Condition::Zero;
+  case 2:
+    return Condition::NotCarry;
+  default:
+    return Condition::Carry;
+  }
+}
+
+std::shared_ptr<WordAccess> immediate_word() {
+  return ImmediateWord::instance();
+}
+
+std::shared_ptr<ByteAccess> high_page(std::shared_ptr<ByteAccess> low) {
+  return IndirectByte::from(
+      DoubleByteWord::from(ConstantByte::from(byte{0xff}), std::move(low)));
+}
+
+std::unique_ptr<const Instruction> push(std::shared_ptr<WordAccess> source) {
+  return std::make_unique<WordLoad>(
+      DelayedWordAccess::from(StackWord::instance()), std::move(source));
+}
+
+std::unique_ptr<const Instruction> pop(std::shared_ptr<WordAccess> dest) {
+  return std::make_unique<WordLoad>(std::move(dest), StackWord::instance());
+}
+
+std::unique_ptr<const Instruction> restart(unsigned vector) {
+  return std::make_unique<Call>(
+      DoubleByteWord::from(ConstantByte::from(byte{0x00}),
+                           ConstantByte::from(static_cast<byte>(vector))),
+      Condition::Always);
+}
+
+template <ByteOperation Operation>
+std::unique_ptr<const Instruction>
+byte_operation(std::shared_ptr<ByteAccess> lhs,
+               std::shared_ptr<ByteAccess> rhs) {
+  return std::make_unique<StaticByteArithmeticOperation<Operation>>(
+      std::move(lhs), std::move(rhs));
+}
+
+using ByteOperationFactory = std::unique_ptr<const Instruction> (*)(
+    std::shared_ptr<ByteAccess>, std::shared_ptr<ByteAccess>);
+
+std::unique_ptr<const Instruction>
+alu_operation(unsigned index, std::shared_ptr<ByteAccess> rhs) {
+  constexpr std::array<ByteOperationFactory, 8> alu{
+      byte_operation<operations::add>,
+      byte_operation<operations::add_with_carry>,
+      byte_operation<operations::subtract>,
+      byte_operation<operations::subtract_with_carry>,
+      byte_operation<operations::bitwise_and>,
+      byte_operation<operations::bitwise_xor>,
+      byte_operation<operations::bitwise_or>,
+      byte_operation<operations::compare>};
+  return alu.at(index)(ByteRegister::a(), std::move(rhs));
+}
+
+std::unique_ptr<const Instruction> shift_operation(unsigned index,
+                                                   unsigned operand) {
+  constexpr std::array<ByteOperationFactory, 8> shifts{
+      byte_operation<operations::rotate_left_circular>,
+      byte_operation<operations::rotate_right_circular>,
+      byte_operation<operations::rotate_left>,
+      byte_operation<operations::rotate_right>,
+      byte_operation<operations::shift_left_arithmetic>,
+      byte_operation<operations::shift_right_arithmetic>,
+      byte_operation<operations::swap>,
+      byte_operation<operations::shift_right_logical>};
+  return shifts.at(index)(modified_byte_operand(operand),
+                          ConstantByte::from(byte{0}));
+}
+
+template <ByteOperation Operation>
+std::unique_ptr<const Instruction> unary_operation(unsigned operand) {
+  return byte_operation<Operation>(modified_byte_operand(operand),
+                                   ConstantByte::from(byte{1}));
+}
+
+template <ByteOperation Operation>
+std::unique_ptr<const Instruction> accumulator_operation() {
+  return byte_operation<Operation>(ByteRegister::a(),
+                                   ConstantByte::from(byte{0}));
+}
+
+std::unique_ptr<const Instruction>
+decode(unsigned opcode, const TableOpcodeTranslator::Table &prefixed) {
+  const auto x = opcode >> 6u;
+  const auto y = (opcode >> 3u) & 7u;
+  const auto z = opcode & 7u;
+  const auto p = y >> 1u;
+  const auto q = y & 1u;
+
+  if (x == 1) {
+    if (opcode == 0x76) {
+      return std::make_unique<Halt>();
+    }
+    return std::make_unique<ByteLoad>(byte_operand(y), byte_operand(z));
+  }
+  if (x == 2) {
+    return alu_operation(y, byte_operand(z));
+  }
+
+  switch (opcode) {
+  case 0x00:
+    return std::make_unique<Nop>();
+  case 0x08:
+    return std::make_unique<WordLoad>(IndirectWord::from(immediate_word()),
+                                      WordRegister::sp());
+  case 0x10:
+    return std::make_unique<Stop>();
+  case 0x18:
+    return std::make_unique<Jump>(RelativeAddress::instance(),
+                                  Condition::Always);
+  case 0x20:
+  case 0x28:
+  case 0x30:
+  case 0x38:
+    return std::make_unique<Jump>(RelativeAddress::instance(),
+                                  condition(y - 4));
+  case 0x02:
+    return std::make_unique<ByteLoad>(IndirectByte::from(WordRegister::bc()),
+                                      ByteRegister::a());
+  case 0x12:
+    return std::make_unique<ByteLoad>(IndirectByte::from(WordRegister::de()),
+                                      ByteRegister::a());
+  case 0x22:
+    return std::make_unique<ByteLoad>(
+        IndirectByte::from(IncrementingWord::from(WordRegister::hl())),
+        ByteRegister::a());
+  case 0x32:
+    return std::make_unique<ByteLoad>(
+        IndirectByte::from(DecrementingWord::from(WordRegister::hl())),
+        ByteRegister::a());
+  case 0x0a:
+    return std::make_unique<ByteLoad>(ByteRegister::a(),
+                                      IndirectByte::from(WordRegister::bc()));
+  case 0x1a:
+    return std::make_unique<ByteLoad>(ByteRegister::a(),
+                                      IndirectByte::from(WordRegister::de()));
+  case 0x2a:
+    return std::make_unique<ByteLoad>(
+        ByteRegister::a(),
+        IndirectByte::from(IncrementingWord::from(WordRegister::hl())));
+  case 0x3a:
+    return std::make_unique<ByteLoad>(
+        ByteRegister::a(),
+        IndirectByte::from(DecrementingWord::from(WordRegister::hl())));
+  case 0x07:
+    return accumulator_operation<
+        operations::rotate_left_circular_accumulator>();
+  case 0x0f:
+    return accumulator_operation<
+        operations::rotate_right_circular_accumulator>();
+  case 0x17:
+    return accumulator_operation<operations::rotate_left_accumulator>();
+  case 0x1f:
+    return accumulator_operation<operations::rotate_right_accumulator>();
+  case 0x27:
+    return accumulator_operation<operations::decimal_adjust>();
+  case 0x2f:
+    return accumulator_operation<operations::complement>();
+  case 0x37:
+    return accumulator_operation<operations::set_carry>();
+  case 0x3f:
+    return accumulator_operation<operations::complement_carry>();
+  case 0xc3:
+    return std::make_unique<Jump>(immediate_word(), Condition::Always);
+  case 0xc9:
+    return std::make_unique<Return>(Condition::Always, false);
+  case 0xcb:
+    return std::make_unique<PrefixedInstruction>(prefixed);
+  case 0xcd:
+    return std::make_unique<Call>(immediate_word(), Condition::Always);
+  case 0xd9:
+    return std::make_unique<Return>(Condition::Always, true);
+  case 0xe0:
+    return std::make_unique<ByteLoad>(high_page(ImmediateByte::instance()),
+                                      ByteRegister::a());
+  case 0xf0:
+    return std::make_unique<ByteLoad>(ByteRegister::a(),
+                                      high_page(ImmediateByte::instance()));
+  case 0xe2:
+    return std::make_unique<ByteLoad>(high_page(ByteRegister::c()),
+                                      ByteRegister::a());
+  case 0xf2:
+    return std::make_unique<ByteLoad>(ByteRegister::a(),
+                                      high_page(ByteRegister::c()));
+  case 0xe8:
+    return std::make_unique<WordLoad>(
+        DelayedWordAccess::from(DelayedWordAccess::from(WordRegister::sp())),
+        OffsatWord::from(WordRegister::sp(), ImmediateByte::instance()));
+  case 0xe9:
+    return std::make_unique<WordLoad>(WordRegister::pc(), WordRegister::hl());
+  case 0xea:
+    return std::make_unique<ByteLoad>(IndirectByte::from(immediate_word()),
+                                      ByteRegister::a());
+  case 0xfa:
+    return std::make_unique<ByteLoad>(ByteRegister::a(),
+                                      IndirectByte::from(immediate_word()));
+  case 0xf3:
+    return std::make_unique<InterruptMasterEnable>(false);
+  case 0xfb:
+    return std::make_unique<InterruptMasterEnable>(true);
+  case 0xf8:
+    return std::make_unique<WordLoad>(
+        WordRegister::hl(),
+        OffsatWord::from(DelayedWordAccess::from(WordRegister::sp()),
+                         ImmediateByte::instance()));
+  case 0xf9:
+    return std::make_unique<WordLoad>(
+        DelayedWordAccess::from(WordRegister::sp()), WordRegister::hl());
+  default:
+    break;
+  }
+
+  if (x == 0) {
+    switch (z) {
+    case 1:
+      if (q == 0) {
+        return std::make_unique<WordLoad>(word_operand(p), immediate_word());
+      }
+      return std::make_unique<WordArithmeticOperation>(
+          DelayedWordAccess::from(WordRegister::hl()), word_operand(p),
+          operations::add_words);
+    case 3:
+      if (q == 0) {
+        return std::make_unique<WordLoad>(
+            DelayedWordAccess::from(word_operand(p)),
+            PreIncrementingWord::from(word_operand(p)));
+      }
+      return std::make_unique<WordLoad>(
+          DelayedWordAccess::from(word_operand(p)),
+          PreDecrementingWord::from(word_operand(p)));
+    case 4:
+      return unary_operation<operations::increment>(y);
+    case 5:
+      return unary_operation<operations::decrement>(y);
+    case 6:
+      return std::make_unique<ByteLoad>(byte_operand(y),
+                                        ImmediateByte::instance());
+    default:
+      break;
+    }
+  } else {
+    switch (z) {
+    case 0:
+      return std::make_unique<Return>(condition(y), false);
+    case 1:
+      return pop(stack_operand(p));
+    case 2:
+      return std::make_unique<Jump>(immediate_word(), condition(y));
+    case 4:
+      if (y < 4) {
+        return std::make_unique<Call>(immediate_word(), condition(y));
+      }
+      break;
+    case 5:
+      if (q == 0) {
+        return push(stack_operand(p));
+      }
+      break;
+    case 6:
+      return alu_operation(y, ImmediateByte::instance());
+    case 7:
+      return restart(y * 8);
+    default:
+      break;
+    }
+  }
+
+  return std::make_unique<IllegalInstruction>();
+}
+
+std::unique_ptr<const Instruction> decode_prefixed(unsigned opcode) {
+  const auto x = opcode >> 6u;
+  const auto y = (opcode >> 3u) & 7u;
+  const auto z = opcode & 7u;
+
+  if (x == 0) {
+    return shift_operation(y, z);
+  }
+  if (x == 1) {
+    return std::make_unique<BitTest>(byte_operand(z), y);
+  }
+  const auto mask = ConstantByte::from(static_cast<byte>(1u << y));
+  if (x == 2) {
+    return byte_operation<operations::reset_bits>(modified_byte_operand(z),
+                                                  mask);
+  }
+  return byte_operation<operations::set_bits>(modified_byte_operand(z), mask);
+}
+} // namespace
+
+TableOpcodeTranslator::TableOpcodeTranslator() noexcept
+    : m_table(main_table()), m_prefixed_table(prefixed_table()) {}
+
+const Instruction &TableOpcodeTranslator::translate(byte opcode) {
+  return *m_table[to_integer<std::size_t>(opcode)];
+}
+
+const Instruction &
+TableOpcodeTranslator::translate_prefixed(byte opcode) const {
+  return *m_prefixed_table[to_integer<std::size_t>(opcode)];
+}
+
+const TableOpcodeTranslator::Table &TableOpcodeTranslator::main_table() {
+  static const auto table = [] {
+    Table instructions;
+    for (auto opcode = 0u; opcode < instructions.size(); ++opcode) {
+      instructions[opcode] = decode(opcode, prefixed_table());
+    }
+    return instructions;
+  }();
+  return table;
+}
+
+const TableOpcodeTranslator::Table &TableOpcodeTranslator::prefixed_table() {
+  static const auto table = [] {
+    Table instructions;
+    for (auto opcode = 0u; opcode < instructions.size(); ++opcode) {
+      instructions[opcode] = decode_prefixed(opcode);
+    }
+    return instructions;
+  }();
+  return table;
+}
+} // namespace greenboy
@@ -0,0 +1,68 @@
+#include "greenboy/tile_cache.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "greenboy/tile_decoder.hpp"
+
+namespace greenboy {
+namespace {
+constexpr std::size_t tile_size = 16;
+constexpr std::size_t tile_data_size = TileCache::tile_count * tile_size;
+} // namespace
+
+TileCache::TileCache(byte *vram) noexcept : m_vram(vram) {
+  assert(m_vram != nullptr);
+  m_stale.set();
+}
+
+TileCache &TileCache::install(PageTableMemoryBus &bus, byte *vram) {
+  auto cache = std::make_unique<TileCache>(vram);
+  auto &installed = *cache;
+  installed.m_index = bus.add_handler(std::move(cache));
+  installed.map(bus);
+  return installed;
+}
+
+void TileCache::map(PageTableMemoryBus &bus) const {
+  bus.map_read_only(first_address, tile_data_size, m_vram, m_index);
+}
+
+byte TileCache::read(word address) const {
+  return m_vram[address - first_address];
+}
+
+void TileCache::write(word address, byte value) {
+  const auto offset = static_cast<std::size_t>(address - first_address);
+  // Games often rewrite tiles with what they already hold
+  if (m_vram[offset] != value) {
+    m_vram[offset] = value;
+    m_stale.set(offset / tile_size);
+  }
+}
+
+void TileCache::decode(std::size_t tile) {
+  auto *colours = m_colours.data() + tile * tile_colours;
+  auto *flipped = m_flipped.data() + tile * tile_colours;
+  tiles::decode(m_vram + tile * tile_size, colours, 8);
+  for (std::size_t row = 0; row < tile_colours; row += 8) {
+    std::reverse_copy(colours + row, colours + row + 8, flipped + row);
+  }
+  m_stale.reset(tile);
+  ++m_decodes;
+}
+
+const std::uint8_t *TileCache::row(std::size_t offset, bool flipped) {
+  assert(offset < tile_data_size);
+  const auto tile = offset / tile_size;
+  if (m_stale[tile]) {
+    decode(tile);
+  }
+  const auto colours = tile * tile_colours + (offset % tile_size) / 2 * 8;
+  return (flipped ? m_flipped.data() : m_colours.data()) + colours;
+}
+
+void TileCache::invalidate() noexcept { m_stale.set(); }
+
+std::uint64_t TileCache::decodes() const noexcept { return m_decodes; }
+} // namespace greenboy
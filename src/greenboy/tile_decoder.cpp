@@ -0,0 +1,157 @@
+#include "greenboy/tile_decoder.hpp"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GREENBOY_TILE_SIMD
+#include <immintrin.h>
+#endif
+
+namespace greenboy::tiles {
+namespace {
+// Spreads the bits of a byte over the bytes of a word, bit 7 going to the
+// first byte in memory
+std::array<std::uint64_t, 256> make_spread_table() noexcept {
+  std::array<std::uint64_t, 256> table{};
+  for (unsigned value = 0; value < table.size(); ++value) {
+    std::array<std::uint8_t, 8> bits{};
+    for (unsigned pixel = 0; pixel < bits.size(); ++pixel) {
+      bits[pixel] = static_cast<std::uint8_t>(value >> (7u - pixel) & 1u);
+    }
+    std::memcpy(&table[value], bits.data(), bits.size());
+  }
+  return table;
+}
+
+const std::array<std::uint64_t, 256> spread = make_spread_table();
+
+void decode_scalar(const byte *planes, std::uint8_t *colours,
+                   std::size_t rows) {
+  for (std::size_t row = 0; row < rows; ++row) {
+    const auto low = spread[to_integer<std::size_t>(planes[row * 2])];
+    const auto high = spread[to_integer<std::size_t>(planes[row * 2 + 1])];
+    const auto decoded = low | high << 1u;
+    std::memcpy(colours + row * 8, &decoded, sizeof(decoded));
+  }
+}
+
+#ifdef GREENBOY_TILE_SIMD
+// Byte i holds the mask of pixel i
+constexpr long long pixel_masks = 0x0102040810204080;
+
+// Combines two rows, each of the low and the high plane repeated over eight
+// bytes, into their colours. A set bit compares equal to its mask, which
+// gives -1, so the colour is the negated sum.
+__m128i combine(__m128i low, __m128i high) noexcept {
+  const auto masks = _mm_set1_epi64x(pixel_masks);
+  const auto low_bits = _mm_cmpeq_epi8(_mm_and_si128(low, masks), masks);
+  const auto high_bits = _mm_cmpeq_epi8(_mm_and_si128(high, masks), masks);
+  const auto sum = _mm_add_epi8(low_bits, _mm_add_epi8(high_bits, high_bits));
+  return _mm_sub_epi8(_mm_setzero_si128(), sum);
+}
+
+// Stores two rows, given as the low plane of each repeated four times
+// followed by its high plane repeated four times
+void store_rows(__m128i *out, __m128i planes) noexcept {
+  _mm_storeu_si128(out, combine(_mm_shuffle_epi32(planes, 0xa0),
+                                _mm_shuffle_epi32(planes, 0xf5)));
+}
+
+void decode_sse2(const byte *planes, std::uint8_t *colours,
+                 std::size_t rows) {
+  std::size_t row = 0;
+  for (; row + 8 <= rows; row += 8) {
+    const auto in = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(planes + row * 2));
+    const auto first_pairs = _mm_unpacklo_epi8(in, in);
+    const auto last_pairs = _mm_unpackhi_epi8(in, in);
+
+    auto *out = reinterpret_cast<__m128i *>(colours + row * 8);
+    store_rows(out, _mm_unpacklo_epi16(first_pairs, first_pairs));
+    store_rows(out + 1, _mm_unpackhi_epi16(first_pairs, first_pairs));
+    store_rows(out + 2, _mm_unpacklo_epi16(last_pairs, last_pairs));
+    store_rows(out + 3, _mm_unpackhi_epi16(last_pairs, last_pairs));
+  }
+  decode_scalar(planes + row * 2, colours + row * 8, rows - row);
+}
+
+__attribute__((target("avx2"))) __m256i combine(__m256i planes,
+                                                __m256i low_indices) {
+  const auto masks = _mm256_set1_epi64x(pixel_masks);
+  const auto low = _mm256_shuffle_epi8(planes, low_indices);
+  const auto high = _mm256_shuffle_epi8(
+      planes, _mm256_add_epi8(low_indices, _mm256_set1_epi8(1)));
+  const auto low_bits =
+      _mm256_cmpeq_epi8(_mm256_and_si256(low, masks), masks);
+  const auto high_bits =
+      _mm256_cmpeq_epi8(_mm256_and_si256(high, masks), masks);
+  return _mm256_or_si256(
+      _mm256_and_si256(low_bits, _mm256_set1_epi8(1)),
+      _mm256_and_si256(high_bits, _mm256_set1_epi8(2)));
+}
+
+__attribute__((target("avx2"))) void
+decode_avx2(const byte *planes, std::uint8_t *colours, std::size_t rows) {
+  // Picks the low plane of four rows, each repeated eight times, from the
+  // eight rows in each lane
+  const auto first_rows = _mm256_setr_epi8(
+      0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 4, 4, 4, 4, 4, 4, 4, 4,
+      6, 6, 6, 6, 6, 6, 6, 6);
+  const auto last_rows = _mm256_add_epi8(first_rows, _mm256_set1_epi8(8));
+  std::size_t row = 0;
+  for (; row + 8 <= rows; row += 8) {
+    const auto in = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(planes + row * 2)));
+    auto *out = reinterpret_cast<__m256i *>(colours + row * 8);
+    _mm256_storeu_si256(out, combine(in, first_rows));
+    _mm256_storeu_si256(out + 1, combine(in, last_rows));
+  }
+  decode_scalar(planes + row * 2, colours + row * 8, rows - row);
+}
+#endif
+} // namespace
+
+bool supported(Kernel kernel) noexcept {
+  switch (kernel) {
+  case Kernel::Scalar:
+    return true;
+#ifdef GREENBOY_TILE_SIMD
+  case Kernel::SSE2:
+    return true;
+  case Kernel::AVX2:
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+  default:
+    return false;
+  }
+}
+
+Kernel fastest() noexcept {
+  // Without a byte shuffle, SSE2 spends more on spreading the planes than the
+  // scalar kernel does on its table lookups, so it is never picked
+  return supported(Kernel::AVX2) ? Kernel::AVX2 : Kernel::Scalar;
+}
+
+Decoder decoder(Kernel kernel) {
+  if (!supported(kernel)) {
+    throw std::runtime_error("The tile decoder is not supported on this CPU");
+  }
+  switch (kernel) {
+#ifdef GREENBOY_TILE_SIMD
+  case Kernel::SSE2:
+    return decode_sse2;
+  case Kernel::AVX2:
+    return decode_avx2;
+#endif
+  default:
+    return decode_scalar;
+  }
+}
+
+void decode(const byte *planes, std::uint8_t *colours, std::size_t rows) {
+  static const auto best = decoder(fastest());
+  best(planes, colours, rows);
+}
+} // namespace greenboy::tiles
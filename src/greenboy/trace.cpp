@@ -0,0 +1,173 @@
+#include "greenboy/trace.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace greenboy::trace {
+namespace {
+constexpr std::size_t batch_size = 4096;
+
+std::size_t round_up(std::size_t capacity) {
+  std::size_t rounded = 1;
+  while (rounded < capacity) {
+    rounded <<= 1u;
+  }
+  return rounded;
+}
+
+void put(std::array<char, record_size> &buffer, std::size_t offset,
+         std::uint64_t value, std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    buffer[offset + i] = static_cast<char>((value >> (8u * i)) & 0xffu);
+  }
+}
+
+std::uint64_t get(const std::array<char, record_size> &buffer,
+                  std::size_t offset, std::size_t size) {
+  std::uint64_t value = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    value |= static_cast<std::uint64_t>(
+                 static_cast<unsigned char>(buffer[offset + i]))
+             << (8u * i);
+  }
+  return value;
+}
+} // namespace
+
+RingBuffer::RingBuffer(std::size_t capacity)
+    : m_records(round_up(capacity)), m_mask(m_records.size() - 1) {
+  if (capacity == 0) {
+    throw std::runtime_error("A ring buffer needs room for a record");
+  }
+}
+
+std::size_t RingBuffer::pop(Record *destination, std::size_t size) noexcept {
+  const auto tail = m_tail.load(std::memory_order_relaxed);
+  const auto available = m_head.load(std::memory_order_acquire) - tail;
+  const auto count = available < size ? available : size;
+  for (std::size_t i = 0; i < count; ++i) {
+    destination[i] = m_records[(tail + i) & m_mask];
+  }
+  m_tail.store(tail + count, std::memory_order_release);
+  return count;
+}
+
+std::size_t RingBuffer::capacity() const noexcept { return m_records.size(); }
+
+std::uint64_t RingBuffer::dropped() const noexcept {
+  return m_dropped.load(std::memory_order_relaxed);
+}
+
+Writer::Writer(RingBuffer &buffer, const std::string &path)
+    : m_buffer(buffer), m_file(path, std::ios::binary), m_batch(batch_size) {
+  if (!m_file) {
+    throw std::runtime_error("Could not create the trace file " + path);
+  }
+  m_thread = std::thread{[this] { run(); }};
+}
+
+Writer::~Writer() { stop(); }
+
+void Writer::drain() {
+  std::array<char, record_size> encoded{};
+  while (const auto count = m_buffer.pop(m_batch.data(), m_batch.size())) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto &record = m_batch[i];
+      put(encoded, 0, record.cycle, 8);
+      put(encoded, 8, record.address, 2);
+      put(encoded, 10, record.pc, 2);
+      put(encoded, 12, to_integer<std::uint64_t>(record.value), 1);
+      put(encoded, 13, static_cast<std::uint64_t>(record.access), 1);
+      m_file.write(encoded.data(), encoded.size());
+    }
+    m_written += count;
+  }
+}
+
+void Writer::run() {
+  while (m_running.load(std::memory_order_acquire)) {
+    drain();
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  drain();
+  m_file.flush();
+}
+
+void Writer::stop() {
+  m_running.store(false, std::memory_order_release);
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+std::uint64_t Writer::written() const noexcept { return m_written; }
+
+Region region_of(word address) noexcept {
+  if (address < 0x4000) {
+    return Region::Rom0;
+  }
+  if (address < 0x8000) {
+    return Region::RomX;
+  }
+  if (address < 0xa000) {
+    return Region::Vram;
+  }
+  if (address < 0xc000) {
+    return Region::ExternalRam;
+  }
+  if (address < 0xe000) {
+    return Region::Wram;
+  }
+  if (address < 0xfe00) {
+    return Region::Echo;
+  }
+  if (address < 0xfea0) {
+    return Region::Oam;
+  }
+  if (address < 0xff00) {
+    return Region::Unusable;
+  }
+  if (address < 0xff80) {
+    return Region::Io;
+  }
+  if (address < 0xffff) {
+    return Region::HighRam;
+  }
+  return Region::InterruptEnable;
+}
+
+const char *name(Region region) noexcept {
+  constexpr std::array<const char *, region_count> names{
+      "ROM0", "ROMX", "VRAM",   "External RAM", "WRAM",
+      "Echo", "OAM",  "Unused", "I/O",          "HRAM",
+      "IE"};
+  return names[static_cast<std::size_t>(region)];
+}
+
+bool read(std::istream &input, Record &record) {
+  std::array<char, record_size> encoded{};
+  if (!input.read(encoded.data(), encoded.size())) {
+    return false;
+  }
+  record.cycle = get(encoded, 0, 8);
+  record.address = static_cast<word>(get(encoded, 8, 2));
+  record.pc = static_cast<word>(get(encoded, 10, 2));
+  record.value = static_cast<byte>(get(encoded, 12, 1));
+  record.access = get(encoded, 13, 1) == 0 ? Access::Read : Access::Write;
+  return true;
+}
+
+Histogram histogram(std::istream &input) {
+  Histogram counts{};
+  Record record{};
+  while (read(input, record)) {
+    auto &count = counts[static_cast<std::size_t>(region_of(record.address))];
+    if (record.access == Access::Read) {
+      ++count.reads;
+    } else {
+      ++count.writes;
+    }
+  }
+  return counts;
+}
+} // namespace greenboy::trace
@@ -0,0 +1,11 @@
+#include "greenboy/tracing_memory_bus.hpp"
+
+#include <cassert>
+
+namespace greenboy {
+TracingMemoryBus::TracingMemoryBus(std::unique_ptr<MemoryBus> memory,
+                                   trace::RingBuffer &buffer) noexcept
+    : m_memory(std::move(memory)), m_buffer(buffer) {
+  assert(m_memory != nullptr);
+}
+} // namespace greenboy
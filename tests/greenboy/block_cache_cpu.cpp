@@ -0,0 +1,162 @@
+#include "greenboy/block_cache_cpu.hpp"
+#include "fakes/differential.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include "greenboy/fetch_execute_cpu.hpp"
+#include "greenboy/table_opcode_translator.hpp"
+
+namespace {
+using namespace greenboy;
+
+void load(FakeMemoryBus &memory, word address,
+          std::initializer_list<unsigned> program) {
+  for (auto value : program) {
+    memory.write(address++, static_cast<byte>(value));
+  }
+}
+
+TEST(BlockCacheCPU, ExecutesAStraightLineBlockAtOnce) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  // LD A,0x12; LD B,A; INC B; HALT
+  load(*memory, 0x0000, {0x3e, 0x12, 0x47, 0x04, 0x76});
+  BlockCacheCPU cpu{std::move(memory)};
+
+  const auto time_passed = cpu.update();
+
+  EXPECT_EQ(time_passed, cycles{20});
+  EXPECT_EQ(cpu.registers().b, byte{0x13});
+  EXPECT_EQ(cpu.registers().pc, word{0x0005});
+  EXPECT_TRUE(cpu.registers().halted);
+  EXPECT_EQ(cpu.cached_blocks(), 1u);
+}
+
+TEST(BlockCacheCPU, InstructionsNamingIORegistersStartABlock) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  // NOP; LDH A,(0x44); LD (0xc000),A; LD A,(0xff41); HALT
+  load(*memory, 0x0000,
+       {0x00, 0xf0, 0x44, 0xea, 0x00, 0xc0, 0xfa, 0x41, 0xff, 0x76});
+  BlockCacheCPU cpu{std::move(memory)};
+
+  EXPECT_EQ(cpu.update(), cycles{4});
+  EXPECT_EQ(cpu.registers().pc, word{0x0001});
+  EXPECT_EQ(cpu.update(), cycles{28});
+  EXPECT_EQ(cpu.registers().pc, word{0x0006});
+  EXPECT_EQ(cpu.update(), cycles{20});
+  EXPECT_TRUE(cpu.registers().halted);
+}
+
+TEST(BlockCacheCPU, ReusesBlocksForLoops) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  // LD B,0x10; loop: DEC B; JR NZ,loop; HALT
+  load(*memory, 0x0000, {0x06, 0x10, 0x05, 0x20, 0xfd, 0x76});
+  BlockCacheCPU cpu{std::move(memory)};
+
+  cpu.run(cycles{1000});
+
+  EXPECT_EQ(cpu.registers().b, byte{0x00});
+  EXPECT_TRUE(cpu.registers().halted);
+  EXPECT_EQ(cpu.cached_blocks(), 3u);
+}
+
+TEST(BlockCacheCPU, WritesIntoABlockAreSeenByTheNextInstruction) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  // LD HL,0xc006; LD (HL),0x3c; NOP; NOP (becomes INC A); HALT
+  load(*memory, 0xc000, {0x21, 0x06, 0xc0, 0x36, 0x3c, 0x00, 0x00, 0x76});
+  BlockCacheCPU cpu{std::move(memory)};
+  cpu.registers().pc = 0xc000;
+
+  cpu.run(cycles{40});
+
+  EXPECT_EQ(cpu.registers().a, byte{0x01});
+  EXPECT_TRUE(cpu.registers().halted);
+}
+
+TEST(BlockCacheCPU, WritesOutsideOfTheBlocksKeepThem) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  // LD HL,0xd000; LD (HL),0x3c; HALT
+  load(*memory, 0xc000, {0x21, 0x00, 0xd0, 0x36, 0x3c, 0x76});
+  BlockCacheCPU cpu{std::move(memory)};
+  cpu.registers().pc = 0xc000;
+
+  cpu.update();
+
+  EXPECT_EQ(cpu.cached_blocks(), 1u);
+}
+
+TEST(BlockCacheCPU, ExternalWritesAreReportedThroughInvalidate) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  auto *bus = memory.get();
+  load(*memory, 0xc000, {0x00, 0x76});
+  BlockCacheCPU cpu{std::move(memory)};
+  cpu.registers().pc = 0xc000;
+  cpu.update();
+
+  bus->write(0xc000, byte{0x3c});
+  cpu.invalidate(0xc000);
+  cpu.registers().pc = 0xc000;
+  cpu.registers().halted = false;
+  cpu.update();
+
+  EXPECT_EQ(cpu.registers().a, byte{0x01});
+}
+
+TEST(BlockCacheCPU, BankSwitchesDropOnlyTheBlocksOfTheSwitchedWindows) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  // Blocks in both ROM windows, the external RAM and the work RAM
+  const std::array<word, 4> starts{0x0000, 0x4000, 0xa000, 0xc000};
+  for (auto start : starts) {
+    load(*memory, start, {0x00, 0x76});
+  }
+  BlockCacheCPU cpu{std::move(memory)};
+  const auto run_all = [&] {
+    for (auto start : starts) {
+      cpu.registers().pc = start;
+      cpu.registers().halted = false;
+      cpu.update();
+    }
+  };
+  run_all();
+  ASSERT_EQ(cpu.cached_blocks(), 4u);
+
+  // A ROM bank number only switches 0x4000-0x7fff
+  cpu.invalidate(0x2000);
+  EXPECT_EQ(cpu.cached_blocks(), 3u);
+  run_all();
+  // A RAM enable only switches 0xa000-0xbfff
+  cpu.invalidate(0x0000);
+  EXPECT_EQ(cpu.cached_blocks(), 3u);
+  run_all();
+  // The upper bank and mode registers may switch every cartridge window
+  cpu.invalidate(0x6000);
+  EXPECT_EQ(cpu.cached_blocks(), 1u);
+}
+
+TEST(BlockCacheCPU, IllegalOpcodesThrowWithTheRegistersStored) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  load(*memory, 0x0000, {0x3c, 0xd3});
+  BlockCacheCPU cpu{std::move(memory)};
+
+  EXPECT_THROW(cpu.update(), std::runtime_error);
+  EXPECT_EQ(cpu.registers().a, byte{0x01});
+  EXPECT_EQ(cpu.registers().pc, word{0x0002});
+}
+
+TEST(BlockCacheCPU, RandomProgramsMatchTheFetchExecuteCPU) {
+  std::mt19937 random{0xb10c};
+  for (auto program = 0; program < 16; ++program) {
+    auto machines = differential::random_machines<BlockCacheCPU>(
+        random,
+        [](std::unique_ptr<FakeMemoryBus> memory) {
+          return BlockCacheCPU{std::move(memory)};
+        },
+        differential::not_terminal);
+
+    differential::expect_same_run(*machines, cycles{4000});
+  }
+}
+} // namespace
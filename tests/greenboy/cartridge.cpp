@@ -0,0 +1,187 @@
+#include "greenboy/cartridge.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+using namespace greenboy;
+using namespace greenboy::cartridge;
+
+// Every bank is filled with its number, low byte first
+Rom numbered_rom(std::size_t banks, unsigned type, unsigned ram_size_code) {
+  std::vector<byte> image(banks * 0x4000);
+  for (std::size_t i = 0; i < image.size(); i += 2) {
+    const auto bank = i / 0x4000;
+    image[i] = static_cast<byte>(bank & 0xffu);
+    image[i + 1] = static_cast<byte>(bank >> 8u);
+  }
+  image[0x0147] = static_cast<byte>(type);
+  image[0x0149] = static_cast<byte>(ram_size_code);
+  return Rom::from(std::move(image));
+}
+
+unsigned bank_at(const PageTableMemoryBus &bus, word address) {
+  return to_integer<unsigned>(bus.read(address)) |
+         to_integer<unsigned>(bus.read(static_cast<word>(address + 1))) << 8u;
+}
+
+TEST(Cartridge, TheHeaderNamesTheControllerAndRAMSize) {
+  EXPECT_EQ(controller_type(numbered_rom(2, 0x00, 0)), ControllerType::None);
+  EXPECT_EQ(controller_type(numbered_rom(2, 0x03, 0)), ControllerType::MBC1);
+  EXPECT_EQ(controller_type(numbered_rom(2, 0x13, 0)), ControllerType::MBC3);
+  EXPECT_EQ(controller_type(numbered_rom(2, 0x1b, 0)), ControllerType::MBC5);
+  EXPECT_THROW(static_cast<void>(controller_type(numbered_rom(2, 0x05, 0))),
+               std::runtime_error);
+
+  EXPECT_EQ(ram_size(numbered_rom(2, 0x00, 0)), 0);
+  EXPECT_EQ(ram_size(numbered_rom(2, 0x00, 2)), 0x2000);
+  EXPECT_EQ(ram_size(numbered_rom(2, 0x00, 3)), 0x8000);
+}
+
+TEST(Cartridge, RejectsROMsWhichAreNotWholeBanks) {
+  PageTableMemoryBus bus;
+
+  EXPECT_THROW(Controller::install(bus, Rom::from(std::vector<byte>(0x4000))),
+               std::runtime_error);
+  EXPECT_THROW(Controller::install(bus, Rom::from(std::vector<byte>(0x8001))),
+               std::runtime_error);
+}
+
+TEST(Cartridge, ROMOnlyCartridgesMapBothBanksAndTheirRAM) {
+  PageTableMemoryBus bus;
+  Controller::install(bus, numbered_rom(2, 0x09, 2));
+
+  bus.write(0x2000, byte{0x05});
+  bus.write(0xa010, byte{0x42});
+
+  EXPECT_EQ(bank_at(bus, 0x0100), 0);
+  EXPECT_EQ(bank_at(bus, 0x4000), 1);
+  EXPECT_EQ(bus.read(0xa010), byte{0x42});
+}
+
+TEST(Cartridge, TheSameROMCanBeSharedBetweenBuses) {
+  const auto rom = numbered_rom(4, 0x01, 0);
+  PageTableMemoryBus first;
+  PageTableMemoryBus second;
+  Controller::install(first, rom);
+  Controller::install(second, rom);
+
+  first.write(0x2000, byte{0x03});
+
+  EXPECT_EQ(bank_at(first, 0x4000), 3);
+  EXPECT_EQ(bank_at(second, 0x4000), 1);
+}
+
+TEST(Cartridge, MBC1SwitchesTheUpperROMWindow) {
+  PageTableMemoryBus bus;
+  auto &controller = Controller::install(bus, numbered_rom(128, 0x01, 0));
+
+  EXPECT_EQ(bank_at(bus, 0x4000), 1);
+  bus.write(0x2000, byte{0x07});
+  EXPECT_EQ(bank_at(bus, 0x7ffe), 7);
+  EXPECT_EQ(controller.rom_bank(), 7);
+  bus.write(0x2000, byte{0x00});
+  EXPECT_EQ(bank_at(bus, 0x4000), 1);
+  bus.write(0x4000, byte{0x02});
+  bus.write(0x2000, byte{0x05});
+  EXPECT_EQ(bank_at(bus, 0x4000), 0x45);
+  EXPECT_EQ(bank_at(bus, 0x0000 + 0x200), 0);
+}
+
+TEST(Cartridge, MBC1AdvancedBankingSwitchesTheLowerWindowAndRAM) {
+  PageTableMemoryBus bus;
+  Controller::install(bus, numbered_rom(128, 0x03, 3));
+  bus.write(0x0000, byte{0x0a});
+  bus.write(0x4000, byte{0x01});
+  bus.write(0xa000, byte{0x11});
+
+  bus.write(0x6000, byte{0x01});
+
+  EXPECT_EQ(bank_at(bus, 0x0200), 0x20);
+  EXPECT_NE(bus.read(0xa000), byte{0x11});
+  bus.write(0xa000, byte{0x22});
+  bus.write(0x6000, byte{0x00});
+  EXPECT_EQ(bank_at(bus, 0x0200), 0);
+  EXPECT_EQ(bus.read(0xa000), byte{0x11});
+}
+
+TEST(Cartridge, DisabledRAMReadsAsOpenBusAndIgnoresWrites) {
+  PageTableMemoryBus bus;
+  auto &controller = Controller::install(bus, numbered_rom(4, 0x03, 2));
+
+  bus.write(0xa000, byte{0x12});
+  EXPECT_EQ(bus.read(0xa000), byte{0xff});
+  EXPECT_FALSE(controller.ram_enabled());
+
+  bus.write(0x0000, byte{0x0a});
+  bus.write(0xa000, byte{0x12});
+  EXPECT_EQ(bus.read(0xa000), byte{0x12});
+  EXPECT_EQ(controller.ram().data.get()[0], byte{0x12});
+
+  bus.write(0x0000, byte{0x00});
+  EXPECT_EQ(bus.read(0xa000), byte{0xff});
+}
+
+TEST(Cartridge, SmallRAMRepeatsAcrossTheWindow) {
+  PageTableMemoryBus bus;
+  Controller::install(bus, numbered_rom(2, 0x03, 1));
+  bus.write(0x0000, byte{0x0a});
+
+  bus.write(0xa001, byte{0x34});
+
+  EXPECT_EQ(bus.read(0xa801), byte{0x34});
+}
+
+TEST(Cartridge, MBC3SwitchesROMAndRAMBanks) {
+  PageTableMemoryBus bus;
+  auto &controller = Controller::install(bus, numbered_rom(128, 0x13, 3));
+  bus.write(0x0000, byte{0x0a});
+
+  bus.write(0x2000, byte{0x7f});
+  EXPECT_EQ(bank_at(bus, 0x4000), 0x7f);
+  bus.write(0x2000, byte{0x00});
+  EXPECT_EQ(bank_at(bus, 0x4000), 1);
+
+  bus.write(0x4000, byte{0x02});
+  bus.write(0xa000, byte{0x56});
+  EXPECT_EQ(controller.ram_bank(), 2);
+  bus.write(0x4000, byte{0x00});
+  EXPECT_NE(bus.read(0xa000), byte{0x56});
+  bus.write(0x4000, byte{0x02});
+  EXPECT_EQ(bus.read(0xa000), byte{0x56});
+}
+
+TEST(Cartridge, MBC3ClockRegistersAreReadThroughTheLatch) {
+  PageTableMemoryBus bus;
+  Controller::install(bus, numbered_rom(4, 0x10, 3));
+  bus.write(0x0000, byte{0x0a});
+  bus.write(0x4000, byte{0x08});
+
+  bus.write(0xa000, byte{0x2a});
+  EXPECT_EQ(bus.read(0xa000), byte{0x2a});
+  bus.write(0x6000, byte{0x00});
+  bus.write(0x6000, byte{0x01});
+  EXPECT_EQ(bus.read(0xb000), byte{0x2a});
+
+  bus.write(0x4000, byte{0x00});
+  EXPECT_NE(bus.read(0xa000), byte{0x2a});
+}
+
+TEST(Cartridge, MBC5SwitchesNineBitROMBanksAndSixteenRAMBanks) {
+  PageTableMemoryBus bus;
+  auto &controller = Controller::install(bus, numbered_rom(512, 0x1b, 4));
+
+  bus.write(0x2000, byte{0x00});
+  EXPECT_EQ(bank_at(bus, 0x4000), 0);
+  bus.write(0x2000, byte{0x34});
+  bus.write(0x3000, byte{0x01});
+  EXPECT_EQ(bank_at(bus, 0x4000), 0x134);
+
+  bus.write(0x0000, byte{0x0a});
+  bus.write(0x4000, byte{0x0f});
+  bus.write(0xbfff, byte{0x78});
+  EXPECT_EQ(controller.ram_bank(), 15);
+  EXPECT_EQ(controller.ram().data.get()[0x1ffff], byte{0x78});
+}
+} // namespace
@@ -0,0 +1,213 @@
+#include "greenboy/cartridge.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace greenboy;
+using namespace greenboy::cartridge;
+
+// A two bank MBC1 ROM in a temporary file, removed again by the destructor
+class RomFile {
+  std::string m_path;
+
+public:
+  explicit RomFile(const std::string &name)
+      : m_path(testing::TempDir() + name) {
+    std::ofstream file{m_path, std::ios::binary};
+    for (std::size_t i = 0; i < 0x8000; ++i) {
+      file.put(static_cast<char>(i == 0x0147 ? 0x01 : i / 0x4000));
+    }
+  }
+  RomFile(const RomFile &) = delete;
+  RomFile(RomFile &&) = delete;
+  ~RomFile() { std::remove(m_path.c_str()); }
+
+  RomFile &operator=(const RomFile &) = delete;
+  RomFile &operator=(RomFile &&) = delete;
+
+  [[nodiscard]] const std::string &path() const noexcept { return m_path; }
+};
+
+TEST(CartridgeFile, MapsTheROMReadOnly) {
+  const RomFile file{"greenboy_mapped.gb"};
+  PageTableMemoryBus bus;
+
+  Controller::install(bus, Rom::map(file.path()));
+
+  EXPECT_EQ(bus.read(0x0100), byte{0x00});
+  EXPECT_EQ(bus.read(0x4000), byte{0x01});
+  EXPECT_EQ(bus.read(0x0147), byte{0x01});
+}
+
+TEST(CartridgeFile, EveryInstanceSharesOneMapping) {
+  const RomFile file{"greenboy_shared.gb"};
+
+  const auto first = Rom::map(file.path());
+  const auto second = Rom::map(file.path(), MapOptions{true, true});
+
+  EXPECT_EQ(first.data.get(), second.data.get());
+  EXPECT_EQ(first.size, 0x8000);
+}
+
+TEST(CartridgeFile, MissingFilesAreRejected) {
+  EXPECT_THROW(static_cast<void>(Rom::map(testing::TempDir() + "missing.gb")),
+               std::runtime_error);
+}
+
+TEST(CartridgeFile, ReportsTheResidentMemoryOfAnInstance) {
+  const RomFile file{"greenboy_resident.gb"};
+  const auto rom = Rom::map(file.path());
+  PageTableMemoryBus first;
+  PageTableMemoryBus second;
+  auto &controller = Controller::install(first, rom, Ram::allocate(0x2000));
+  Controller::install(second, rom);
+
+  first.write(0x0000, byte{0x0a});
+  first.write(0xa000, byte{0x01});
+  static_cast<void>(first.read(0x0000));
+
+  const auto usage = controller.memory_usage();
+  EXPECT_GT(usage.rom_resident, 0);
+  EXPECT_LE(usage.rom_resident, rom.size);
+  EXPECT_EQ(usage.rom_sharers, 2);
+  EXPECT_GT(usage.ram_resident, 0);
+  EXPECT_EQ(usage.proportional(), usage.rom_resident / 2 + usage.ram_resident);
+}
+
+TEST(CartridgeFile, CountsTheControllersAnImageIsInstalledIn) {
+  const RomFile file{"greenboy_sharers.gb"};
+  const auto rom = Rom::map(file.path());
+  const auto copy = rom;
+  PageTableMemoryBus first;
+  auto &controller = Controller::install(first, Rom::map(file.path()));
+  {
+    PageTableMemoryBus second;
+    Controller::install(second, copy);
+    EXPECT_EQ(controller.memory_usage().rom_sharers, 2);
+  }
+
+  EXPECT_EQ(controller.memory_usage().rom_sharers, 1);
+}
+
+std::vector<char> contents(const std::string &path) {
+  std::ifstream file{path, std::ios::binary};
+  return std::vector<char>(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+}
+
+TEST(CartridgeFile, SaveFilesAreCreatedWithTheRAMSize) {
+  const auto path = testing::TempDir() + "greenboy_created.sav";
+  std::remove(path.c_str());
+  {
+    const SaveFile save{path, 0x2000};
+    EXPECT_EQ(save.ram().size, 0x2000);
+  }
+
+  EXPECT_EQ(contents(path).size(), 0x2000);
+  std::remove(path.c_str());
+}
+
+TEST(CartridgeFile, RAMWritesReachTheSaveFile) {
+  const RomFile file{"greenboy_battery.gb"};
+  const auto path = testing::TempDir() + "greenboy_battery.sav";
+  std::remove(path.c_str());
+  SaveFile save{path, 0x2000};
+  PageTableMemoryBus bus;
+  Controller::install(bus, Rom::map(file.path()), save.ram());
+
+  bus.write(0x0000, byte{0x0a});
+  bus.write(0xa123, byte{0x5a});
+
+  // Through the page cache, before any flush
+  EXPECT_EQ(contents(path)[0x123], 0x5a);
+  std::remove(path.c_str());
+}
+
+#ifdef __linux__
+// The bytes of the mapping holding address which have been written since
+// they were last written back, from /proc/self/smaps
+std::size_t dirty_bytes(const void *address) {
+  const auto at = reinterpret_cast<std::uintptr_t>(address);
+  std::ifstream smaps{"/proc/self/smaps"};
+  std::string line;
+  auto inside = false;
+  std::size_t dirty = 0;
+  while (std::getline(smaps, line)) {
+    std::uintptr_t begin = 0;
+    std::uintptr_t end = 0;
+    char dash = 0;
+    std::istringstream fields{line};
+    if (fields >> std::hex >> begin >> dash >> end && dash == '-') {
+      inside = begin <= at && at < end;
+      continue;
+    }
+    std::string name;
+    std::size_t kilobytes = 0;
+    std::istringstream entry{line};
+    if (inside && entry >> name >> kilobytes &&
+        (name == "Shared_Dirty:" || name == "Private_Dirty:")) {
+      dirty += kilobytes * 1024;
+    }
+  }
+  return dirty;
+}
+
+TEST(CartridgeFile, FlushWritesTheDirtyPagesBack) {
+  const auto path = testing::TempDir() + "greenboy_dirty.sav";
+  std::remove(path.c_str());
+  SaveFile save{path, 0x2000};
+  auto *ram = save.ram().data.get();
+
+  ram[0x1000] = byte{0x42};
+  EXPECT_GT(dirty_bytes(ram), 0);
+  save.flush();
+
+  EXPECT_EQ(dirty_bytes(ram), 0);
+  EXPECT_EQ(save.flushes(), 1);
+  std::remove(path.c_str());
+}
+#endif
+
+TEST(CartridgeFile, SavesAreLoadedAgain) {
+  const auto path = testing::TempDir() + "greenboy_reload.sav";
+  std::remove(path.c_str());
+  {
+    const SaveFile save{path, 0x2000};
+    save.ram().data.get()[0x1fff] = byte{0x77};
+  }
+
+  const SaveFile save{path, 0x2000};
+
+  EXPECT_EQ(save.ram().data.get()[0x1fff], byte{0x77});
+  std::remove(path.c_str());
+}
+
+TEST(CartridgeFile, FlushesOnceEveryInterval) {
+  const auto path = testing::TempDir() + "greenboy_interval.sav";
+  std::remove(path.c_str());
+  SaveFile save{path, 0x2000, SaveFile::frame * 2};
+
+  save.advance(SaveFile::frame);
+  EXPECT_EQ(save.flushes(), 0);
+  save.advance(SaveFile::frame);
+  EXPECT_EQ(save.flushes(), 1);
+  save.advance(SaveFile::frame);
+  EXPECT_EQ(save.flushes(), 1);
+  save.flush();
+  EXPECT_EQ(save.flushes(), 2);
+  // The interval starts again with an explicit flush
+  save.advance(SaveFile::frame);
+  EXPECT_EQ(save.flushes(), 2);
+
+  EXPECT_THROW(SaveFile(path, 0x2000, cycles{0}), std::runtime_error);
+  std::remove(path.c_str());
+}
+} // namespace
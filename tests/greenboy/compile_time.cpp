@@ -0,0 +1,238 @@
+#include "greenboy/data_access/compile_time.hpp"
+#include "greenboy/instructions/compile_time.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "greenboy/data_access/byte_register.hpp"
+#include "greenboy/data_access/constant_byte.hpp"
+#include "greenboy/data_access/decrementing_word.hpp"
+#include "greenboy/data_access/delayed_word_access.hpp"
+#include "greenboy/data_access/double_byte_word.hpp"
+#include "greenboy/data_access/immediate_byte.hpp"
+#include "greenboy/data_access/immediate_word.hpp"
+#include "greenboy/data_access/incrementing_word.hpp"
+#include "greenboy/data_access/indirect_byte.hpp"
+#include "greenboy/data_access/indirect_word.hpp"
+#include "greenboy/data_access/offsat_word.hpp"
+#include "greenboy/data_access/pre_decrementing_word.hpp"
+#include "greenboy/data_access/pre_incrementing_word.hpp"
+#include "greenboy/data_access/relative_address.hpp"
+#include "greenboy/data_access/stack_word.hpp"
+#include "greenboy/data_access/word_register.hpp"
+#include "greenboy/instructions/byte_load.hpp"
+#include "greenboy/instructions/word_load.hpp"
+
+namespace {
+using namespace greenboy;
+namespace ct = data_access::compile_time;
+using HL = ct::WordRegister<CPU::R16::HL>;
+using SP = ct::WordRegister<CPU::R16::SP>;
+using A = ct::ByteRegister<CPU::R8::A>;
+using C = ct::ByteRegister<CPU::R8::C>;
+
+struct State {
+  CPU::RegisterSet registers{};
+  FakeMemoryBus memory;
+};
+
+void randomize(std::mt19937 &random, State &lhs, State &rhs) {
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  auto next = [&] { return static_cast<byte>(bytes(random)); };
+  for (auto address = 0u; address < 0x10000u; ++address) {
+    const auto value = next();
+    lhs.memory.write(static_cast<word>(address), value);
+    rhs.memory.write(static_cast<word>(address), value);
+  }
+  auto &r = lhs.registers;
+  r.pc = to_word(next(), next());
+  r.sp = to_word(next(), next());
+  r.a = next();
+  r.b = next();
+  r.c = next();
+  r.d = next();
+  r.e = next();
+  r.h = next();
+  r.l = next();
+  r.f = CPU::Flags{next()};
+  rhs.registers = r;
+}
+
+void expect_same(const State &expected, const State &actual) {
+  EXPECT_EQ(expected.registers, actual.registers);
+  EXPECT_EQ(expected.registers.pc, actual.registers.pc);
+  EXPECT_EQ(expected.registers.sp, actual.registers.sp);
+  for (auto address = 0u; address < 0x10000u; ++address) {
+    ASSERT_EQ(expected.memory.read(static_cast<word>(address)),
+              actual.memory.read(static_cast<word>(address)));
+  }
+}
+
+template <class Static, class Runtime>
+void expect_equivalent_reads(const Runtime &runtime) {
+  std::mt19937 random{0xc0de};
+  for (auto repetition = 0; repetition < 16; ++repetition) {
+    State expected;
+    State actual;
+    randomize(random, expected, actual);
+
+    EXPECT_EQ(runtime.read(expected.registers, expected.memory),
+              Static::read(actual.registers, actual.memory));
+    expect_same(expected, actual);
+  }
+  EXPECT_EQ(runtime.access_time(), Static::access_time());
+}
+
+template <class Static, class Runtime, class Value>
+void expect_equivalent_writes(Runtime &runtime, Value value) {
+  std::mt19937 random{0xbeef};
+  for (auto repetition = 0; repetition < 16; ++repetition) {
+    State expected;
+    State actual;
+    randomize(random, expected, actual);
+
+    runtime.write(expected.registers, expected.memory, value);
+    Static::write(actual.registers, actual.memory, value);
+    expect_same(expected, actual);
+  }
+}
+
+TEST(CompileTimeDataAccess, AccessTimesAreConstantExpressions) {
+  static_assert(
+      ct::IndirectByte<ct::IncrementingWord<HL>>::access_time() == cycles{4});
+  static_assert(
+      ct::IndirectWord<ct::DoubleByteWord<ct::ImmediateByte,
+                                          ct::ImmediateByte>>::access_time() ==
+      cycles{16});
+  static_assert(ct::OffsatWord<ct::DelayedWordAccess<SP>,
+                               ct::ImmediateByte>::access_time() == cycles{8});
+  static_assert(instructions::compile_time::Load<A, ct::ImmediateByte>::time ==
+                cycles{4});
+}
+
+TEST(CompileTimeDataAccess, ByteRegisters) {
+  using namespace data_access;
+  expect_equivalent_reads<ct::ByteRegister<CPU::R8::H>>(
+      ByteRegister{CPU::R8::H});
+  ByteRegister runtime{CPU::R8::E};
+  expect_equivalent_writes<ct::ByteRegister<CPU::R8::E>>(runtime, byte{0x5a});
+}
+
+TEST(CompileTimeDataAccess, WordRegisters) {
+  using namespace data_access;
+  expect_equivalent_reads<ct::WordRegister<CPU::R16::AF>>(
+      WordRegister{CPU::R16::AF});
+  WordRegister runtime{CPU::R16::DE};
+  expect_equivalent_writes<ct::WordRegister<CPU::R16::DE>>(runtime,
+                                                           word{0x1234});
+}
+
+TEST(CompileTimeDataAccess, ConstantAndImmediateBytes) {
+  using namespace data_access;
+  expect_equivalent_reads<ct::ConstantByte<byte{0x42}>>(
+      ConstantByte{byte{0x42}});
+  expect_equivalent_reads<ct::ImmediateByte>(ImmediateByte{});
+  expect_equivalent_reads<ct::RelativeAddress>(RelativeAddress{});
+}
+
+TEST(CompileTimeDataAccess, IndirectByteThroughIncrementingHL) {
+  using namespace data_access;
+  expect_equivalent_reads<ct::IndirectByte<ct::IncrementingWord<HL>>>(
+      IndirectByte{IncrementingWord::from(WordRegister::hl())});
+  IndirectByte runtime{DecrementingWord::from(WordRegister::hl())};
+  expect_equivalent_writes<ct::IndirectByte<ct::DecrementingWord<HL>>>(
+      runtime, byte{0x77});
+}
+
+TEST(CompileTimeDataAccess, HighPageAccess) {
+  using namespace data_access;
+  using Static =
+      ct::IndirectByte<ct::DoubleByteWord<ct::ConstantByte<byte{0xff}>, C>>;
+  IndirectByte runtime{DoubleByteWord::from(ConstantByte::from(byte{0xff}),
+                                            ByteRegister::c())};
+  expect_equivalent_reads<Static>(runtime);
+  expect_equivalent_writes<Static>(runtime, byte{0x12});
+}
+
+TEST(CompileTimeDataAccess, StackAccesses) {
+  using namespace data_access;
+  using Push = ct::DelayedWordAccess<
+      ct::DoubleByteWord<ct::IndirectByte<ct::PreDecrementingWord<SP>>,
+                         ct::IndirectByte<ct::PreDecrementingWord<SP>>>>;
+  DelayedWordAccess push{DoubleByteWord::from(
+      IndirectByte::from(PreDecrementingWord::from(WordRegister::sp())),
+      IndirectByte::from(PreDecrementingWord::from(WordRegister::sp())))};
+  expect_equivalent_writes<Push>(push, word{0xbeef});
+  EXPECT_EQ(push.access_time(), Push::access_time());
+
+  using Pop = ct::DoubleByteWord<ct::IndirectByte<ct::IncrementingWord<SP>>,
+                                 ct::IndirectByte<ct::IncrementingWord<SP>>>;
+  expect_equivalent_reads<Pop>(DoubleByteWord{
+      IndirectByte::from(IncrementingWord::from(WordRegister::sp())),
+      IndirectByte::from(IncrementingWord::from(WordRegister::sp()))});
+}
+
+TEST(CompileTimeDataAccess, WordAccessesMatchTheirByteCompositions) {
+  using namespace data_access;
+  using Pop = ct::DoubleByteWord<ct::IndirectByte<ct::IncrementingWord<SP>>,
+                                 ct::IndirectByte<ct::IncrementingWord<SP>>>;
+  expect_equivalent_reads<Pop>(StackWord{});
+  using Push =
+      ct::DoubleByteWord<ct::IndirectByte<ct::PreDecrementingWord<SP>>,
+                         ct::IndirectByte<ct::PreDecrementingWord<SP>>>;
+  StackWord push;
+  expect_equivalent_writes<Push>(push, word{0xbeef});
+  expect_equivalent_reads<ct::StackWord>(StackWord{});
+  expect_equivalent_writes<ct::StackWord>(push, word{0xbeef});
+
+  expect_equivalent_reads<
+      ct::DoubleByteWord<ct::ImmediateByte, ct::ImmediateByte>>(
+      ImmediateWord{});
+  expect_equivalent_reads<ct::ImmediateWord>(ImmediateWord{});
+}
+
+TEST(CompileTimeDataAccess, IndirectWordThroughImmediateAddress) {
+  using namespace data_access;
+  using Static = ct::IndirectWord<
+      ct::DoubleByteWord<ct::ImmediateByte, ct::ImmediateByte>>;
+  IndirectWord runtime{DoubleByteWord::from(ImmediateByte::instance(),
+                                            ImmediateByte::instance())};
+  expect_equivalent_reads<Static>(runtime);
+  expect_equivalent_writes<Static>(runtime, word{0xfff8});
+}
+
+TEST(CompileTimeDataAccess, OffsatStackPointer) {
+  using namespace data_access;
+  expect_equivalent_reads<
+      ct::OffsatWord<ct::DelayedWordAccess<SP>, ct::ImmediateByte>>(
+      OffsatWord{DelayedWordAccess::from(WordRegister::sp()),
+                 ImmediateByte::instance()});
+}
+
+TEST(CompileTimeDataAccess, IncrementAndDecrementBeforeRead) {
+  using namespace data_access;
+  expect_equivalent_reads<ct::PreIncrementingWord<HL>>(
+      PreIncrementingWord{WordRegister::hl()});
+  expect_equivalent_reads<ct::PreDecrementingWord<HL>>(
+      PreDecrementingWord{WordRegister::hl()});
+}
+
+TEST(CompileTimeLoad, MatchesTheRuntimeLoad) {
+  using namespace data_access;
+  instructions::ByteLoad runtime{
+      ByteRegister::a(),
+      IndirectByte::from(IncrementingWord::from(WordRegister::hl()))};
+  using Static = ct::IndirectByte<ct::IncrementingWord<HL>>;
+  instructions::compile_time::Load<A, Static> instruction;
+
+  std::mt19937 random{0x10ad};
+  State expected;
+  State actual;
+  randomize(random, expected, actual);
+
+  EXPECT_EQ(runtime.execute(expected.registers, expected.memory),
+            instruction.execute(actual.registers, actual.memory));
+  expect_same(expected, actual);
+}
+} // namespace
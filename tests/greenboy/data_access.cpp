@@ -11,11 +11,15 @@
 #include "greenboy/data_access/delayed_word_access.hpp"
 #include "greenboy/data_access/double_byte_word.hpp"
 #include "greenboy/data_access/immediate_byte.hpp"
+#include "greenboy/data_access/immediate_word.hpp"
 #include "greenboy/data_access/incrementing_word.hpp"
 #include "greenboy/data_access/indirect_byte.hpp"
 #include "greenboy/data_access/indirect_word.hpp"
 #include "greenboy/data_access/offsat_word.hpp"
 #include "greenboy/data_access/pre_decrementing_word.hpp"
+#include "greenboy/data_access/pre_incrementing_word.hpp"
+#include "greenboy/data_access/relative_address.hpp"
+#include "greenboy/data_access/stack_word.hpp"
 #include "greenboy/data_access/word_access.hpp"
 #include "greenboy/data_access/word_register.hpp"
 
@@ -105,6 +109,52 @@ TEST(ImmediateByte, RejectsWrites) {
   EXPECT_THROW(access.write(registers, memory, byte{0x34}), std::runtime_error);
 }
 
+TEST(ImmediateWord, ReadsTheNextTwoBytesLowByteFirst) {
+  ImmediateWord access;
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+  registers.pc = word{0x0100};
+  EXPECT_CALL(memory, read(word{0x0100})).WillOnce(Return(byte{0x34}));
+  EXPECT_CALL(memory, read(word{0x0101})).WillOnce(Return(byte{0x12}));
+
+  EXPECT_EQ(access.read(registers, memory), word{0x1234});
+  EXPECT_EQ(registers.pc, word{0x0102});
+}
+
+TEST(ImmediateWord, RejectsWrites) {
+  ImmediateWord access;
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+
+  EXPECT_THROW(access.write(registers, memory, word{0x1234}),
+               std::runtime_error);
+}
+
+TEST(StackWord, ReadsPopTheTopOfTheStack) {
+  StackWord access;
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+  registers.sp = word{0xfffc};
+  EXPECT_CALL(memory, read(word{0xfffc})).WillOnce(Return(byte{0xcd}));
+  EXPECT_CALL(memory, read(word{0xfffd})).WillOnce(Return(byte{0xab}));
+
+  EXPECT_EQ(access.read(registers, memory), word{0xabcd});
+  EXPECT_EQ(registers.sp, word{0xfffe});
+}
+
+TEST(StackWord, WritesPushTheHighByteFirst) {
+  StackWord access;
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+  registers.sp = word{0xfffe};
+  ::testing::InSequence sequence;
+  EXPECT_CALL(memory, write(word{0xfffd}, byte{0xab}));
+  EXPECT_CALL(memory, write(word{0xfffc}, byte{0xcd}));
+
+  access.write(registers, memory, word{0xabcd});
+  EXPECT_EQ(registers.sp, word{0xfffc});
+}
+
 TEST(IndirectByte, RejectNullPointers) {
   auto pointer = std::make_shared<MockWordAccess>();
 
@@ -431,6 +481,70 @@ TEST(PreDecrementingWord, WritesAreRejected) {
   EXPECT_THROW(access.write(registers, memory, word{0x00}), std::runtime_error);
 }
 
+TEST(PreIncrementingWord, RejectsNullPointers) {
+  auto inner = std::make_shared<MockWordAccess>();
+
+  EXPECT_THROW(PreIncrementingWord(nullptr), std::runtime_error);
+  EXPECT_NO_THROW(PreIncrementingWord(std::move(inner)));
+}
+
+TEST(PreIncrementingWord, ReadOverflow) {
+  auto inner = std::make_shared<MockWordAccess>();
+  EXPECT_CALL(*inner, read(_, _)).WillOnce(Return(word{0xffff}));
+  EXPECT_CALL(*inner, write(_, _, word{0x0000}));
+
+  PreIncrementingWord access(std::move(inner));
+
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+
+  auto result = access.read(registers, memory);
+
+  EXPECT_EQ(result, word{0x0000});
+  EXPECT_EQ(registers, CPU::RegisterSet{});
+}
+
+TEST(PreIncrementingWord, WritesAreRejected) {
+  auto inner = std::make_shared<MockWordAccess>();
+
+  PreIncrementingWord access(std::move(inner));
+
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+
+  EXPECT_THROW(access.write(registers, memory, word{0x00}), std::runtime_error);
+}
+
+TEST(RelativeAddress, ForwardOffset) {
+  RelativeAddress access;
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+  registers.pc = word{0x0150};
+  EXPECT_CALL(memory, read(word{0x0150})).WillOnce(Return(byte{0x10}));
+
+  EXPECT_EQ(access.read(registers, memory), word{0x0161});
+  EXPECT_EQ(registers.pc, word{0x0151});
+  EXPECT_EQ(access.access_time(), cycles{4});
+}
+
+TEST(RelativeAddress, BackwardOffset) {
+  RelativeAddress access;
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+  registers.pc = word{0x0150};
+  EXPECT_CALL(memory, read(word{0x0150})).WillOnce(Return(byte{0xfe}));
+
+  EXPECT_EQ(access.read(registers, memory), word{0x014f});
+}
+
+TEST(RelativeAddress, RejectsWrites) {
+  RelativeAddress access;
+  MockMemoryBus memory;
+  CPU::RegisterSet registers{};
+
+  EXPECT_THROW(access.write(registers, memory, word{0x34}), std::runtime_error);
+}
+
 TEST(DelayedWordAccess, RejectsNullPointers) {
   auto inner = std::make_shared<MockWordAccess>();
   EXPECT_DEATH(DelayedWordAccess(nullptr), "");
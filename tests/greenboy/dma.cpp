@@ -0,0 +1,151 @@
+#include "greenboy/dma.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "greenboy/io_registers.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+
+namespace {
+using namespace greenboy;
+
+struct System {
+  std::vector<byte> vram = std::vector<byte>(0x2000);
+  std::vector<byte> wram = std::vector<byte>(0x2000);
+  Dma::Oam oam{};
+  PageTableMemoryBus bus;
+  IoRegisters &io = IoRegisters::install(bus);
+  Dma dma;
+
+  explicit System(Dma::Model model = Dma::Model::Cgb)
+      : dma{bus, io, oam, model} {
+    bus.map(0x8000, vram.size(), vram.data());
+    bus.map(0xc000, wram.size(), wram.data());
+    bus.map(0xfe00, PageTableMemoryBus::page_size, oam.data());
+    for (std::size_t i = 0; i < wram.size(); ++i) {
+      wram[i] = static_cast<byte>(i);
+    }
+  }
+};
+
+TEST(Dma, OAMTransfersCopyOneHundredAndSixtyBytes) {
+  System system;
+
+  system.bus.write(Dma::oam_dma_address, byte{0xc1});
+
+  EXPECT_EQ(system.oam[0x00], byte{0x00});
+  EXPECT_EQ(system.oam[0x9f], byte{0x9f});
+  EXPECT_EQ(system.oam[0xa0], byte{0x00});
+  EXPECT_EQ(system.bus.read(Dma::oam_dma_address), byte{0xc1});
+}
+
+TEST(Dma, OAMIsLockedOutUntilTheTransferEnds) {
+  System system;
+  system.bus.write(Dma::oam_dma_address, byte{0xc1});
+
+  EXPECT_TRUE(system.dma.oam_transfer());
+  EXPECT_EQ(system.bus.read(0xfe01), byte{0xff});
+  system.bus.write(0xfe01, byte{0x55});
+  system.dma.advance(Dma::oam_transfer_time - cycles{4});
+  EXPECT_EQ(system.bus.read(0xfe01), byte{0xff});
+  system.dma.advance(cycles{4});
+
+  EXPECT_FALSE(system.dma.oam_transfer());
+  EXPECT_EQ(system.bus.read(0xfe01), byte{0x01});
+}
+
+TEST(Dma, OnlyHighRAMAndTheRegistersStayReachableDuringTheTransfer) {
+  System system;
+  system.bus.write(Dma::oam_dma_address, byte{0xc1});
+
+  system.bus.write(0xc010, byte{0x55});
+  system.bus.write(0xff80, byte{0x66});
+  EXPECT_EQ(system.bus.read(0xc010), byte{0xff});
+  EXPECT_EQ(system.bus.read(0x8010), byte{0xff});
+  EXPECT_EQ(system.bus.read(0xff80), byte{0x66});
+  EXPECT_EQ(system.bus.read(Dma::oam_dma_address), byte{0xc1});
+  system.dma.advance(Dma::oam_transfer_time);
+
+  EXPECT_FALSE(system.bus.locked_out());
+  EXPECT_EQ(system.wram[0x10], byte{0x10});
+  EXPECT_EQ(system.bus.read(0xc010), byte{0x10});
+  EXPECT_EQ(system.bus.read(0x8010), byte{0x00});
+}
+
+TEST(Dma, TheVRAMTransferRegistersAreOnlyThereInCGBMode) {
+  System system{Dma::Model::Dmg};
+  system.bus.write(Dma::hdma1_address, byte{0xc1});
+  system.bus.write(Dma::hdma5_address, byte{0x01});
+
+  EXPECT_EQ(system.vram[0x01], byte{0x00});
+  EXPECT_EQ(system.bus.read(Dma::hdma5_address), byte{0xff});
+  EXPECT_EQ(system.dma.take_stall(), cycles{0});
+}
+
+TEST(Dma, OAMTransfersMarkTrackedOAMDirty) {
+  System system;
+  system.bus.track_writes(0xfe00, PageTableMemoryBus::page_size);
+
+  system.bus.write(Dma::oam_dma_address, byte{0xc1});
+
+  EXPECT_TRUE(system.bus.dirty(0xfe00, 0xa0));
+}
+
+TEST(Dma, OAMTransfersFromEchoRAMReadWorkRAM) {
+  System system;
+
+  system.bus.write(Dma::oam_dma_address, byte{0xe1});
+
+  EXPECT_EQ(system.oam[0x10], byte{0x10});
+}
+
+TEST(Dma, GeneralPurposeTransfersCopyEverythingAndStallTheCPU) {
+  System system;
+  system.bus.write(Dma::hdma1_address, byte{0xc1});
+  system.bus.write(Dma::hdma2_address, byte{0x0f});
+  system.bus.write(Dma::hdma3_address, byte{0x01});
+  system.bus.write(Dma::hdma4_address, byte{0x20});
+
+  system.bus.write(Dma::hdma5_address, byte{0x01});
+
+  EXPECT_EQ(system.vram[0x120], byte{0x00});
+  EXPECT_EQ(system.vram[0x13f], byte{0x1f});
+  EXPECT_EQ(system.vram[0x140], byte{0x00});
+  EXPECT_EQ(system.bus.read(Dma::hdma5_address), byte{0xff});
+  EXPECT_EQ(system.dma.take_stall(), cycles{64});
+  EXPECT_EQ(system.dma.take_stall(), cycles{0});
+}
+
+TEST(Dma, HBlankTransfersCopySixteenBytesPerHBlank) {
+  System system;
+  system.bus.write(Dma::hdma1_address, byte{0xc2});
+  system.bus.write(Dma::hdma2_address, byte{0x00});
+  system.bus.write(Dma::hdma3_address, byte{0x00});
+  system.bus.write(Dma::hdma4_address, byte{0x00});
+
+  system.bus.write(Dma::hdma5_address, byte{0x82});
+  system.dma.hblank();
+
+  EXPECT_EQ(system.vram[0x0f], byte{0x0f});
+  EXPECT_EQ(system.vram[0x10], byte{0x00});
+  EXPECT_EQ(system.bus.read(Dma::hdma5_address), byte{0x01});
+  system.dma.hblank();
+  system.dma.hblank();
+  EXPECT_EQ(system.vram[0x2f], byte{0x2f});
+  EXPECT_EQ(system.bus.read(Dma::hdma5_address), byte{0xff});
+  EXPECT_EQ(system.dma.take_stall(), cycles{0});
+}
+
+TEST(Dma, HBlankTransfersCanBeStopped) {
+  System system;
+  system.bus.write(Dma::hdma1_address, byte{0xc2});
+  system.bus.write(Dma::hdma5_address, byte{0x82});
+  system.dma.hblank();
+
+  system.bus.write(Dma::hdma5_address, byte{0x00});
+  system.dma.hblank();
+
+  EXPECT_EQ(system.vram[0x10], byte{0x00});
+  EXPECT_EQ(system.bus.read(Dma::hdma5_address), byte{0x81});
+}
+} // namespace
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "greenboy/fetch_execute_cpu.hpp"
+#include "greenboy/table_opcode_translator.hpp"
+#include "memory_bus.hpp"
+
+// Runs a CPU core against FetchExecuteCPU on copies of the same random
+// program, for the differential tests of the faster cores
+namespace differential {
+// Opcodes which would end a random program early
+inline bool is_terminal(unsigned opcode) {
+  constexpr std::array<unsigned, 13> terminal{0x10, 0x76, 0xd3, 0xdb, 0xdd,
+                                              0xe3, 0xe4, 0xeb, 0xec, 0xed,
+                                              0xf4, 0xfc, 0xfd};
+  return std::find(terminal.begin(), terminal.end(), opcode) != terminal.end();
+}
+
+// Decides whether a drawn byte goes into the program or is drawn again
+using Accept = std::function<bool(unsigned value, std::mt19937 &random)>;
+
+inline bool any_byte(unsigned /* value */, std::mt19937 & /* random */) {
+  return true;
+}
+
+inline bool not_terminal(unsigned value, std::mt19937 & /* random */) {
+  return !is_terminal(value);
+}
+
+template <class CPUType> struct Machines {
+  FakeMemoryBus *reference_memory;
+  FakeMemoryBus *memory;
+  greenboy::FetchExecuteCPU reference;
+  CPUType cpu;
+
+  template <class Make>
+  Machines(std::unique_ptr<FakeMemoryBus> reference_bus,
+           std::unique_ptr<FakeMemoryBus> bus, Make make)
+      : reference_memory(reference_bus.get()), memory(bus.get()),
+        reference(std::move(reference_bus),
+                  std::make_unique<greenboy::TableOpcodeTranslator>()),
+        cpu(make(std::move(bus))) {}
+
+  void set_registers(const greenboy::CPU::RegisterSet &registers) {
+    reference.registers() = registers;
+    cpu.registers() = registers;
+  }
+};
+
+inline greenboy::CPU::RegisterSet random_registers(std::mt19937 &random) {
+  using greenboy::byte;
+  using greenboy::word;
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  greenboy::CPU::RegisterSet registers{};
+  registers.pc = static_cast<word>(bytes(random) << 8u | bytes(random));
+  registers.sp = static_cast<word>(bytes(random) << 8u | bytes(random));
+  registers.a = static_cast<byte>(bytes(random));
+  registers.b = static_cast<byte>(bytes(random));
+  registers.c = static_cast<byte>(bytes(random));
+  registers.d = static_cast<byte>(bytes(random));
+  registers.e = static_cast<byte>(bytes(random));
+  registers.h = static_cast<byte>(bytes(random));
+  registers.l = static_cast<byte>(bytes(random));
+  registers.f = greenboy::CPU::Flags{static_cast<byte>(bytes(random))};
+  return registers;
+}
+
+// Fills all 64 KiB of both memories with the same random bytes and sets
+// both cores to the same random registers. make creates the core under test
+// from its memory.
+template <class CPUType, class Make>
+std::unique_ptr<Machines<CPUType>>
+random_machines(std::mt19937 &random, Make make,
+                const Accept &accept = any_byte) {
+  auto reference_memory = std::make_unique<FakeMemoryBus>();
+  auto memory = std::make_unique<FakeMemoryBus>();
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  for (auto address = 0u; address < 0x10000u; ++address) {
+    auto value = bytes(random);
+    while (!accept(value, random)) {
+      value = bytes(random);
+    }
+    const auto at = static_cast<greenboy::word>(address);
+    reference_memory->write(at, static_cast<greenboy::byte>(value));
+    memory->write(at, static_cast<greenboy::byte>(value));
+  }
+  auto machines = std::make_unique<Machines<CPUType>>(
+      std::move(reference_memory), std::move(memory), make);
+  machines->set_registers(random_registers(random));
+  return machines;
+}
+
+template <class CPUType>
+void expect_same_state(const Machines<CPUType> &machines) {
+  const auto &expected = machines.reference.registers();
+  const auto &actual = machines.cpu.registers();
+  EXPECT_EQ(expected, actual);
+  EXPECT_EQ(expected.pc, actual.pc);
+  EXPECT_EQ(expected.sp, actual.sp);
+  EXPECT_EQ(expected.interrupts_enabled, actual.interrupts_enabled);
+  EXPECT_EQ(expected.halted, actual.halted);
+  for (auto address = 0u; address < 0x10000u; ++address) {
+    const auto at = static_cast<greenboy::word>(address);
+    ASSERT_EQ(machines.reference_memory->read(at), machines.memory->read(at))
+        << "address " << address;
+  }
+}
+
+// Runs the core under test for the budget and the reference until it has
+// spent as many cycles, then compares both. A program which writes an
+// illegal opcode into its own path has to stop there on both.
+template <class CPUType>
+void expect_same_run(Machines<CPUType> &machines, greenboy::cycles budget) {
+  greenboy::cycles elapsed{};
+  try {
+    elapsed = machines.cpu.run(budget);
+  } catch (const std::runtime_error &) {
+    greenboy::cycles spent{};
+    EXPECT_THROW(
+        while (spent <= budget) { spent += machines.reference.update(); },
+        std::runtime_error);
+    expect_same_state(machines);
+    return;
+  }
+  greenboy::cycles expected{};
+  while (expected < elapsed) {
+    expected += machines.reference.update();
+  }
+  EXPECT_EQ(expected, elapsed);
+  expect_same_state(machines);
+}
+} // namespace differential
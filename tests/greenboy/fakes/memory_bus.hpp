@@ -0,0 +1,19 @@
+#pragma once
+
+#include <array>
+
+#include "greenboy/memory_bus.hpp"
+
+class FakeMemoryBus : public greenboy::MemoryBus {
+  std::array<greenboy::byte, 0x10000> m_data{};
+
+public:
+  greenboy::byte read(greenboy::word address) const override {
+    return m_data[address];
+  }
+  void write(greenboy::word address, greenboy::byte value) override {
+    m_data[address] = value;
+  }
+
+  greenboy::byte *data() noexcept { return m_data.data(); }
+};
@@ -0,0 +1,157 @@
+#include "greenboy/fusing_opcode_translator.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+#include "greenboy/fetch_execute_cpu.hpp"
+#include "greenboy/table_opcode_translator.hpp"
+#include "mocks/instruction.hpp"
+#include "mocks/opcode_translator.hpp"
+
+namespace {
+using namespace greenboy;
+using ::testing::ReturnRef;
+using Idiom = FusingOpcodeTranslator::Idiom;
+
+constexpr word program_start = 0xc100;
+
+struct Machines {
+  FakeMemoryBus *reference_memory;
+  FakeMemoryBus *memory;
+  FetchExecuteCPU reference;
+  FusingOpcodeTranslator *translator;
+  FetchExecuteCPU cpu;
+};
+
+std::unique_ptr<Machines> make_machines(const std::vector<unsigned> &program,
+                                        std::mt19937 &random) {
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  auto reference_memory = std::make_unique<FakeMemoryBus>();
+  auto memory = std::make_unique<FakeMemoryBus>();
+  for (auto address = 0xc000u; address < 0xc100u; ++address) {
+    const auto value = static_cast<byte>(bytes(random));
+    reference_memory->write(static_cast<word>(address), value);
+    memory->write(static_cast<word>(address), value);
+  }
+  for (std::size_t i = 0; i < program.size(); ++i) {
+    const auto address = static_cast<word>(program_start + i);
+    reference_memory->write(address, static_cast<byte>(program[i]));
+    memory->write(address, static_cast<byte>(program[i]));
+  }
+  const auto port = static_cast<byte>(bytes(random));
+  reference_memory->write(0xff44, port);
+  memory->write(0xff44, port);
+
+  auto translator = std::make_unique<FusingOpcodeTranslator>(
+      std::make_unique<TableOpcodeTranslator>());
+  auto *translator_pointer = translator.get();
+  auto *reference_memory_pointer = reference_memory.get();
+  auto *memory_pointer = memory.get();
+  auto machines = std::unique_ptr<Machines>(new Machines{
+      reference_memory_pointer, memory_pointer,
+      FetchExecuteCPU{std::move(reference_memory),
+                      std::make_unique<TableOpcodeTranslator>()},
+      translator_pointer,
+      FetchExecuteCPU{std::move(memory), std::move(translator)}});
+
+  CPU::RegisterSet registers{};
+  registers.pc = program_start;
+  registers.a = static_cast<byte>(bytes(random));
+  registers.b = static_cast<byte>(bytes(random) & 3u);
+  registers.c = static_cast<byte>(bytes(random));
+  registers.d = byte{0xc0};
+  registers.e = static_cast<byte>(bytes(random) & 0x7fu);
+  registers.h = byte{0xc0};
+  registers.l = static_cast<byte>(bytes(random) & 0x7fu);
+  registers.f = CPU::Flags{static_cast<byte>(bytes(random))};
+  machines->reference.registers() = registers;
+  machines->cpu.registers() = registers;
+  return machines;
+}
+
+// Runs one superinstruction and the same instructions one at a time
+void expect_same_as_unfused(const std::vector<unsigned> &program) {
+  std::mt19937 random{0x0010};
+  for (auto repetition = 0; repetition < 32; ++repetition) {
+    auto machines = make_machines(program, random);
+    const auto elapsed = machines->cpu.update();
+    cycles expected{};
+    while (expected < elapsed) {
+      expected += machines->reference.update();
+    }
+
+    const auto &actual = machines->cpu.registers();
+    const auto &reference = machines->reference.registers();
+    EXPECT_EQ(expected, elapsed);
+    EXPECT_EQ(reference, actual);
+    EXPECT_EQ(reference.pc, actual.pc);
+    for (auto address = 0xc000u; address < 0xc200u; ++address) {
+      EXPECT_EQ(machines->reference_memory->read(static_cast<word>(address)),
+                machines->memory->read(static_cast<word>(address)));
+    }
+  }
+}
+
+TEST(FusingOpcodeTranslator, CopyingABlockMatchesTheUnfusedInstructions) {
+  expect_same_as_unfused({0x2a, 0x12, 0x13});
+  expect_same_as_unfused({0x2a, 0x12, 0x00});
+  expect_same_as_unfused({0x2a, 0x00});
+}
+
+TEST(FusingOpcodeTranslator, CountingLoopsMatchTheUnfusedInstructions) {
+  expect_same_as_unfused({0x05, 0x20, 0xfd});
+  expect_same_as_unfused({0x0d, 0x20, 0x10});
+  expect_same_as_unfused({0x3d, 0x20, 0x80});
+  expect_same_as_unfused({0x05, 0x28, 0x10});
+}
+
+TEST(FusingOpcodeTranslator, ComparisonsMatchTheUnfusedInstructions) {
+  for (const auto jump : {0x20u, 0x28u, 0x30u, 0x38u}) {
+    expect_same_as_unfused({0xfe, 0x80, jump, 0xfc});
+  }
+  expect_same_as_unfused({0xfe, 0x80, 0x00});
+}
+
+TEST(FusingOpcodeTranslator, PollingLoopsMatchTheUnfusedInstructions) {
+  for (const auto jump : {0x20u, 0x28u, 0x30u, 0x38u}) {
+    expect_same_as_unfused({0xf0, 0x44, 0xfe, 0x80, jump, 0xfa});
+  }
+  expect_same_as_unfused({0xf0, 0x44, 0xfe, 0x80, 0x00});
+  expect_same_as_unfused({0xf0, 0x44, 0x00});
+}
+
+TEST(FusingOpcodeTranslator, CountsTheIdiomsExecutedInFull) {
+  std::mt19937 random{0x0010};
+  auto machines = make_machines({0x2a, 0x12, 0x13, 0x2a, 0x12, 0x00, 0x2a,
+                                 0x00, 0xfe, 0x00, 0x28, 0x00},
+                                random);
+  for (auto i = 0; i < 6; ++i) {
+    machines->cpu.update();
+  }
+
+  EXPECT_EQ(machines->translator->hits(Idiom::CopyByteAndAdvance), 1);
+  EXPECT_EQ(machines->translator->hits(Idiom::CopyByte), 1);
+  EXPECT_EQ(machines->translator->hits(Idiom::CompareAndBranch), 1);
+  EXPECT_EQ(machines->translator->hits(Idiom::DecrementAndBranch), 0);
+  EXPECT_EQ(machines->translator->hits(Idiom::PollAndBranch), 0);
+
+  machines->translator->reset_hits();
+
+  EXPECT_EQ(machines->translator->hits(Idiom::CopyByte), 0);
+}
+
+TEST(FusingOpcodeTranslator, OtherOpcodesAreTranslatedByTheDecoratedOne) {
+  auto translator = std::make_unique<MockOpcodeTranslator>();
+  MockInstruction instruction;
+  EXPECT_CALL(*translator, translate(byte{0x00}))
+      .WillOnce(ReturnRef(instruction));
+  EXPECT_CALL(*translator, translate(byte{0x2a})).Times(0);
+
+  FusingOpcodeTranslator fusing{std::move(translator)};
+
+  EXPECT_EQ(&fusing.translate(byte{0x00}), &instruction);
+  EXPECT_NE(&fusing.translate(byte{0x2a}), &instruction);
+}
+} // namespace
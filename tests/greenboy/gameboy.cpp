@@ -1,8 +1,19 @@
 #include "greenboy/gameboy.hpp"
+#include "fakes/memory_bus.hpp"
 #include "mocks/cpu.hpp"
 #include "mocks/video.hpp"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "greenboy/fifo_ppu.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+#include "greenboy/scanline_ppu.hpp"
+#include "greenboy/tracing_memory_bus.hpp"
+
 namespace {
 using namespace greenboy;
 using ::testing::Return;
@@ -33,4 +44,299 @@ TEST(GameboyStep, CallsVideoAdvance) {
   gameboy.step();
   gameboy.step();
 }
+
+TEST(GameboyConstruction, SelectsTheCPUCore) {
+  for (auto core : {CPUCore::FetchExecute, CPUCore::Switch}) {
+    auto video = std::make_unique<MockVideo>();
+    EXPECT_CALL(*video, advance(cycles{4}));
+
+    Gameboy gameboy{core, std::make_unique<FakeMemoryBus>(), std::move(video)};
+
+    gameboy.step();
+  }
+}
+
+TEST(GameboyConstruction, BlockBasedCoresStepAWholeBlock) {
+  std::vector<CPUCore> cores{CPUCore::BlockCache};
+#ifdef GREENBOY_JIT
+  cores.push_back(CPUCore::Jit);
+#endif
+  for (auto core : cores) {
+    auto memory = std::make_unique<FakeMemoryBus>();
+    memory->write(0x0001, byte{0x76});
+    auto video = std::make_unique<MockVideo>();
+    EXPECT_CALL(*video, advance(cycles{8}));
+
+    Gameboy gameboy{core, std::move(memory), std::move(video)};
+
+    gameboy.step();
+  }
+}
+
+template <class Type> bool is(Video &video) {
+  return dynamic_cast<Type *>(&video) != nullptr;
+}
+
+TEST(GameboyConstruction, SelectsTheVideoAccuracy) {
+  for (auto accuracy : {VideoAccuracy::PixelFifo, VideoAccuracy::Scanline,
+                        VideoAccuracy::TimingOnly}) {
+    // A ROM full of NOPs
+    std::vector<byte> nops(0x8000);
+    auto memory = std::make_unique<PageTableMemoryBus>();
+    memory->map(0x0000, nops.size(), nops.data());
+    auto &bus = *memory;
+
+    Gameboy gameboy{CPUCore::Switch, accuracy, std::move(memory)};
+    auto &video = gameboy.video();
+    auto &ppu = dynamic_cast<Ppu &>(video);
+    while (ppu.frames() == 0) {
+      gameboy.step();
+    }
+
+    EXPECT_EQ(is<FifoPpu>(video), accuracy == VideoAccuracy::PixelFifo);
+    EXPECT_EQ(is<ScanlinePpu>(video), accuracy == VideoAccuracy::Scanline);
+    EXPECT_EQ(is<TimingPpu>(video), accuracy == VideoAccuracy::TimingOnly);
+    EXPECT_EQ(bus.read(Interrupts::requested_address) & Interrupts::vblank,
+              Interrupts::vblank);
+    EXPECT_EQ(bus.read(0xff44), byte{144});
+  }
+}
+
+TEST(GameboyTrace, StampsTheAccessesOfEachStepWithItsTimeAndInstruction) {
+  trace::RingBuffer buffer{16};
+  auto fake = std::make_unique<FakeMemoryBus>();
+  // LD A,0x12; LD (0xc000),A
+  const std::array<byte, 5> program{byte{0x3e}, byte{0x12}, byte{0xea},
+                                    byte{0x00}, byte{0xc0}};
+  std::copy(program.begin(), program.end(), fake->data());
+  auto memory = std::make_unique<TracingMemoryBus>(std::move(fake), buffer);
+  auto &tracing = *memory;
+  Gameboy gameboy{CPUCore::FetchExecute, std::move(memory),
+                  std::make_unique<::testing::NiceMock<MockVideo>>()};
+  gameboy.trace(tracing);
+
+  gameboy.step();
+  gameboy.step();
+
+  std::array<trace::Record, 16> records{};
+  ASSERT_EQ(buffer.pop(records.data(), records.size()), 6);
+  EXPECT_EQ(records[1].address, 0x0001);
+  EXPECT_EQ(records[1].cycle, 0);
+  EXPECT_EQ(records[1].pc, 0x0000);
+  EXPECT_EQ(records[5].address, 0xc000);
+  EXPECT_EQ(records[5].access, trace::Access::Write);
+  EXPECT_EQ(records[5].cycle, 8);
+  EXPECT_EQ(records[5].pc, 0x0002);
+}
+
+// A Gameboy running program from 0x0000 with work RAM counting up from 0
+// and handler at the VBlank interrupt vector, in CGB mode if cgb is set
+struct Machine {
+  std::vector<byte> rom = std::vector<byte>(0x8000);
+  std::vector<byte> wram = std::vector<byte>(0x2000);
+  PageTableMemoryBus *bus;
+  std::unique_ptr<Gameboy> gameboy;
+
+  explicit Machine(std::initializer_list<unsigned> program,
+                   std::initializer_list<unsigned> handler = {},
+                   CPUCore core = CPUCore::Switch, bool cgb = false) {
+    const auto to_byte = [](unsigned value) {
+      return static_cast<byte>(value);
+    };
+    std::transform(program.begin(), program.end(), rom.begin(), to_byte);
+    std::transform(handler.begin(), handler.end(), rom.begin() + 0x40,
+                   to_byte);
+    rom[0x143] = cgb ? byte{0x80} : byte{0x00};
+    for (std::size_t i = 0; i < wram.size(); ++i) {
+      wram[i] = static_cast<byte>(i);
+    }
+    auto memory = std::make_unique<PageTableMemoryBus>();
+    memory->map(0x0000, rom.size(), rom.data());
+    memory->map(0xc000, wram.size(), wram.data());
+    bus = memory.get();
+    gameboy = std::make_unique<Gameboy>(core, VideoAccuracy::TimingOnly,
+                                        std::move(memory));
+  }
+
+  // Steps end at the VBlank interrupt, so the one of the last frame is
+  // requested but not taken yet
+  void run_frames(std::uint64_t frames) {
+    auto &ppu = dynamic_cast<Ppu &>(gameboy->video());
+    while (ppu.frames() < frames) {
+      gameboy->step();
+    }
+  }
+};
+
+std::vector<CPUCore> all_cores() {
+  std::vector<CPUCore> cores{CPUCore::FetchExecute, CPUCore::Switch,
+                             CPUCore::BlockCache};
+#ifdef GREENBOY_JIT
+  cores.push_back(CPUCore::Jit);
+#endif
+  return cores;
+}
+
+TEST(GameboyDma, OnlyHighRAMIsReachableForTheLengthOfATransfer) {
+  // LD A,0xc1; JP 0xff80
+  Machine machine{0x3e, 0xc1, 0xc3, 0x80, 0xff};
+  // Reads ROM 624 cycles into the transfer and again 28 cycles later
+  const std::array<unsigned, 19> routine{
+      0xe0, 0x46,       // LDH (0x46),A
+      0x3e, 0x26,       // LD A,0x26
+      0x3d,             // DEC A
+      0x20, 0xfd,       // JR NZ,-3
+      0xfa, 0x00, 0x00, // LD A,(0x0000)
+      0xe0, 0xa0,       // LDH (0xa0),A
+      0xfa, 0x00, 0x00, // LD A,(0x0000)
+      0xe0, 0xa1,       // LDH (0xa1),A
+      0x18, 0xfe        // JR -2
+  };
+  for (std::size_t i = 0; i < routine.size(); ++i) {
+    machine.bus->write(static_cast<word>(0xff80 + i),
+                       static_cast<byte>(routine[i]));
+  }
+
+  for (auto i = 0; i < 3; ++i) {
+    machine.gameboy->step();
+  }
+
+  EXPECT_EQ(machine.bus->read(0xffa0), byte{0xff});
+  EXPECT_EQ(machine.bus->read(0xffa1), byte{0x3e});
+  EXPECT_EQ(machine.bus->read(0xfe01), byte{0x01});
+}
+
+TEST(GameboyDma, GeneralPurposeTransfersStallTheCPU) {
+  // Copy 0x80 blocks from 0xc000 to 0x8000, then loop forever
+  Machine machine{{
+                      0x3e, 0xc0, // LD A,0xc0
+                      0xe0, 0x51, // LDH (0x51),A
+                      0xaf,       // XOR A
+                      0xe0, 0x52, // LDH (0x52),A
+                      0xe0, 0x53, // LDH (0x53),A
+                      0xe0, 0x54, // LDH (0x54),A
+                      0x3e, 0x7f, // LD A,0x7f
+                      0xe0, 0x55, // LDH (0x55),A
+                      0xf0, 0x44, // LDH A,(0x44)
+                      0xe0, 0x80, // LDH (0x80),A
+                      0x18, 0xfe  // JR -2
+                  },
+                  {},
+                  CPUCore::Switch,
+                  true};
+  for (auto i = 0; i < 3; ++i) {
+    machine.gameboy->step();
+  }
+
+  auto &ppu = dynamic_cast<Ppu &>(machine.gameboy->video());
+  EXPECT_EQ(ppu.vram()[0x7ff], byte{0xff});
+  // 80 cycles of instructions and 0x80 blocks of 32 cycles each
+  EXPECT_EQ(machine.bus->read(0xff80), byte{(80 + 0x80 * 32) / 456});
+}
+
+TEST(GameboyTiming, RegistersReadInTheMiddleOfAStepAreCurrent) {
+  for (auto core : all_cores()) {
+    Machine machine{{
+                        0x06, 0x80, // LD B,0x80
+                        0x05,       // DEC B
+                        0x20, 0xfd, // JR NZ,-3
+                        0xf0, 0x44, // LDH A,(0x44)
+                        0xe0, 0x80, // LDH (0x80),A
+                        0x18, 0xfe  // JR -2
+                    },
+                    {},
+                    core};
+
+    machine.gameboy->step();
+
+    // 8 cycles and 0x80 loops of 16 cycles, less 4 for the last
+    EXPECT_EQ(machine.bus->read(0xff80), byte{(8 + 0x80 * 16 - 4) / 456});
+  }
+}
+
+TEST(GameboyInterrupts, VBlankRunsTheHandlerAndEndsTheHalt) {
+  for (auto core : all_cores()) {
+    Machine machine{{
+                        0x31, 0xfe, 0xff, // LD SP,0xfffe
+                        0x3e, 0x01,       // LD A,0x01
+                        0xe0, 0xff,       // LDH (0xff),A
+                        0xfb,             // EI
+                        0x76,             // HALT
+                        0xf0, 0x81,       // LDH A,(0x81)
+                        0x3c,             // INC A
+                        0xe0, 0x81,       // LDH (0x81),A
+                        0x18, 0xf8        // JR -8
+                    },
+                    {
+                        0xf0, 0x80, // LDH A,(0x80)
+                        0x3c,       // INC A
+                        0xe0, 0x80, // LDH (0x80),A
+                        0xd9        // RETI
+                    },
+                    core};
+
+    machine.run_frames(4);
+
+    EXPECT_EQ(machine.bus->read(0xff80), byte{3});
+    EXPECT_EQ(machine.bus->read(0xff81), byte{3});
+    EXPECT_EQ(machine.bus->read(Interrupts::requested_address) &
+                  Interrupts::vblank,
+              Interrupts::vblank);
+  }
+}
+
+TEST(GameboyInterrupts, HaltEndsWithInterruptsDisabled) {
+  for (auto core : all_cores()) {
+    Machine machine{{
+                        0x31, 0xfe, 0xff, // LD SP,0xfffe
+                        0x3e, 0x01,       // LD A,0x01
+                        0xe0, 0xff,       // LDH (0xff),A
+                        0xf3,             // DI
+                        0x76,             // HALT
+                        0xaf,             // XOR A
+                        0xe0, 0x0f,       // LDH (0x0f),A
+                        0xf0, 0x81,       // LDH A,(0x81)
+                        0x3c,             // INC A
+                        0xe0, 0x81,       // LDH (0x81),A
+                        0x18, 0xf5        // JR -11
+                    },
+                    {
+                        0xe0, 0x80, // LDH (0x80),A
+                        0xd9        // RETI
+                    },
+                    core};
+
+    machine.run_frames(4);
+
+    EXPECT_EQ(machine.bus->read(0xff80), byte{0});
+    EXPECT_EQ(machine.bus->read(0xff81), byte{3});
+  }
+}
+
+TEST(GameboyInterrupts, EnablingTakesEffectAfterTheNextInstruction) {
+  for (auto core : all_cores()) {
+    Machine machine{{
+                        0x31, 0xfe, 0xff, // LD SP,0xfffe
+                        0x3e, 0x01,       // LD A,0x01
+                        0xe0, 0xff,       // LDH (0xff),A
+                        0xe0, 0x0f,       // LDH (0x0f),A
+                        0xfb,             // EI
+                        0x3e, 0x42,       // LD A,0x42
+                        0x18, 0xfe        // JR -2
+                    },
+                    {
+                        0xe0, 0x80, // LDH (0x80),A
+                        0x18, 0xfe  // JR -2
+                    },
+                    core};
+
+    for (auto i = 0; i < 16; ++i) {
+      machine.gameboy->step();
+    }
+
+    EXPECT_EQ(machine.bus->read(0xff80), byte{0x42});
+    // PC was pushed after the LD
+    EXPECT_EQ(machine.bus->read(0xfffc), byte{0x0c});
+  }
+}
 } // namespace
@@ -6,6 +6,8 @@
 
 #include "greenboy/instructions/byte_arithmetic_operation.hpp"
 #include "greenboy/instructions/byte_load.hpp"
+#include "greenboy/instructions/jump.hpp"
+#include "greenboy/instructions/return.hpp"
 #include "greenboy/instructions/word_load.hpp"
 
 namespace {
@@ -63,6 +65,29 @@ TEST(ByteArithmeticOperation,
   EXPECT_EQ(times_called, 1);
 }
 
+TEST(StaticByteArithmeticOperation, MatchesTheRuntimeOperation) {
+  auto source = std::make_shared<MockByteAccess>();
+  auto destination = std::make_shared<MockByteAccess>();
+  CPU::RegisterSet registers{};
+  MockMemoryBus memory;
+
+  EXPECT_CALL(*source, read(_, _)).WillOnce(Return(byte{0x0f}));
+  EXPECT_CALL(*source, access_time()).WillOnce(Return(cycles{4}));
+  EXPECT_CALL(*destination, read(_, _)).WillOnce(Return(byte{0x81}));
+  EXPECT_CALL(*destination, write(_, _, byte{0x90}));
+  EXPECT_CALL(*destination, access_time()).WillOnce(Return(cycles{0}));
+
+  const auto time =
+      StaticByteArithmeticOperation<operations::add>{destination, source}
+          .execute(registers, memory);
+
+  EXPECT_EQ(time, cycles{4});
+  EXPECT_FALSE(registers.f.zero);
+  EXPECT_FALSE(registers.f.negate);
+  EXPECT_TRUE(registers.f.half_carry);
+  EXPECT_FALSE(registers.f.carry);
+}
+
 TEST(ByteArithmeticOperation, OperationAdd) {
   byte lhs{0x00};
   byte rhs{0x00};
@@ -195,4 +220,137 @@ TEST(ByteArithmeticOperation, OperationDecrement) {
   EXPECT_FALSE(f.half_carry);
   EXPECT_FALSE(f.carry);
 }
-} // namespace
\ No newline at end of file
+TEST(Jump, UntakenJumpsStillConsumeTheTarget) {
+  auto target = std::make_shared<MockWordAccess>();
+  CPU::RegisterSet registers{};
+  registers.f.zero = true;
+  MockMemoryBus memory;
+
+  EXPECT_CALL(*target, read(_, _)).WillOnce(Return(word{0x2480}));
+  EXPECT_CALL(*target, access_time()).WillRepeatedly(Return(cycles{8}));
+
+  auto time_passed =
+      Jump{target, Condition::NotZero}.execute(registers, memory);
+
+  EXPECT_EQ(registers.pc, word{0x0000});
+  EXPECT_EQ(time_passed, cycles{8});
+}
+
+TEST(Jump, TakenJumpsAssignTheProgramCounter) {
+  auto target = std::make_shared<MockWordAccess>();
+  CPU::RegisterSet registers{};
+  MockMemoryBus memory;
+
+  EXPECT_CALL(*target, read(_, _)).WillOnce(Return(word{0x2480}));
+  EXPECT_CALL(*target, access_time()).WillRepeatedly(Return(cycles{8}));
+
+  auto time_passed =
+      Jump{target, Condition::NotZero}.execute(registers, memory);
+
+  EXPECT_EQ(registers.pc, word{0x2480});
+  EXPECT_EQ(time_passed, cycles{12});
+}
+
+TEST(Return, ReturnFromInterruptEnablesInterrupts) {
+  CPU::RegisterSet registers{};
+  registers.sp = word{0xfffc};
+  MockMemoryBus memory;
+
+  EXPECT_CALL(memory, read(word{0xfffc})).WillOnce(Return(byte{0x34}));
+  EXPECT_CALL(memory, read(word{0xfffd})).WillOnce(Return(byte{0x12}));
+
+  auto time_passed =
+      instructions::Return{Condition::Always, true}.execute(registers, memory);
+
+  EXPECT_EQ(registers.pc, word{0x1234});
+  EXPECT_EQ(registers.sp, word{0xfffe});
+  EXPECT_TRUE(registers.interrupts_enabled);
+  EXPECT_EQ(time_passed, cycles{12});
+}
+
+TEST(ByteArithmeticOperation, OperationRotateLeft) {
+  byte lhs{0x80};
+  byte rhs{0x00};
+  CPU::Flags f{};
+
+  auto result = operations::rotate_left(lhs, rhs, f);
+
+  EXPECT_EQ(result, byte{0x00});
+  EXPECT_TRUE(f.zero);
+  EXPECT_FALSE(f.negate);
+  EXPECT_FALSE(f.half_carry);
+  EXPECT_TRUE(f.carry);
+}
+TEST(ByteArithmeticOperation, OperationRotateLeftAccumulator) {
+  byte lhs{0x80};
+  byte rhs{0x00};
+  CPU::Flags f{};
+
+  auto result = operations::rotate_left_accumulator(lhs, rhs, f);
+
+  EXPECT_EQ(result, byte{0x00});
+  EXPECT_FALSE(f.zero);
+  EXPECT_TRUE(f.carry);
+}
+TEST(ByteArithmeticOperation, OperationShiftRightArithmetic) {
+  byte lhs{0x81};
+  byte rhs{0x00};
+  CPU::Flags f{};
+
+  auto result = operations::shift_right_arithmetic(lhs, rhs, f);
+
+  EXPECT_EQ(result, byte{0xc0});
+  EXPECT_FALSE(f.zero);
+  EXPECT_TRUE(f.carry);
+}
+TEST(ByteArithmeticOperation, OperationSwap) {
+  byte lhs{0x12};
+  byte rhs{0x00};
+  CPU::Flags f{};
+  f.carry = true;
+
+  auto result = operations::swap(lhs, rhs, f);
+
+  EXPECT_EQ(result, byte{0x21});
+  EXPECT_FALSE(f.zero);
+  EXPECT_FALSE(f.carry);
+}
+TEST(ByteArithmeticOperation, OperationDecimalAdjustAfterAddition) {
+  byte lhs{0x0f};
+  byte rhs{0x00};
+  CPU::Flags f{};
+
+  auto result = operations::decimal_adjust(lhs, rhs, f);
+
+  EXPECT_EQ(result, byte{0x15});
+  EXPECT_FALSE(f.zero);
+  EXPECT_FALSE(f.half_carry);
+  EXPECT_FALSE(f.carry);
+}
+TEST(ByteArithmeticOperation, OperationDecimalAdjustAfterSubtraction) {
+  byte lhs{0xfa};
+  byte rhs{0x00};
+  CPU::Flags f{};
+  f.negate = true;
+  f.half_carry = true;
+  f.carry = true;
+
+  auto result = operations::decimal_adjust(lhs, rhs, f);
+
+  EXPECT_EQ(result, byte{0x94});
+  EXPECT_TRUE(f.negate);
+  EXPECT_FALSE(f.half_carry);
+  EXPECT_TRUE(f.carry);
+}
+TEST(ByteArithmeticOperation, OperationComplementCarry) {
+  byte lhs{0x12};
+  byte rhs{0x00};
+  CPU::Flags f{};
+  f.carry = true;
+
+  auto result = operations::complement_carry(lhs, rhs, f);
+
+  EXPECT_EQ(result, byte{0x12});
+  EXPECT_FALSE(f.carry);
+}
+} // namespace
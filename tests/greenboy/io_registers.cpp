@@ -0,0 +1,173 @@
+#include "greenboy/io_registers.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "greenboy/interrupts.hpp"
+#include "greenboy/lcd_registers.hpp"
+
+namespace {
+using namespace greenboy;
+
+class Counter {
+  unsigned m_writes = 0;
+  byte m_value{};
+
+public:
+  byte read(word /* address */) const { return m_value; }
+  void write(word /* address */, byte value) {
+    m_value = value;
+    ++m_writes;
+  }
+  [[nodiscard]] unsigned writes() const { return m_writes; }
+};
+
+TEST(IoRegisters, UnconnectedRegistersAreOpenBus) {
+  PageTableMemoryBus bus;
+  IoRegisters::install(bus);
+
+  bus.write(0xff01, byte{0x12});
+  bus.write(0xffff, byte{0x12});
+
+  EXPECT_EQ(bus.read(0xff01), byte{0xff});
+  EXPECT_EQ(bus.read(0xff7f), byte{0xff});
+  EXPECT_EQ(bus.read(0xffff), byte{0xff});
+}
+
+TEST(IoRegisters, HighRAMIsPlainMemory) {
+  PageTableMemoryBus bus;
+  IoRegisters::install(bus);
+
+  bus.write(0xff80, byte{0x12});
+  bus.write_word(0xfffd, word{0x3456});
+
+  EXPECT_EQ(bus.read(0xff80), byte{0x12});
+  EXPECT_EQ(bus.read_word(0xfffd), word{0x3456});
+}
+
+TEST(IoRegisters, AccessesAreDispatchedToTheConnectedComponent) {
+  PageTableMemoryBus bus;
+  auto &io = IoRegisters::install(bus);
+  Counter counter;
+  io.connect<&Counter::read, &Counter::write>(0xff05, counter);
+
+  bus.write(0xff05, byte{0x42});
+
+  EXPECT_EQ(bus.read(0xff05), byte{0x42});
+  EXPECT_EQ(counter.writes(), 1);
+  io.disconnect(0xff05);
+  EXPECT_EQ(bus.read(0xff05), byte{0xff});
+}
+
+TEST(IoRegisters, BoundRegistersAreReadAndWrittenInPlace) {
+  IoRegisters io;
+  byte value{0x10};
+  io.bind(0xffff, value);
+
+  io.write(0xffff, byte{0x1f});
+
+  EXPECT_EQ(value, byte{0x1f});
+  EXPECT_EQ(io.read(0xffff), byte{0x1f});
+}
+
+TEST(IoRegisters, RejectsInvalidConnections) {
+  IoRegisters io;
+  byte value{};
+
+  EXPECT_THROW(io.bind(0xfeff, value), std::runtime_error);
+  EXPECT_THROW(io.bind(0xff80, value), std::runtime_error);
+  EXPECT_THROW(io.disconnect(0xfffe), std::runtime_error);
+  EXPECT_THROW(io.connect(0xff00, nullptr, nullptr, nullptr),
+               std::runtime_error);
+}
+
+TEST(IoRegisters, TrackedWritesStillReachTheRegisters) {
+  PageTableMemoryBus bus;
+  auto &io = IoRegisters::install(bus);
+  Counter counter;
+  io.connect<&Counter::read, &Counter::write>(0xff05, counter);
+  bus.track_writes(0xff00, PageTableMemoryBus::page_size);
+
+  bus.write(0xff05, byte{0x42});
+  bus.write(0xff90, byte{0x43});
+
+  EXPECT_EQ(counter.writes(), 1);
+  EXPECT_EQ(bus.read(0xff90), byte{0x43});
+  EXPECT_TRUE(bus.dirty(0xff00, 0x40));
+  EXPECT_TRUE(bus.dirty(0xff80, 0x40));
+  bus.untrack_writes(0xff00, PageTableMemoryBus::page_size);
+  bus.clear_dirty();
+  bus.write(0xff05, byte{0x44});
+  EXPECT_EQ(counter.writes(), 2);
+  EXPECT_FALSE(bus.dirty(0xff00, 0x40));
+}
+
+TEST(IoRegisters, RemappingThePageDisconnectsThem) {
+  PageTableMemoryBus bus;
+  IoRegisters::install(bus);
+  bus.write(0xff90, byte{0x43});
+  std::vector<byte> memory(PageTableMemoryBus::page_size);
+
+  bus.map(0xff00, memory.size(), memory.data());
+  bus.write(0xff91, byte{0x44});
+
+  EXPECT_EQ(bus.read(0xff90), byte{0x00});
+  EXPECT_EQ(memory[0x91], byte{0x44});
+}
+
+TEST(LcdRegisters, AreConnectedToTheirAddresses) {
+  PageTableMemoryBus bus;
+  auto &io = IoRegisters::install(bus);
+  LcdRegisters lcd;
+  lcd.connect(io);
+
+  bus.write(LcdRegisters::scx_address, byte{0x21});
+  bus.write(LcdRegisters::bgp_address, byte{0xe4});
+  lcd.ly = byte{0x90};
+
+  EXPECT_EQ(lcd.scx, byte{0x21});
+  EXPECT_EQ(lcd.bgp, byte{0xe4});
+  EXPECT_EQ(bus.read(LcdRegisters::ly_address), byte{0x90});
+  EXPECT_EQ(bus.read(LcdRegisters::lcdc_address), byte{0x91});
+}
+
+TEST(LcdRegisters, OnlyTheInterruptSelectionOfSTATIsWritable) {
+  IoRegisters io;
+  LcdRegisters lcd;
+  lcd.connect(io);
+  lcd.stat = byte{0x03};
+
+  io.write(LcdRegisters::stat_address, byte{0xff});
+  io.write(LcdRegisters::ly_address, byte{0x12});
+
+  EXPECT_EQ(lcd.stat, byte{0x7b});
+  EXPECT_EQ(io.read(LcdRegisters::stat_address), byte{0xfb});
+  EXPECT_EQ(lcd.ly, byte{0x00});
+}
+
+TEST(Interrupts, RequestsReadBackWithTheUnusedBitsSet) {
+  PageTableMemoryBus bus;
+  auto &io = IoRegisters::install(bus);
+  Interrupts interrupts;
+  interrupts.connect(io);
+
+  interrupts.request(Interrupts::vblank);
+  interrupts.request(Interrupts::timer);
+  bus.write(Interrupts::enabled_address, byte{0x1f});
+
+  EXPECT_EQ(bus.read(Interrupts::requested_address), byte{0xe5});
+  EXPECT_EQ(interrupts.enabled, byte{0x1f});
+}
+
+TEST(Interrupts, WritesReplaceTheRequests) {
+  IoRegisters io;
+  Interrupts interrupts;
+  interrupts.connect(io);
+  interrupts.request(Interrupts::stat);
+
+  io.write(Interrupts::requested_address, byte{0xe1});
+
+  EXPECT_EQ(interrupts.requested, Interrupts::vblank);
+}
+} // namespace
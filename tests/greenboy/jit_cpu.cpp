@@ -0,0 +1,265 @@
+#include "greenboy/jit_cpu.hpp"
+#include "fakes/differential.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "greenboy/fetch_execute_cpu.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+#include "greenboy/table_opcode_translator.hpp"
+
+namespace {
+using namespace greenboy;
+
+bool is_translated(unsigned opcode) {
+  const auto z = opcode & 7u;
+  if (opcode >= 0x40 && opcode < 0xc0) {
+    return opcode != 0x76;
+  }
+  if (opcode < 0x40 && (z == 2 || z == 4 || z == 5 || z == 6)) {
+    return true;
+  }
+  constexpr std::array<unsigned, 24> others{
+      0x00, 0x03, 0x13, 0x23, 0x0b, 0x1b, 0x2b, 0x2f, 0x37, 0x3f, 0xc6, 0xce,
+      0xd6, 0xde, 0xe6, 0xee, 0xf6, 0xfe, 0xe0, 0xf0, 0xe2, 0xf2, 0xea, 0xfa};
+  return std::find(others.begin(), others.end(), opcode) != others.end();
+}
+
+CPU::RegisterSet random_registers(std::mt19937 &random) {
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  CPU::RegisterSet registers{};
+  registers.pc = static_cast<word>(0xc000 | bytes(random));
+  registers.sp = static_cast<word>(bytes(random) << 8u | bytes(random));
+  registers.a = static_cast<byte>(bytes(random));
+  registers.b = static_cast<byte>(bytes(random));
+  registers.c = static_cast<byte>(bytes(random));
+  registers.d = static_cast<byte>(bytes(random));
+  registers.e = static_cast<byte>(bytes(random));
+  registers.h = static_cast<byte>(bytes(random));
+  registers.l = static_cast<byte>(bytes(random));
+  registers.f = CPU::Flags{static_cast<byte>(bytes(random))};
+  return registers;
+}
+
+void expect_same_registers(const CPU::RegisterSet &expected,
+                           const CPU::RegisterSet &actual) {
+  EXPECT_EQ(expected, actual);
+  EXPECT_EQ(expected.pc, actual.pc);
+  EXPECT_EQ(expected.sp, actual.sp);
+  EXPECT_EQ(expected.halted, actual.halted);
+}
+
+// The whole address space mapped in place, the upper half tracked so that
+// its writes go through a handler
+std::unique_ptr<PageTableMemoryBus> page_table_over(byte *memory) {
+  auto bus = std::make_unique<PageTableMemoryBus>();
+  bus->map(0x0000, 0x10000, memory);
+  bus->track_writes(0x8000, 0x8000);
+  return bus;
+}
+
+TEST(JitCPU, EveryTranslatedOpcodeMatchesTheFetchExecuteCPU) {
+  std::mt19937 random{0x0817};
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  for (auto opcode = 0u; opcode < 256u; ++opcode) {
+    if (!is_translated(opcode)) {
+      continue;
+    }
+    for (auto repetition = 0; repetition < 16; ++repetition) {
+      auto registers = random_registers(random);
+      // Keeps the pointers off the program
+      for (auto *high : {&registers.b, &registers.d, &registers.h}) {
+        if (*high == byte{0xc0}) {
+          *high = byte{0xd0};
+        }
+      }
+      const auto has_operand =
+          (opcode & 0xc7u) == 0xc6 || (opcode < 0x40 && (opcode & 7u) == 6) ||
+          opcode == 0xe0 || opcode == 0xf0 || opcode == 0xea ||
+          opcode == 0xfa;
+      const auto operand =
+          has_operand ? static_cast<byte>(bytes(random)) : byte{0x76};
+      auto reference_memory = std::make_unique<FakeMemoryBus>();
+      auto *const written = reference_memory.get();
+      auto fake = std::make_unique<FakeMemoryBus>();
+      auto in_place = std::make_unique<FakeMemoryBus>();
+      for (auto *bus : {written, fake.get(), in_place.get()}) {
+        bus->write(registers.pc, static_cast<byte>(opcode));
+        bus->write(static_cast<word>(registers.pc + 1), operand);
+        bus->write(static_cast<word>(registers.pc + 2), byte{0x76});
+        bus->write(static_cast<word>(registers.pc + 3), byte{0x76});
+      }
+      FetchExecuteCPU reference{std::move(reference_memory),
+                                std::make_unique<TableOpcodeTranslator>()};
+      reference.registers() = registers;
+      auto expected = cycles{};
+      while (!reference.registers().halted) {
+        expected += reference.update();
+      }
+
+      SCOPED_TRACE(opcode);
+      // Once calling out for every access, once in place
+      std::vector<std::unique_ptr<MemoryBus>> memories;
+      memories.push_back(std::move(fake));
+      memories.push_back(page_table_over(in_place->data()));
+      for (auto &memory : memories) {
+        auto *const bus = memory.get();
+        JitCPU cpu{std::move(memory), 1};
+        cpu.registers() = registers;
+
+        const auto time = cpu.update();
+
+        EXPECT_EQ(cpu.translations(), 1u);
+        EXPECT_EQ(time, expected);
+        expect_same_registers(reference.registers(), cpu.registers());
+        // Everywhere the instruction may have written to
+        const auto low = to_integer<unsigned>(operand);
+        const std::array<unsigned, 6> addresses{
+            to_word(registers.b, registers.c),
+            to_word(registers.d, registers.e),
+            to_word(registers.h, registers.l),
+            0xff00u | to_integer<unsigned>(registers.c), 0xff00u | low,
+            0x7600u | low};
+        for (const auto address : addresses) {
+          const auto at = static_cast<word>(address);
+          EXPECT_EQ(bus->read(at), written->read(at)) << address;
+        }
+      }
+    }
+  }
+}
+
+TEST(JitCPU, HotBlocksAreTranslatedOnce) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  // LD B,0x40; loop: INC A; DEC B; JR NZ,loop; HALT
+  const std::array<unsigned, 7> program{0x06, 0x40, 0x3c, 0x05,
+                                        0x20, 0xfc, 0x76};
+  for (auto i = 0u; i < program.size(); ++i) {
+    memory->write(static_cast<word>(i), static_cast<byte>(program[i]));
+  }
+  JitCPU cpu{std::move(memory), 4};
+
+  cpu.run(cycles{10000});
+
+  EXPECT_EQ(cpu.registers().a, byte{0x40});
+  EXPECT_EQ(cpu.registers().b, byte{0x00});
+  EXPECT_TRUE(cpu.registers().halted);
+  EXPECT_EQ(cpu.translations(), 1u);
+}
+
+TEST(JitCPU, WritesDropTranslatedBlocks) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  auto *bus = memory.get();
+  bus->write(0xc000, byte{0x3c});
+  bus->write(0xc001, byte{0x76});
+  JitCPU cpu{std::move(memory), 1};
+  cpu.registers().pc = 0xc000;
+  cpu.update();
+
+  bus->write(0xc000, byte{0x3d});
+  cpu.invalidate(0xc000);
+  cpu.registers().pc = 0xc000;
+  cpu.registers().halted = false;
+  cpu.update();
+
+  EXPECT_EQ(cpu.registers().a, byte{0x00});
+  EXPECT_EQ(cpu.translations(), 2u);
+}
+
+TEST(JitCPU, WritesToTheBlockBeingRunStopItsNativeCode) {
+  std::vector<byte> ram(0x1000);
+  // LD HL,0xc007; LD (HL),0x3c; NOP; NOP; NOP; HALT, where the LD (HL)
+  // turns the last NOP into INC A
+  const std::array<unsigned, 9> program{0x21, 0x07, 0xc0, 0x36, 0x3c,
+                                        0x00, 0x00, 0x00, 0x76};
+  for (auto i = 0u; i < program.size(); ++i) {
+    ram[i] = static_cast<byte>(program[i]);
+  }
+  auto memory = std::make_unique<PageTableMemoryBus>();
+  memory->map(0xc000, ram.size(), ram.data());
+  JitCPU cpu{std::move(memory), 1};
+  cpu.registers().pc = 0xc000;
+
+  cpu.run(cycles{100});
+
+  EXPECT_EQ(cpu.registers().a, byte{0x01});
+  EXPECT_TRUE(cpu.registers().halted);
+}
+
+TEST(JitCPU, WritesToPagesWithoutMemoryGoThroughTheBus) {
+  std::vector<byte> ram(0x2000);
+  // LD HL,0xd010; LD (HL+),A; LD (HL),A; HALT
+  const std::array<unsigned, 6> program{0x21, 0x10, 0xd0, 0x22, 0x77, 0x76};
+  for (auto i = 0u; i < program.size(); ++i) {
+    ram[i] = static_cast<byte>(program[i]);
+  }
+  auto memory = std::make_unique<PageTableMemoryBus>();
+  auto *bus = memory.get();
+  bus->map(0xc000, ram.size(), ram.data());
+  bus->track_writes(0xd000, 0x100);
+  JitCPU cpu{std::move(memory), 1};
+  cpu.registers().pc = 0xc000;
+  cpu.registers().a = byte{0x5a};
+
+  cpu.run(cycles{100});
+
+  EXPECT_EQ(ram[0x1010], byte{0x5a});
+  EXPECT_EQ(ram[0x1011], byte{0x5a});
+  EXPECT_TRUE(bus->dirty(0xd000, 0x40));
+  EXPECT_EQ(cpu.translations(), 1u);
+}
+
+TEST(JitCPU, RandomProgramsMatchTheFetchExecuteCPU) {
+  std::mt19937 random{0x817};
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  // Favours the translated instructions so the native code gets exercised
+  const auto mostly_translated = [&bytes](unsigned value,
+                                          std::mt19937 &generator) {
+    return !differential::is_terminal(value) &&
+           (bytes(generator) >= 0xc0 || is_translated(value));
+  };
+  for (auto program = 0; program < 16; ++program) {
+    const auto block_size = 1 + static_cast<unsigned>(program % 3);
+    auto machines = differential::random_machines<JitCPU>(
+        random,
+        [block_size](std::unique_ptr<FakeMemoryBus> memory) {
+          return JitCPU{std::move(memory), block_size};
+        },
+        mostly_translated);
+    machines->set_registers(random_registers(random));
+
+    differential::expect_same_run(*machines, cycles{20000});
+  }
+}
+
+TEST(JitCPU, RandomProgramsInPlaceMatchTheFetchExecuteCPU) {
+  std::mt19937 random{0x0818};
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  const auto mostly_translated = [&bytes](unsigned value,
+                                          std::mt19937 &generator) {
+    return !differential::is_terminal(value) &&
+           (bytes(generator) >= 0xc0 || is_translated(value));
+  };
+  for (auto program = 0; program < 16; ++program) {
+    const auto block_size = 1 + static_cast<unsigned>(program % 3);
+    // The memory the page tables point into, compared as the fake it is
+    std::vector<std::unique_ptr<FakeMemoryBus>> in_place;
+    auto machines = differential::random_machines<JitCPU>(
+        random,
+        [block_size, &in_place](std::unique_ptr<FakeMemoryBus> memory) {
+          auto *const data = memory->data();
+          in_place.push_back(std::move(memory));
+          return JitCPU{page_table_over(data), block_size};
+        },
+        mostly_translated);
+    machines->set_registers(random_registers(random));
+
+    differential::expect_same_run(*machines, cycles{20000});
+  }
+}
+} // namespace
@@ -0,0 +1,90 @@
+#include "greenboy/lazy_flags.hpp"
+#include "gtest/gtest.h"
+
+#include "greenboy/instructions/byte_arithmetic_operation.hpp"
+
+namespace {
+using namespace greenboy;
+using Kind = LazyFlags::Operation;
+using Eager = byte (*)(const byte, const byte, CPU::Flags &) noexcept;
+namespace operations = instructions::operations;
+
+void expect_same_flags(const CPU::Flags &expected, const LazyFlags &actual) {
+  const auto flags = actual.get();
+  ASSERT_EQ(static_cast<byte>(expected), static_cast<byte>(flags));
+  ASSERT_EQ(expected.zero, actual.zero());
+  ASSERT_EQ(expected.carry, actual.carry());
+}
+
+void expect_bit_exact(Kind kind, Eager eager) {
+  for (auto initial = 0u; initial < 0x100u; initial += 0x10u) {
+    const CPU::Flags flags{static_cast<byte>(initial)};
+    for (auto lhs = 0u; lhs < 0x100u; ++lhs) {
+      for (auto rhs = 0u; rhs < 0x100u; ++rhs) {
+        auto expected = flags;
+        const auto result =
+            eager(static_cast<byte>(lhs), static_cast<byte>(rhs), expected);
+
+        LazyFlags actual{flags};
+        ASSERT_EQ(result, actual.record(kind, static_cast<byte>(lhs),
+                                        static_cast<byte>(rhs)));
+        expect_same_flags(expected, actual);
+      }
+    }
+  }
+}
+
+TEST(LazyFlags, AddIsBitExact) {
+  expect_bit_exact(Kind::Add, operations::add);
+}
+
+TEST(LazyFlags, AddWithCarryIsBitExact) {
+  expect_bit_exact(Kind::AddWithCarry, operations::add_with_carry);
+}
+
+TEST(LazyFlags, SubtractIsBitExact) {
+  expect_bit_exact(Kind::Subtract, operations::subtract);
+}
+
+TEST(LazyFlags, SubtractWithCarryIsBitExact) {
+  expect_bit_exact(Kind::SubtractWithCarry, operations::subtract_with_carry);
+}
+
+TEST(LazyFlags, BitwiseOperationsAreBitExact) {
+  expect_bit_exact(Kind::And, operations::bitwise_and);
+  expect_bit_exact(Kind::Or, operations::bitwise_or);
+  expect_bit_exact(Kind::Xor, operations::bitwise_xor);
+}
+
+TEST(LazyFlags, IncrementAndDecrementAreBitExact) {
+  expect_bit_exact(Kind::Increment, operations::increment);
+  expect_bit_exact(Kind::Decrement, operations::decrement);
+}
+
+TEST(LazyFlags, CarryIsTakenFromThePendingOperation) {
+  CPU::Flags expected{};
+  LazyFlags actual{};
+
+  operations::add(byte{0xf0}, byte{0x20}, expected);
+  actual.record(Kind::Add, byte{0xf0}, byte{0x20});
+  operations::increment(byte{0x0f}, byte{0x01}, expected);
+  actual.record(Kind::Increment, byte{0x0f}, byte{0x01});
+  expect_same_flags(expected, actual);
+
+  const auto result =
+      operations::add_with_carry(byte{0x10}, byte{0x01}, expected);
+  EXPECT_EQ(result, actual.record(Kind::AddWithCarry, byte{0x10}, byte{0x01}));
+  expect_same_flags(expected, actual);
+}
+
+TEST(LazyFlags, SetFlagsAreReturnedAsIs) {
+  LazyFlags flags{};
+  flags.record(Kind::Subtract, byte{0x00}, byte{0x01});
+
+  flags.set(CPU::Flags{byte{0xa0}});
+
+  EXPECT_EQ(static_cast<byte>(flags.get()), byte{0xa0});
+  EXPECT_TRUE(flags.zero());
+  EXPECT_FALSE(flags.carry());
+}
+} // namespace
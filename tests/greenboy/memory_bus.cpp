@@ -0,0 +1,32 @@
+#include "greenboy/memory_bus.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <array>
+
+namespace {
+using namespace greenboy;
+
+TEST(MemoryBus, BlockCopiesFallBackToSingleBytes) {
+  FakeMemoryBus memory;
+  const std::array<byte, 3> source{byte{0x01}, byte{0x02}, byte{0x03}};
+
+  memory.write_block(0xc000, source.data(), source.size());
+  std::array<byte, 3> copied{};
+  memory.read_block(0xc000, copied.data(), copied.size());
+
+  EXPECT_EQ(memory.read(0xc001), byte{0x02});
+  EXPECT_EQ(copied, source);
+}
+
+TEST(MemoryBus, BlockCopiesWrapAroundTheAddressSpace) {
+  FakeMemoryBus memory;
+  memory.write(0xffff, byte{0x12});
+  memory.write(0x0000, byte{0x34});
+
+  std::array<byte, 2> copied{};
+  memory.read_block(0xffff, copied.data(), copied.size());
+
+  EXPECT_EQ(copied, (std::array<byte, 2>{byte{0x12}, byte{0x34}}));
+}
+} // namespace
@@ -6,4 +6,5 @@
 class MockCPU : public greenboy::CPU {
 public:
   MOCK_METHOD(greenboy::cycles, update, (), (override));
+  MOCK_METHOD(greenboy::word, pc, (), (const, noexcept, override));
 };
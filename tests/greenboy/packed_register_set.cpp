@@ -0,0 +1,94 @@
+#include "greenboy/packed_register_set.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+using namespace greenboy;
+
+CPU::RegisterSet example_registers() {
+  CPU::RegisterSet registers{};
+  registers.pc = 0x0150;
+  registers.sp = 0xfffe;
+  registers.b = byte{0x01};
+  registers.c = byte{0x02};
+  registers.d = byte{0x03};
+  registers.e = byte{0x04};
+  registers.h = byte{0x05};
+  registers.l = byte{0x06};
+  registers.a = byte{0x07};
+  registers.f = CPU::Flags{byte{0xb0}};
+  registers.interrupts_enabled = true;
+  return registers;
+}
+
+TEST(PackedRegisterSet, KeepsThePairsTogether) {
+  const PackedRegisterSet registers{example_registers()};
+
+  EXPECT_EQ(registers.bc(), word{0x0102});
+  EXPECT_EQ(registers.de(), word{0x0304});
+  EXPECT_EQ(registers.hl(), word{0x0506});
+  EXPECT_EQ(registers.af(), word{0x07b0});
+  EXPECT_EQ(registers.pc, word{0x0150});
+  EXPECT_EQ(registers.sp, word{0xfffe});
+}
+
+TEST(PackedRegisterSet, UnpacksToTheSameRegisters) {
+  const auto expected = example_registers();
+
+  const auto actual = PackedRegisterSet{expected}.unpack();
+
+  EXPECT_EQ(actual, expected);
+  EXPECT_EQ(actual.pc, expected.pc);
+  EXPECT_EQ(actual.sp, expected.sp);
+  EXPECT_EQ(actual.interrupts_enabled, expected.interrupts_enabled);
+  EXPECT_EQ(actual.halted, expected.halted);
+}
+
+TEST(PackedRegisterSet, ByteWritesOnlyChangeTheirHalfOfThePair) {
+  PackedRegisterSet registers{example_registers()};
+
+  registers.set_h(byte{0xc0});
+  registers.set_c(byte{0xde});
+
+  EXPECT_EQ(registers.hl(), word{0xc006});
+  EXPECT_EQ(registers.bc(), word{0x01de});
+  EXPECT_EQ(registers.h(), byte{0xc0});
+  EXPECT_EQ(registers.l(), byte{0x06});
+}
+
+TEST(PackedRegisterSet, PairWritesAreVisibleThroughTheBytes) {
+  PackedRegisterSet registers{};
+
+  ++registers.hl();
+  registers.de() = 0xabcd;
+
+  EXPECT_EQ(registers.l(), byte{0x01});
+  EXPECT_EQ(registers.d(), byte{0xab});
+  EXPECT_EQ(registers.e(), byte{0xcd});
+}
+
+TEST(PackedRegisterSet, TheLowerNibbleOfFIsAlwaysZero) {
+  PackedRegisterSet registers{};
+
+  registers.set_af(0x12ff);
+
+  EXPECT_EQ(registers.af(), word{0x12f0});
+  EXPECT_EQ(registers.a(), byte{0x12});
+  EXPECT_TRUE(registers.f().zero);
+  EXPECT_TRUE(registers.f().negate);
+  EXPECT_TRUE(registers.f().half_carry);
+  EXPECT_TRUE(registers.f().carry);
+}
+
+TEST(PackedRegisterSet, ComparesLikeTheRegisterSet) {
+  PackedRegisterSet lhs{example_registers()};
+  PackedRegisterSet rhs{example_registers()};
+  rhs.pc = 0x0000;
+  rhs.sp = 0x0000;
+
+  EXPECT_EQ(lhs, rhs);
+
+  rhs.set_f(CPU::Flags{});
+
+  EXPECT_NE(lhs, rhs);
+}
+} // namespace
@@ -0,0 +1,370 @@
+#include "greenboy/page_table_memory_bus.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "greenboy/switch_cpu.hpp"
+
+namespace {
+using namespace greenboy;
+using ::testing::Return;
+
+class MockHandler : public PageTableMemoryBus::Handler {
+public:
+  MOCK_METHOD(byte, read, (word), (const, override));
+  MOCK_METHOD(void, write, (word, byte), (override));
+};
+
+TEST(PageTableMemoryBus, UnmappedPagesReadAsOpenBus) {
+  PageTableMemoryBus bus;
+
+  bus.write(0x1234, byte{0x00});
+
+  EXPECT_EQ(bus.read(0x0000), byte{0xff});
+  EXPECT_EQ(bus.read(0x1234), byte{0xff});
+  EXPECT_EQ(bus.read(0xffff), byte{0xff});
+}
+
+TEST(PageTableMemoryBus, MappedMemoryIsReadAndWrittenInPlace) {
+  std::vector<byte> ram(0x2000);
+  PageTableMemoryBus bus;
+  bus.map(0xc000, ram.size(), ram.data());
+
+  bus.write(0xc123, byte{0x42});
+  ram[0x1fff] = byte{0x17};
+
+  EXPECT_EQ(ram[0x0123], byte{0x42});
+  EXPECT_EQ(bus.read(0xc123), byte{0x42});
+  EXPECT_EQ(bus.read(0xdfff), byte{0x17});
+  EXPECT_EQ(bus.read(0xe000), byte{0xff});
+}
+
+TEST(PageTableMemoryBus, TheSameMemoryCanBeMappedTwice) {
+  std::vector<byte> ram(0x1000);
+  PageTableMemoryBus bus;
+  bus.map(0xc000, ram.size(), ram.data());
+  bus.map(0xe000, ram.size(), ram.data());
+
+  bus.write(0xe010, byte{0x99});
+
+  EXPECT_EQ(bus.read(0xc010), byte{0x99});
+}
+
+TEST(PageTableMemoryBus, WritesToReadOnlyMemoryGoToTheHandler) {
+  std::vector<byte> rom(0x4000, byte{0x3c});
+  auto handler = std::make_unique<MockHandler>();
+  EXPECT_CALL(*handler, write(word{0x2000}, byte{0x01}));
+  EXPECT_CALL(*handler, read(::testing::_)).Times(0);
+  PageTableMemoryBus bus;
+  const auto index = bus.add_handler(std::move(handler));
+  bus.map_read_only(0x0000, rom.size(), rom.data(), index);
+
+  bus.write(0x2000, byte{0x01});
+
+  EXPECT_EQ(bus.read(0x2000), byte{0x3c});
+  EXPECT_EQ(rom[0x2000], byte{0x3c});
+}
+
+TEST(PageTableMemoryBus, HandlerPagesDelegateEveryAccess) {
+  auto handler = std::make_unique<MockHandler>();
+  EXPECT_CALL(*handler, read(word{0xff44})).WillOnce(Return(byte{0x90}));
+  EXPECT_CALL(*handler, write(word{0xff40}, byte{0x91}));
+  PageTableMemoryBus bus;
+  const auto index = bus.add_handler(std::move(handler));
+  bus.map_handler(0xff00, PageTableMemoryBus::page_size, index);
+
+  EXPECT_EQ(bus.read(0xff44), byte{0x90});
+  bus.write(0xff40, byte{0x91});
+}
+
+TEST(PageTableMemoryBus, RemappingAPageReplacesTheMemoryBehindIt) {
+  std::array<byte, 0x100> first{};
+  std::array<byte, 0x100> second{};
+  first[0x10] = byte{0x01};
+  second[0x10] = byte{0x02};
+  PageTableMemoryBus bus;
+
+  bus.map(0x8000, first.size(), first.data());
+  EXPECT_EQ(bus.read(0x8010), byte{0x01});
+  bus.map(0x8000, second.size(), second.data());
+  EXPECT_EQ(bus.read(0x8010), byte{0x02});
+  bus.map_handler(0x8000, second.size(), PageTableMemoryBus::open_bus);
+  EXPECT_EQ(bus.read(0x8010), byte{0xff});
+}
+
+TEST(PageTableMemoryBus, RemappingTheReadsKeepsTheWrites) {
+  std::vector<byte> first(0x4000, byte{0x01});
+  std::vector<byte> second(0x4000);
+  for (std::size_t i = 0; i < second.size(); ++i) {
+    second[i] = static_cast<byte>(i >> 8u);
+  }
+  auto handler = std::make_unique<MockHandler>();
+  EXPECT_CALL(*handler, write(word{0x4000}, byte{0x02}));
+  EXPECT_CALL(*handler, write(word{0x7fff}, byte{0x03}));
+  PageTableMemoryBus bus;
+  const auto index = bus.add_handler(std::move(handler));
+  bus.map_read_only(0x4000, first.size(), first.data(), index);
+
+  bus.remap_read(0x4000, second.size(), second.data());
+  bus.write(0x4000, byte{0x02});
+  bus.write(0x7fff, byte{0x03});
+
+  for (std::size_t page = 0; page < 0x40; ++page) {
+    const auto address = static_cast<word>(0x4000 + page * 0x100 + 0x80);
+    EXPECT_EQ(bus.read(address), static_cast<byte>(page));
+  }
+  // An odd number of pages
+  bus.remap_read(0x4000, 0x300, first.data());
+  EXPECT_EQ(bus.read(0x4280), byte{0x01});
+  EXPECT_EQ(bus.read(0x4380), byte{0x03});
+}
+
+TEST(PageTableMemoryBus, RejectsInvalidMappings) {
+  std::vector<byte> ram(0x200);
+  PageTableMemoryBus bus;
+
+  EXPECT_THROW(bus.map(0xc080, 0x100, ram.data()), std::runtime_error);
+  EXPECT_THROW(bus.map(0xc000, 0x180, ram.data()), std::runtime_error);
+  EXPECT_THROW(bus.map(0xff00, 0x200, ram.data()), std::runtime_error);
+  EXPECT_THROW(bus.map_handler(0xc000, 0x100, 1), std::runtime_error);
+  EXPECT_THROW(bus.map_read_only(0x0000, 0x100, ram.data(), 7),
+               std::runtime_error);
+  EXPECT_THROW(bus.add_handler(nullptr), std::runtime_error);
+  EXPECT_THROW(static_cast<void>(bus.handler(3)), std::runtime_error);
+}
+
+TEST(PageTableMemoryBus, BlockCopiesSpanMemoryAndHandlerPages) {
+  std::vector<byte> ram(0x200);
+  auto handler = std::make_unique<MockHandler>();
+  EXPECT_CALL(*handler, read(::testing::_)).WillRepeatedly(Return(byte{0x11}));
+  EXPECT_CALL(*handler, write(word{0xc200}, byte{0x03}));
+  PageTableMemoryBus bus;
+  const auto index = bus.add_handler(std::move(handler));
+  bus.map(0xc000, ram.size(), ram.data());
+  bus.map_handler(0xc200, PageTableMemoryBus::page_size, index);
+
+  const std::array<byte, 4> source{byte{0x00}, byte{0x01}, byte{0x02},
+                                   byte{0x03}};
+  bus.write_block(0xc1fd, source.data(), source.size());
+  std::array<byte, 4> copied{};
+  bus.read_block(0xc1fd, copied.data(), copied.size());
+
+  EXPECT_EQ(ram[0x1fd], byte{0x00});
+  EXPECT_EQ(ram[0x1ff], byte{0x02});
+  EXPECT_EQ(copied,
+            (std::array<byte, 4>{byte{0x00}, byte{0x01}, byte{0x02},
+                                 byte{0x11}}));
+}
+
+TEST(PageTableMemoryBus, BlockCopiesWrapAroundTheAddressSpace) {
+  std::vector<byte> high(0x100);
+  std::vector<byte> low(0x100);
+  PageTableMemoryBus bus;
+  bus.map(0xff00, high.size(), high.data());
+  bus.map(0x0000, low.size(), low.data());
+
+  const std::array<byte, 2> source{byte{0xaa}, byte{0xbb}};
+  bus.write_block(0xffff, source.data(), source.size());
+
+  EXPECT_EQ(high[0xff], byte{0xaa});
+  EXPECT_EQ(low[0x00], byte{0xbb});
+}
+
+TEST(PageTableMemoryBus, WordAccessesAreLittleEndian) {
+  std::vector<byte> ram(0x100);
+  PageTableMemoryBus bus;
+  bus.map(0xc000, ram.size(), ram.data());
+
+  bus.write_word(0xc010, word{0x1234});
+
+  EXPECT_EQ(ram[0x10], byte{0x34});
+  EXPECT_EQ(ram[0x11], byte{0x12});
+  EXPECT_EQ(bus.read_word(0xc010), word{0x1234});
+}
+
+TEST(PageTableMemoryBus, WordAccessesCrossPagesAndReachHandlers) {
+  std::vector<byte> ram(0x100);
+  auto handler = std::make_unique<MockHandler>();
+  EXPECT_CALL(*handler, read(word{0xc100})).WillOnce(Return(byte{0x56}));
+  EXPECT_CALL(*handler, write(word{0xc100}, byte{0x78}));
+  PageTableMemoryBus bus;
+  const auto index = bus.add_handler(std::move(handler));
+  bus.map(0xc000, ram.size(), ram.data());
+  bus.map_handler(0xc100, PageTableMemoryBus::page_size, index);
+  ram[0xff] = byte{0x34};
+
+  EXPECT_EQ(bus.read_word(0xc0ff), word{0x5634});
+  bus.write_word(0xc0ff, word{0x789a});
+  EXPECT_EQ(ram[0xff], byte{0x9a});
+}
+
+TEST(PageTableMemoryBus, WordAccessesWrapAroundTheAddressSpace) {
+  std::vector<byte> high(0x100);
+  std::vector<byte> low(0x100);
+  PageTableMemoryBus bus;
+  bus.map(0xff00, high.size(), high.data());
+  bus.map(0x0000, low.size(), low.data());
+
+  bus.write_word(0xffff, word{0xbbaa});
+
+  EXPECT_EQ(high[0xff], byte{0xaa});
+  EXPECT_EQ(low[0x00], byte{0xbb});
+}
+
+TEST(PageTableMemoryBus, NothingIsDirtyUntilPagesAreTracked) {
+  std::vector<byte> ram(0x2000);
+  PageTableMemoryBus bus;
+  bus.map(0xc000, ram.size(), ram.data());
+
+  bus.write(0xc000, byte{0x01});
+
+  EXPECT_TRUE(bus.dirty_map().none());
+}
+
+TEST(PageTableMemoryBus, WritesToTrackedPagesMarkTheirBlockDirty) {
+  std::vector<byte> ram(0x2000);
+  PageTableMemoryBus bus;
+  bus.map(0xc000, ram.size(), ram.data());
+  bus.track_writes(0xc000, ram.size());
+
+  bus.write(0xc041, byte{0x01});
+  bus.write_word(0xc0ff, word{0x0302});
+  const std::array<byte, 2> block{byte{0x04}, byte{0x05}};
+  bus.write_block(0xd000, block.data(), block.size());
+
+  EXPECT_EQ(ram[0x41], byte{0x01});
+  EXPECT_EQ(ram[0x100], byte{0x03});
+  EXPECT_EQ(bus.read(0xd001), byte{0x05});
+  EXPECT_EQ(bus.dirty_map().count(), 4);
+  EXPECT_TRUE(bus.dirty(0xc040, PageTableMemoryBus::dirty_block_size));
+  EXPECT_FALSE(bus.dirty(0xc000, PageTableMemoryBus::dirty_block_size));
+  EXPECT_TRUE(bus.dirty(0xc000, 0x100));
+}
+
+TEST(PageTableMemoryBus, ClearingAndUntrackingStopsRecording) {
+  std::vector<byte> ram(0x100);
+  PageTableMemoryBus bus;
+  bus.map(0xc000, ram.size(), ram.data());
+  bus.track_writes(0xc000, ram.size());
+  bus.write(0xc000, byte{0x01});
+  bus.write(0xc080, byte{0x01});
+
+  bus.clear_dirty(0xc000, PageTableMemoryBus::dirty_block_size);
+  EXPECT_FALSE(bus.dirty(0xc000, 1));
+  EXPECT_TRUE(bus.dirty(0xc080, 1));
+  bus.clear_dirty();
+  bus.untrack_writes(0xc000, ram.size());
+  bus.write(0xc000, byte{0x02});
+
+  EXPECT_TRUE(bus.dirty_map().none());
+  EXPECT_EQ(ram[0], byte{0x02});
+  EXPECT_THROW(bus.clear_dirty(0xc001, 1), std::runtime_error);
+}
+
+TEST(PageTableMemoryBus, TrackingSurvivesRemappingAndCoversHandlers) {
+  std::vector<byte> first(0x100);
+  std::vector<byte> second(0x100);
+  auto handler = std::make_unique<MockHandler>();
+  EXPECT_CALL(*handler, write(word{0xff80}, byte{0x07}));
+  PageTableMemoryBus bus;
+  const auto index = bus.add_handler(std::move(handler));
+  bus.map(0xa000, first.size(), first.data());
+  bus.map_handler(0xff00, PageTableMemoryBus::page_size, index);
+  bus.track_writes(0xa000, 0x100);
+  bus.track_writes(0xff00, 0x100);
+
+  bus.map(0xa000, second.size(), second.data());
+  bus.write(0xa010, byte{0x06});
+  bus.write(0xff80, byte{0x07});
+
+  EXPECT_EQ(second[0x10], byte{0x06});
+  EXPECT_EQ(first[0x10], byte{0x00});
+  EXPECT_TRUE(bus.dirty(0xa000, 0x40));
+  EXPECT_TRUE(bus.dirty(0xff80, 0x40));
+}
+
+TEST(PageTableMemoryBus, WritesAroundTheBusAreMarkedOnTrackedPagesOnly) {
+  PageTableMemoryBus bus;
+  bus.track_writes(0xc000, 0x100);
+
+  bus.mark_written(0xc0f0, 0x20);
+
+  EXPECT_TRUE(bus.dirty(0xc0c0, 0x40));
+  EXPECT_FALSE(bus.dirty(0xc000, 0xc0));
+  EXPECT_FALSE(bus.dirty(0xc100, 0x40));
+}
+
+TEST(PageTableMemoryBus, LockingOutLeavesOnlyTheLastPage) {
+  std::vector<byte> ram(0x100);
+  std::vector<byte> high(0x100);
+  PageTableMemoryBus bus;
+  bus.map(0xc000, ram.size(), ram.data());
+  bus.map(0xff00, high.size(), high.data());
+
+  bus.lock_out();
+  bus.write(0xc010, byte{0x01});
+  bus.write(0xff80, byte{0x02});
+
+  EXPECT_TRUE(bus.locked_out());
+  EXPECT_EQ(bus.read(0xc010), byte{0xff});
+  EXPECT_EQ(ram[0x10], byte{0x00});
+  EXPECT_EQ(bus.read(0xff80), byte{0x02});
+}
+
+TEST(PageTableMemoryBus, MappingsMadeWhileLockedOutTakeEffectOnUnlocking) {
+  std::vector<byte> first(0x100);
+  std::vector<byte> second(0x100, byte{0x22});
+  PageTableMemoryBus bus;
+  bus.map(0xc000, first.size(), first.data());
+
+  bus.lock_out();
+  bus.map(0xc000, second.size(), second.data());
+  EXPECT_EQ(bus.read(0xc000), byte{0xff});
+  bus.unlock();
+
+  EXPECT_FALSE(bus.locked_out());
+  EXPECT_EQ(bus.read(0xc000), byte{0x22});
+}
+
+TEST(PageTableMemoryBus, TheSwitchCPUGivesTheSameResultsOnEitherBus) {
+  std::mt19937 random{0x0011};
+  std::uniform_int_distribution<unsigned> bytes(0, 0xff);
+  std::vector<byte> ram(0x10000);
+  auto reference_memory = std::make_unique<FakeMemoryBus>();
+  for (auto address = 0u; address < 0x10000u; ++address) {
+    auto value = bytes(random);
+    // Keep the program running instead of halting or hitting illegal opcodes
+    if (value == 0x10 || value == 0x76 || value == 0xd3 || value == 0xdb ||
+        value == 0xdd || value == 0xe3 || value == 0xe4 || value == 0xeb ||
+        value == 0xec || value == 0xed || value == 0xf4 || value == 0xfc ||
+        value == 0xfd) {
+      value = 0x00;
+    }
+    ram[address] = static_cast<byte>(value);
+    reference_memory->write(static_cast<word>(address), ram[address]);
+  }
+  auto bus = std::make_unique<PageTableMemoryBus>();
+  bus->map(0x0000, ram.size(), ram.data());
+  const auto *reference_bus = reference_memory.get();
+  SwitchCPU reference{std::move(reference_memory)};
+  SwitchCPU cpu{std::move(bus)};
+  reference.registers().pc = 0x0100;
+  cpu.registers().pc = 0x0100;
+
+  reference.run(cycles{20000});
+  cpu.run(cycles{20000});
+
+  EXPECT_EQ(reference.registers(), cpu.registers());
+  EXPECT_EQ(reference.registers().pc, cpu.registers().pc);
+  EXPECT_EQ(reference.registers().sp, cpu.registers().sp);
+  for (auto address = 0u; address < 0x10000u; ++address) {
+    ASSERT_EQ(reference_bus->read(static_cast<word>(address)), ram[address])
+        << address;
+  }
+}
+} // namespace
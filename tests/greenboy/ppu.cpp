@@ -0,0 +1,603 @@
+#include "greenboy/ppu.hpp"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "greenboy/fifo_ppu.hpp"
+#include "greenboy/interrupts.hpp"
+#include "greenboy/io_registers.hpp"
+#include "greenboy/page_table_memory_bus.hpp"
+#include "greenboy/scanline_ppu.hpp"
+
+namespace {
+using namespace greenboy;
+using Mode = Ppu::Mode;
+
+template <class Type> struct Machine {
+  PageTableMemoryBus bus;
+  IoRegisters &io = IoRegisters::install(bus);
+  Interrupts interrupts;
+  Type ppu{bus, io, interrupts};
+
+  Machine() { interrupts.connect(io); }
+
+  [[nodiscard]] byte pixel(std::size_t x, std::size_t y) {
+    return ppu.frame()[y * Video::screen_width + x];
+  }
+};
+
+// Fills a tile with a single colour
+template <class Type> class PpuTiming : public testing::Test {
+protected:
+  using System = Machine<Type>;
+};
+using Tiers = testing::Types<FifoPpu, ScanlinePpu, TimingPpu>;
+TYPED_TEST_SUITE(PpuTiming, Tiers);
+
+template <class Type> class PpuDrawing : public testing::Test {
+protected:
+  using System = Machine<Type>;
+};
+using DrawingTiers = testing::Types<FifoPpu, ScanlinePpu>;
+TYPED_TEST_SUITE(PpuDrawing, DrawingTiers);
+
+void fill_tile(MemoryBus &bus, word address, unsigned colour) {
+  for (unsigned row = 0; row < 8; ++row) {
+    const auto row_address = static_cast<word>(address + row * 2);
+    bus.write(row_address, (colour & 1u) != 0 ? byte{0xff} : byte{0x00});
+    bus.write(static_cast<word>(row_address + 1),
+              (colour & 2u) != 0 ? byte{0xff} : byte{0x00});
+  }
+}
+
+TYPED_TEST(PpuTiming, VisibleLinesGoThroughModesTwoThreeAndZero) {
+  typename TestFixture::System system;
+
+  EXPECT_EQ(system.ppu.mode(), Mode::OamScan);
+  system.ppu.advance(Ppu::oam_scan_time - cycles{4});
+  EXPECT_EQ(system.ppu.mode(), Mode::OamScan);
+  system.ppu.advance(cycles{4});
+  EXPECT_EQ(system.ppu.mode(), Mode::Transfer);
+  system.ppu.advance(Ppu::transfer_time);
+  EXPECT_EQ(system.ppu.mode(), Mode::HBlank);
+  EXPECT_EQ(system.bus.read(LcdRegisters::stat_address), byte{0x84});
+  system.ppu.advance(Ppu::line_time - Ppu::oam_scan_time -
+                     Ppu::transfer_time);
+
+  EXPECT_EQ(system.ppu.mode(), Mode::OamScan);
+  EXPECT_EQ(system.bus.read(LcdRegisters::ly_address), byte{1});
+}
+
+TYPED_TEST(PpuTiming, FineScrollLengthensModeThree) {
+  typename TestFixture::System system;
+  system.bus.write(LcdRegisters::scx_address, byte{0x05});
+
+  system.ppu.advance(Ppu::oam_scan_time + Ppu::transfer_time);
+  EXPECT_EQ(system.ppu.mode(), Mode::Transfer);
+  system.ppu.advance(cycles{5});
+
+  EXPECT_EQ(system.ppu.mode(), Mode::HBlank);
+}
+
+TYPED_TEST(PpuTiming, VBlankStartsAtLineOneHundredAndFortyFour) {
+  typename TestFixture::System system;
+
+  system.ppu.advance(Ppu::line_time * 144 - cycles{4});
+  EXPECT_EQ(system.interrupts.requested, byte{0x00});
+  system.ppu.advance(cycles{4});
+
+  EXPECT_EQ(system.ppu.mode(), Mode::VBlank);
+  EXPECT_EQ(system.bus.read(LcdRegisters::ly_address), byte{144});
+  EXPECT_EQ(system.interrupts.requested, Interrupts::vblank);
+  EXPECT_EQ(system.ppu.frames(), 1);
+}
+
+TYPED_TEST(PpuTiming, AFrameTakesOneHundredAndFiftyFourLines) {
+  typename TestFixture::System system;
+
+  system.ppu.advance(Ppu::line_time * 153);
+  EXPECT_EQ(system.bus.read(LcdRegisters::ly_address), byte{153});
+  system.ppu.advance(Ppu::line_time);
+
+  EXPECT_EQ(system.bus.read(LcdRegisters::ly_address), byte{0});
+  EXPECT_EQ(system.ppu.mode(), Mode::OamScan);
+}
+
+TYPED_TEST(PpuTiming, SmallAndLargeStepsEndInTheSameState) {
+  typename TestFixture::System stepped;
+  typename TestFixture::System jumped;
+  stepped.ppu.registers().scx = byte{0x03};
+  jumped.ppu.registers().scx = byte{0x03};
+
+  for (auto i = 0; i < 70224 * 2 / 4 + 100; ++i) {
+    stepped.ppu.advance(cycles{4});
+  }
+  jumped.ppu.advance(cycles{70224 * 2 + 400});
+
+  EXPECT_EQ(stepped.ppu.mode(), jumped.ppu.mode());
+  EXPECT_EQ(stepped.ppu.registers().ly, jumped.ppu.registers().ly);
+  EXPECT_EQ(stepped.ppu.frames(), 2);
+  EXPECT_EQ(jumped.ppu.frames(), 2);
+}
+
+TYPED_TEST(PpuTiming, CatchingUpLazilyIsIndistinguishableFromEveryStep) {
+  typename TestFixture::System lazy;
+  typename TestFixture::System eager;
+  fill_tile(lazy.bus, 0x8010, 3);
+  fill_tile(eager.bus, 0x8010, 3);
+  std::mt19937 random{4321};
+  const std::array<word, 9> registers{
+      LcdRegisters::lcdc_address, LcdRegisters::stat_address,
+      LcdRegisters::scx_address,  LcdRegisters::lyc_address,
+      LcdRegisters::wy_address,   LcdRegisters::wx_address,
+      LcdRegisters::bgp_address,  0x9800,
+      0xfe00};
+
+  for (auto step = 0; step < 70224 * 3 / 8; ++step) {
+    if (random() % 128 == 0) {
+      auto address = registers[random() % registers.size()];
+      if (address == 0xfe00) {
+        address = static_cast<word>(address + random() % 0xa0u);
+      }
+      auto value = static_cast<byte>(random() & 0xffu);
+      if (address == LcdRegisters::lcdc_address) {
+        // Mostly on, so the frames get drawn
+        if (random() % 8 != 0) {
+          value |= LcdRegisters::lcd_enable | LcdRegisters::background_enable;
+        }
+      } else if (address == LcdRegisters::stat_address) {
+        // One source at a time, so they do not hide each other
+        value = static_cast<byte>(0x04u << random() % 5u & 0x78u);
+      } else if (address == LcdRegisters::lyc_address) {
+        // A few lines ahead, so LY gets there before the next write
+        const auto line = to_integer<unsigned>(
+            eager.bus.read(LcdRegisters::ly_address));
+        value = static_cast<byte>((line + random() % 8u) % Ppu::line_count);
+      }
+      lazy.bus.write(address, value);
+      eager.bus.write(address, value);
+    }
+    const cycles time{4 * static_cast<int>(1 + random() % 4)};
+    lazy.ppu.advance(time);
+    eager.ppu.advance(time);
+    eager.ppu.catch_up();
+
+    ASSERT_EQ(lazy.interrupts.requested, eager.interrupts.requested) << step;
+    if ((eager.interrupts.requested & Interrupts::vblank) != byte{0x00}) {
+      ASSERT_EQ(lazy.ppu.frame(), eager.ppu.frame()) << step;
+    }
+    lazy.interrupts.requested = byte{0x00};
+    eager.interrupts.requested = byte{0x00};
+  }
+
+  EXPECT_EQ(lazy.bus.read(LcdRegisters::ly_address),
+            eager.bus.read(LcdRegisters::ly_address));
+  EXPECT_EQ(lazy.ppu.frames(), eager.ppu.frames());
+}
+
+TYPED_TEST(PpuTiming, RaisesTheSTATInterruptWhenLYMatchesLYC) {
+  typename TestFixture::System system;
+  system.bus.write(LcdRegisters::lyc_address, byte{2});
+  system.bus.write(LcdRegisters::stat_address, byte{0x40});
+
+  system.ppu.advance(Ppu::line_time * 2 - cycles{4});
+  EXPECT_EQ(system.interrupts.requested, byte{0x00});
+  system.ppu.advance(cycles{4});
+
+  EXPECT_EQ(system.interrupts.requested, Interrupts::stat);
+  EXPECT_EQ(system.bus.read(LcdRegisters::stat_address), byte{0xc6});
+}
+
+TYPED_TEST(PpuTiming, WritingAMatchingLYCRaisesTheInterruptAtOnce) {
+  typename TestFixture::System system;
+  system.bus.write(LcdRegisters::lyc_address, byte{5});
+  system.bus.write(LcdRegisters::stat_address, byte{0x40});
+
+  system.bus.write(LcdRegisters::lyc_address, byte{0});
+
+  EXPECT_EQ(system.interrupts.requested, Interrupts::stat);
+}
+
+TYPED_TEST(PpuTiming, RaisesTheSTATInterruptOnlyWhenTheLineRises) {
+  typename TestFixture::System system;
+  // HBlank and OAM scan follow each other, so the line stays high from the
+  // start of mode 0 to the end of mode 2
+  system.bus.write(LcdRegisters::stat_address, byte{0x28});
+  system.ppu.advance(Ppu::oam_scan_time);
+  system.interrupts.requested = byte{0x00};
+
+  system.ppu.advance(Ppu::transfer_time);
+  EXPECT_EQ(system.interrupts.requested, Interrupts::stat);
+  system.interrupts.requested = byte{0x00};
+  system.ppu.advance(Ppu::line_time - Ppu::oam_scan_time -
+                     Ppu::transfer_time);
+
+  EXPECT_EQ(system.interrupts.requested, byte{0x00});
+}
+
+TYPED_TEST(PpuTiming, StandsStillWhileTheLCDIsOff) {
+  typename TestFixture::System system;
+  system.ppu.advance(Ppu::line_time * 3 + cycles{100});
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x11});
+
+  system.ppu.advance(Ppu::line_time * 3);
+  EXPECT_EQ(system.bus.read(LcdRegisters::ly_address), byte{0});
+  EXPECT_EQ(system.ppu.mode(), Mode::HBlank);
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x91});
+  system.ppu.advance(cycles{4});
+
+  EXPECT_EQ(system.ppu.mode(), Mode::OamScan);
+  EXPECT_EQ(system.bus.read(LcdRegisters::ly_address), byte{0});
+}
+
+TYPED_TEST(PpuTiming, SpritesLengthenModeThree) {
+  typename TestFixture::System system;
+  auto &oam = system.ppu.oam();
+  // Both on line 0, the first at the start of a tile and the second on the
+  // same one
+  oam[0] = byte{16};
+  oam[1] = byte{8};
+  oam[4] = byte{16};
+  oam[5] = byte{12};
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x93});
+
+  system.ppu.advance(Ppu::oam_scan_time + Ppu::transfer_time +
+                     cycles{11 + 6 - 1});
+  EXPECT_EQ(system.ppu.mode(), Mode::Transfer);
+  system.ppu.advance(cycles{1});
+
+  EXPECT_EQ(system.ppu.mode(), Mode::HBlank);
+}
+
+TYPED_TEST(PpuTiming, TheWindowLengthensModeThree) {
+  typename TestFixture::System system;
+  system.bus.write(LcdRegisters::wx_address, byte{87});
+  system.bus.write(LcdRegisters::lcdc_address, byte{0xb1});
+
+  system.ppu.advance(Ppu::oam_scan_time + Ppu::transfer_time +
+                     cycles{6 - 1});
+  EXPECT_EQ(system.ppu.mode(), Mode::Transfer);
+  system.ppu.advance(cycles{1});
+
+  EXPECT_EQ(system.ppu.mode(), Mode::HBlank);
+}
+
+TYPED_TEST(PpuTiming, VRAMAndOAMAreMappedIntoTheBus) {
+  typename TestFixture::System system;
+  system.ppu.advance(Ppu::oam_scan_time + Ppu::transfer_time);
+
+  system.bus.write(0x8010, byte{0x12});
+  system.bus.write(0xfe03, byte{0x34});
+
+  EXPECT_EQ(system.ppu.vram()[0x10], byte{0x12});
+  EXPECT_EQ(system.ppu.oam()[0x03], byte{0x34});
+}
+
+TYPED_TEST(PpuDrawing, DrawsTheScrolledBackground) {
+  typename TestFixture::System system;
+  // Tile 1 is colour 3, the tile map is tile 0 except for one tile at (1, 1)
+  fill_tile(system.bus, 0x8010, 3);
+  system.bus.write(0x9821, byte{0x01});
+  system.bus.write(LcdRegisters::bgp_address, byte{0xe4});
+  system.bus.write(LcdRegisters::scx_address, byte{0x04});
+  system.bus.write(LcdRegisters::scy_address, byte{0x02});
+
+  system.ppu.advance(Ppu::line_time * 144);
+
+  EXPECT_EQ(system.pixel(3, 6), byte{0});
+  EXPECT_EQ(system.pixel(4, 6), byte{3});
+  EXPECT_EQ(system.pixel(11, 6), byte{3});
+  EXPECT_EQ(system.pixel(12, 6), byte{0});
+  EXPECT_EQ(system.pixel(4, 5), byte{0});
+  EXPECT_EQ(system.pixel(4, 13), byte{3});
+  EXPECT_EQ(system.pixel(4, 14), byte{0});
+}
+
+TYPED_TEST(PpuDrawing, TilesWrittenBetweenFramesAreDrawnAnew) {
+  typename TestFixture::System system;
+  fill_tile(system.bus, 0x8000, 1);
+  system.bus.write(LcdRegisters::bgp_address, byte{0xe4});
+  system.ppu.advance(Ppu::line_time * 154);
+  EXPECT_EQ(system.pixel(0, 0), byte{1});
+
+  system.bus.write(0x8000, byte{0x7f});
+  system.ppu.advance(Ppu::line_time * 154);
+
+  EXPECT_EQ(system.pixel(0, 0), byte{0});
+  EXPECT_EQ(system.pixel(1, 0), byte{1});
+  EXPECT_EQ(system.pixel(0, 1), byte{1});
+}
+
+TYPED_TEST(PpuDrawing, SignedTileDataIsAddressedFromTheMiddle) {
+  typename TestFixture::System system;
+  fill_tile(system.bus, 0x8ff0, 2);
+  system.bus.write(0x9800, byte{0xff});
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x81});
+  system.bus.write(LcdRegisters::bgp_address, byte{0xe4});
+
+  system.ppu.advance(Ppu::line_time * 144);
+
+  EXPECT_EQ(system.pixel(0, 0), byte{2});
+  EXPECT_EQ(system.pixel(8, 0), byte{0});
+}
+
+TYPED_TEST(PpuDrawing, DrawsTheWindowOverTheBackground) {
+  typename TestFixture::System system;
+  fill_tile(system.bus, 0x8010, 1);
+  for (word address = 0x9c00; address < 0xa000; ++address) {
+    system.bus.write(address, byte{0x01});
+  }
+  system.bus.write(LcdRegisters::lcdc_address, byte{0xf1});
+  system.bus.write(LcdRegisters::bgp_address, byte{0xe4});
+  system.bus.write(LcdRegisters::wx_address, byte{87});
+  system.bus.write(LcdRegisters::wy_address, byte{100});
+
+  system.ppu.advance(Ppu::line_time * 144);
+
+  EXPECT_EQ(system.pixel(79, 100), byte{0});
+  EXPECT_EQ(system.pixel(80, 100), byte{1});
+  EXPECT_EQ(system.pixel(80, 99), byte{0});
+}
+
+TYPED_TEST(PpuDrawing, DrawsSpritesInFrontOfTheBackground) {
+  typename TestFixture::System system;
+  auto &oam = system.ppu.oam();
+  fill_tile(system.bus, 0x8020, 2);
+  // Sprite 0 at (10, 20) in front, sprite 1 at (14, 20) behind it
+  oam[0] = byte{36};
+  oam[1] = byte{18};
+  oam[2] = byte{0x02};
+  oam[4] = byte{36};
+  oam[5] = byte{22};
+  oam[6] = byte{0x02};
+  oam[7] = byte{0x10};
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x93});
+  system.bus.write(LcdRegisters::obp0_address, byte{0xe4});
+  system.bus.write(LcdRegisters::obp1_address, byte{0x1b});
+
+  system.ppu.advance(Ppu::line_time * 144);
+
+  EXPECT_EQ(system.pixel(9, 20), byte{0});
+  EXPECT_EQ(system.pixel(10, 20), byte{2});
+  EXPECT_EQ(system.pixel(17, 27), byte{2});
+  EXPECT_EQ(system.pixel(18, 27), byte{1});
+  EXPECT_EQ(system.pixel(21, 27), byte{1});
+  EXPECT_EQ(system.pixel(22, 27), byte{0});
+  EXPECT_EQ(system.pixel(10, 28), byte{0});
+}
+
+TYPED_TEST(PpuDrawing, DrawsAtMostTenSpritesPerLine) {
+  typename TestFixture::System system;
+  auto &oam = system.ppu.oam();
+  fill_tile(system.bus, 0x8010, 3);
+  for (std::size_t i = 0; i < 11; ++i) {
+    oam[i * 4] = byte{16};
+    oam[i * 4 + 1] = static_cast<byte>(8 + i * 8);
+    oam[i * 4 + 2] = byte{0x01};
+  }
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x93});
+  system.bus.write(LcdRegisters::obp0_address, byte{0xe4});
+
+  system.ppu.advance(Ppu::line_time * 144);
+
+  EXPECT_EQ(system.pixel(79, 0), byte{3});
+  EXPECT_EQ(system.pixel(80, 0), byte{0});
+}
+
+TYPED_TEST(PpuDrawing, SpritesBehindTheBackgroundShowOnlyOnColourZero) {
+  typename TestFixture::System system;
+  auto &oam = system.ppu.oam();
+  fill_tile(system.bus, 0x8010, 1);
+  fill_tile(system.bus, 0x8020, 3);
+  system.bus.write(0x9800, byte{0x01});
+  oam[0] = byte{16};
+  oam[1] = byte{12};
+  oam[2] = byte{0x02};
+  oam[3] = byte{0x80};
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x93});
+  system.bus.write(LcdRegisters::bgp_address, byte{0xe4});
+  system.bus.write(LcdRegisters::obp0_address, byte{0xe4});
+
+  system.ppu.advance(Ppu::line_time * 144);
+
+  EXPECT_EQ(system.pixel(7, 0), byte{1});
+  EXPECT_EQ(system.pixel(8, 0), byte{3});
+}
+
+TYPED_TEST(PpuTiming, RunsHBlankTransfersOnEnteringModeZero) {
+  typename TestFixture::System system;
+  std::vector<byte> wram(0x2000, byte{0x5a});
+  system.bus.map(0xc000, wram.size(), wram.data());
+  Dma dma{system.bus, system.io, system.ppu.oam(), Dma::Model::Cgb};
+  system.ppu.attach(dma);
+  system.bus.write(Dma::hdma1_address, byte{0xc0});
+  system.bus.write(Dma::hdma2_address, byte{0x00});
+  system.bus.write(Dma::hdma3_address, byte{0x00});
+  system.bus.write(Dma::hdma4_address, byte{0x00});
+  system.bus.write(Dma::hdma5_address, byte{0x81});
+
+  system.ppu.advance(Ppu::oam_scan_time + Ppu::transfer_time);
+
+  EXPECT_EQ(system.ppu.vram()[0x0f], byte{0x5a});
+  EXPECT_EQ(system.ppu.vram()[0x10], byte{0x00});
+}
+
+TEST(TimingPpu, NeverDraws) {
+  Machine<TimingPpu> system;
+  fill_tile(system.bus, 0x8000, 3);
+
+  system.ppu.advance(Ppu::line_time * 154);
+
+  EXPECT_EQ(system.ppu.frames(), 1);
+  EXPECT_EQ(system.pixel(0, 0), byte{0});
+}
+
+TEST(TimingPpu, WindowWritesDuringModeThreeLeaveItsLengthAlone) {
+  Machine<TimingPpu> system;
+  system.bus.write(LcdRegisters::wy_address, byte{200});
+  system.bus.write(LcdRegisters::wx_address, byte{87});
+  system.bus.write(LcdRegisters::lcdc_address, byte{0xb1});
+
+  system.ppu.advance(Ppu::line_time * 10 + cycles{100});
+  system.bus.write(LcdRegisters::wy_address, byte{0});
+  system.ppu.advance(cycles{155});
+
+  EXPECT_EQ(system.bus.read(LcdRegisters::stat_address) & byte{0x03},
+            byte{0x00});
+}
+
+TEST(TimingPpu, OAMWritesDuringModeThreeLeaveItsLengthAlone) {
+  Machine<TimingPpu> system;
+  system.bus.write(LcdRegisters::lcdc_address, byte{0x93});
+
+  system.ppu.advance(Ppu::oam_scan_time + cycles{20});
+  system.bus.write(0xfe00, byte{16});
+  system.bus.write(0xfe01, byte{8});
+  system.ppu.advance(Ppu::transfer_time - cycles{20});
+
+  EXPECT_EQ(system.bus.read(LcdRegisters::stat_address) & byte{0x03},
+            byte{0x00});
+}
+
+TEST(FifoPpu, PaletteWritesInTheMiddleOfALineChangeTheRestOfIt) {
+  Machine<FifoPpu> system;
+  fill_tile(system.bus, 0x8000, 1);
+  system.bus.write(LcdRegisters::bgp_address, byte{0x04});
+
+  // Mode 3 starts with a fetch of 12 cycles, then a pixel leaves the FIFO
+  // every cycle
+  system.ppu.advance(Ppu::oam_scan_time + cycles{12 + 80});
+  system.bus.write(LcdRegisters::bgp_address, byte{0x0c});
+  system.ppu.advance(Ppu::line_time);
+
+  EXPECT_EQ(system.pixel(79, 0), byte{1});
+  EXPECT_EQ(system.pixel(80, 0), byte{3});
+}
+
+TEST(FifoPpu, EnablingTheWindowInTheMiddleOfALineLengthensModeThree) {
+  Machine<FifoPpu> system;
+  system.bus.write(LcdRegisters::wx_address, byte{87});
+
+  system.ppu.advance(Ppu::oam_scan_time + cycles{12 + 40});
+  system.bus.write(LcdRegisters::lcdc_address, byte{0xb1});
+  system.ppu.advance(Ppu::transfer_time - cycles{12 + 40} +
+                     cycles{6 - 1});
+  EXPECT_EQ(system.ppu.mode(), Mode::Transfer);
+  system.ppu.advance(cycles{1});
+
+  EXPECT_EQ(system.ppu.mode(), Mode::HBlank);
+  EXPECT_EQ(system.pixel(79, 0), byte{0});
+}
+
+TEST(FifoPpu, LocksOAMInModesTwoAndThreeAndVRAMInModeThree) {
+  Machine<FifoPpu> system;
+  system.bus.write(0x8010, byte{0x12});
+  system.ppu.oam()[0x03] = byte{0x34};
+
+  EXPECT_EQ(system.bus.read(0x8010), byte{0x12});
+  EXPECT_EQ(system.bus.read(0xfe03), byte{0xff});
+  system.ppu.advance(Ppu::oam_scan_time);
+  EXPECT_EQ(system.bus.read(0x8010), byte{0xff});
+  EXPECT_EQ(system.bus.read(0xfe03), byte{0xff});
+  system.bus.write(0x8010, byte{0x56});
+  system.bus.write(0xfe03, byte{0x78});
+  system.ppu.advance(Ppu::transfer_time);
+
+  EXPECT_EQ(system.bus.read(0x8010), byte{0x12});
+  EXPECT_EQ(system.bus.read(0xfe03), byte{0x34});
+}
+
+TEST(FifoPpu, OAMStaysLockedWhenADmaTransferEndsInModeTwo) {
+  Machine<FifoPpu> system;
+  std::vector<byte> wram(0x2000, byte{0x5a});
+  system.bus.map(0xc000, wram.size(), wram.data());
+  Dma dma{system.bus, system.io, system.ppu.oam(), Dma::Model::Cgb};
+  system.ppu.attach(dma);
+  system.ppu.advance(Ppu::line_time - cycles{4});
+  system.bus.write(Dma::oam_dma_address, byte{0xc0});
+
+  system.ppu.advance(cycles{4});
+  dma.advance(Dma::oam_transfer_time);
+  EXPECT_EQ(system.bus.read(0xfe00), byte{0xff});
+  system.ppu.advance(Ppu::oam_scan_time + Ppu::transfer_time);
+
+  EXPECT_EQ(system.bus.read(0xfe00), byte{0x5a});
+}
+
+TEST(ScanlinePpu, PaletteWritesInTheMiddleOfALineChangeAllOfIt) {
+  Machine<ScanlinePpu> system;
+  fill_tile(system.bus, 0x8000, 1);
+  system.bus.write(LcdRegisters::bgp_address, byte{0x04});
+
+  system.ppu.advance(Ppu::oam_scan_time + cycles{12 + 80});
+  system.bus.write(LcdRegisters::bgp_address, byte{0x0c});
+  system.ppu.advance(Ppu::line_time);
+
+  EXPECT_EQ(system.pixel(0, 0), byte{3});
+  EXPECT_EQ(system.pixel(80, 0), byte{3});
+}
+
+// Writes the same random VRAM, OAM and registers to both
+void randomise(Machine<FifoPpu> &fifo, Machine<ScanlinePpu> &scanline,
+               unsigned lcdc, std::mt19937 &random) {
+  const auto random_byte = [&] {
+    return static_cast<byte>(random() & 0xffu);
+  };
+  for (word address = 0x8000; address < 0xa000; ++address) {
+    const auto value = random_byte();
+    fifo.bus.write(address, value);
+    scanline.bus.write(address, value);
+  }
+  for (std::size_t i = 0; i < 0xa0; ++i) {
+    const auto value = random_byte();
+    fifo.ppu.oam()[i] = value;
+    scanline.ppu.oam()[i] = value;
+  }
+  for (auto address :
+       {LcdRegisters::scy_address, LcdRegisters::scx_address,
+        LcdRegisters::bgp_address, LcdRegisters::obp0_address,
+        LcdRegisters::obp1_address, LcdRegisters::wy_address,
+        LcdRegisters::wx_address}) {
+    auto value = random_byte();
+    if (address == LcdRegisters::wx_address) {
+      value = static_cast<byte>(to_integer<unsigned>(value) % 167u);
+    }
+    fifo.bus.write(address, value);
+    scanline.bus.write(address, value);
+  }
+  fifo.bus.write(LcdRegisters::lcdc_address, static_cast<byte>(lcdc));
+  scanline.bus.write(LcdRegisters::lcdc_address, static_cast<byte>(lcdc));
+}
+
+TEST(FifoPpu, DrawsTheSameFramesAsTheScanlinePpuForSteadyRegisters) {
+  Machine<FifoPpu> fifo;
+  Machine<ScanlinePpu> scanline;
+  std::mt19937 random{1234};
+  for (auto lcdc : {0x93u, 0xa7u, 0xf1u, 0xe3u, 0xc5u}) {
+    randomise(fifo, scanline, lcdc, random);
+
+    fifo.ppu.advance(Ppu::line_time * 154);
+    scanline.ppu.advance(Ppu::line_time * 154);
+
+    EXPECT_EQ(fifo.ppu.frame(), scanline.ppu.frame()) << lcdc;
+  }
+}
+
+TEST(FifoPpu, EndsModeThreeWithTheScanlinePpuForSteadyRegisters) {
+  Machine<FifoPpu> fifo;
+  Machine<ScanlinePpu> scanline;
+  std::mt19937 random{5678};
+  for (auto lcdc : {0x93u, 0xa7u, 0xf3u, 0xe3u, 0xb7u}) {
+    // At the start of a frame, where VRAM is open to writes
+    randomise(fifo, scanline, lcdc, random);
+
+    for (auto dot = 0; dot < 456 * 154; ++dot) {
+      fifo.ppu.advance(cycles{1});
+      scanline.ppu.advance(cycles{1});
+      ASSERT_EQ(fifo.ppu.mode(), scanline.ppu.mode()) << lcdc << " " << dot;
+    }
+  }
+}
+} // namespace
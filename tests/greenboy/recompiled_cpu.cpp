@@ -0,0 +1,105 @@
+#include "greenboy/recompiled_cpu.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "greenboy/fetch_execute_cpu.hpp"
+#include "greenboy/table_opcode_translator.hpp"
+#include "recompiled_rom.hpp"
+
+const greenboy::recompiled::Program &recompiled_rom() noexcept;
+
+namespace {
+using namespace greenboy;
+
+std::unique_ptr<FakeMemoryBus> load_rom() {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  const auto rom = recompiled_rom_image();
+  for (std::size_t address = 0; address < rom.size(); ++address) {
+    memory->write(static_cast<word>(address), static_cast<byte>(rom[address]));
+  }
+  return memory;
+}
+
+void run_until_halted(CPU &cpu, const CPU::RegisterSet &registers) {
+  for (auto steps = 0; steps < 10000 && !registers.halted; ++steps) {
+    cpu.update();
+  }
+  ASSERT_TRUE(registers.halted);
+}
+
+void expect_same_state(const FetchExecuteCPU &expected,
+                       const FakeMemoryBus &expected_memory,
+                       const RecompiledCPU &actual,
+                       const FakeMemoryBus &actual_memory) {
+  EXPECT_EQ(expected.registers(), actual.registers());
+  EXPECT_EQ(expected.registers().pc, actual.registers().pc);
+  EXPECT_EQ(expected.registers().sp, actual.registers().sp);
+  for (word address = 0xc000; address < 0xc110; ++address) {
+    EXPECT_EQ(expected_memory.read(address), actual_memory.read(address));
+  }
+  EXPECT_EQ(expected_memory.read(0xff80), actual_memory.read(0xff80));
+}
+
+TEST(RecompiledCPU, TheRecompilerFoundTheReachableBlocks) {
+  const auto &program = recompiled_rom();
+  std::vector<word> starts;
+  for (std::size_t i = 0; i < program.size; ++i) {
+    starts.push_back(program.blocks[i].start);
+  }
+  for (const word start : {0x0000, 0x0109, 0x010e, 0x0114, 0x0200, 0x4000}) {
+    EXPECT_NE(std::find(starts.begin(), starts.end(), start), starts.end())
+        << std::hex << start;
+  }
+}
+
+TEST(RecompiledCPU, RunsTheROMLikeTheFetchExecuteCPU) {
+  auto reference_memory = load_rom();
+  auto memory = load_rom();
+  const auto &expected_memory = *reference_memory;
+  const auto &actual_memory = *memory;
+  FetchExecuteCPU reference{std::move(reference_memory),
+                            std::make_unique<TableOpcodeTranslator>()};
+  RecompiledCPU cpu{std::move(memory), recompiled_rom()};
+  reference.registers().pc = 0x0100;
+  cpu.registers().pc = 0x0100;
+
+  run_until_halted(reference, reference.registers());
+  run_until_halted(cpu, cpu.registers());
+
+  expect_same_state(reference, expected_memory, cpu, actual_memory);
+  EXPECT_EQ(cpu.registers().pc, 0xc102);
+}
+
+TEST(RecompiledCPU, InterpretsTheSwitchableBankWhenItHoldsOtherCode) {
+  auto reference_memory = load_rom();
+  auto memory = load_rom();
+  for (auto *bus : {reference_memory.get(), memory.get()}) {
+    bus->write(0x4000, byte{0x3d}); // DEC A
+  }
+  const auto &expected_memory = *reference_memory;
+  const auto &actual_memory = *memory;
+  FetchExecuteCPU reference{std::move(reference_memory),
+                            std::make_unique<TableOpcodeTranslator>()};
+  RecompiledCPU cpu{std::move(memory), recompiled_rom()};
+  reference.registers().pc = 0x0100;
+  cpu.registers().pc = 0x0100;
+
+  run_until_halted(reference, reference.registers());
+  run_until_halted(cpu, cpu.registers());
+
+  expect_same_state(reference, expected_memory, cpu, actual_memory);
+}
+
+TEST(RecompiledCPU, RunIsBoundedByTheBudget) {
+  RecompiledCPU cpu{load_rom(), recompiled_rom()};
+  cpu.registers().pc = 0x0100;
+
+  const auto elapsed = cpu.run(cycles{100});
+
+  EXPECT_GE(elapsed, cycles{100});
+  EXPECT_LT(elapsed, cycles{200});
+}
+} // namespace
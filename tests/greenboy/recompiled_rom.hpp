@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// The ROM which is run through greenboy-recompile for the RecompiledCPU
+// tests. It loops over calls into bank 0 and the switchable bank, then copies
+// a few instructions to RAM and jumps there.
+inline std::vector<std::uint8_t> recompiled_rom_image() {
+  std::vector<std::uint8_t> rom(0x4004);
+  const auto place = [&rom](std::size_t address,
+                            std::initializer_list<std::uint8_t> code) {
+    for (const auto value : code) {
+      rom[address++] = value;
+    }
+  };
+  place(0x0100, {
+                    0x31, 0xfe, 0xff, // LD SP,0xfffe
+                    0x06, 0x0a,       // LD B,10
+                    0xaf,             // XOR A
+                    0x21, 0x00, 0xc0, // LD HL,0xc000
+                    0x80,             // loop: ADD A,B
+                    0x22,             // LD (HL+),A
+                    0xcd, 0x00, 0x02, // CALL 0x0200
+                    0x05,             // DEC B
+                    0x20, 0xf8,       // JR NZ,loop
+                    0xcd, 0x00, 0x40, // CALL 0x4000
+                    0x3e, 0x3c,       // LD A,0x3c
+                    0xea, 0x00, 0xc1, // LD (0xc100),A
+                    0x3e, 0x76,       // LD A,0x76
+                    0xea, 0x01, 0xc1, // LD (0xc101),A
+                    0xc3, 0x00, 0xc1, // JP 0xc100
+                });
+  place(0x0200, {
+                    0x57,       // LD D,A
+                    0xcb, 0x22, // SLA D
+                    0xe0, 0x80, // LDH (0x80),A
+                    0xc9,       // RET
+                });
+  place(0x4000, {
+                    0x3c, // INC A
+                    0x27, // DAA
+                    0x09, // ADD HL,BC
+                    0xc9, // RET
+                });
+  return rom;
+}
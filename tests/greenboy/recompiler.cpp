@@ -0,0 +1,153 @@
+#include "greenboy/recompiler.hpp"
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+namespace {
+using namespace greenboy;
+
+// The rest of the ROM is filled with an illegal opcode, which ends a block
+// without any successors
+std::vector<byte> rom_with(std::initializer_list<unsigned> code,
+                           word address = 0x0100, std::size_t size = 0x8000) {
+  std::vector<byte> rom(size, byte{0xd3});
+  for (const auto value : code) {
+    rom[address++] = static_cast<byte>(value);
+  }
+  return rom;
+}
+
+std::vector<word> block_starts(const Recompiler &recompiler) {
+  std::vector<word> starts;
+  for (const auto &entry : recompiler.blocks()) {
+    starts.push_back(entry.first);
+  }
+  return starts;
+}
+
+std::string emitted(const Recompiler &recompiler, const std::string &name) {
+  std::ostringstream out;
+  recompiler.emit(out, name);
+  return out.str();
+}
+
+TEST(Recompiler, ABlockEndsAtTheFirstControlTransfer) {
+  Recompiler recompiler{rom_with({0x3e, 0x01, 0x04, 0xc9, 0x00})};
+
+  recompiler.discover(0x0100);
+
+  ASSERT_EQ(recompiler.blocks().size(), 1);
+  const auto &block = recompiler.blocks().at(0x0100);
+  ASSERT_EQ(block.instructions.size(), 3);
+  EXPECT_EQ(block.instructions[2].address, 0x0103);
+  EXPECT_EQ(block.length(), 4);
+}
+
+TEST(Recompiler, FollowsJumpsCallsAndBranches) {
+  auto rom = rom_with({
+      0xcd, 0x00, 0x02, // CALL 0x0200
+      0x20, 0x02,       // JR NZ,+2
+      0x00,             // NOP
+      0x00,             // NOP
+      0xc3, 0x00, 0x03, // JP 0x0300
+  });
+  rom[0x0200] = byte{0xc9};
+  rom[0x0300] = byte{0xcf};
+
+  Recompiler recompiler{std::move(rom)};
+  recompiler.discover(0x0100);
+
+  EXPECT_EQ(block_starts(recompiler),
+            (std::vector<word>{0x0008, 0x0100, 0x0103, 0x0105, 0x0107, 0x0200,
+                               0x0300, 0x0301}));
+}
+
+TEST(Recompiler, DoesNotFollowJumpsOutOfTheROM) {
+  Recompiler recompiler{rom_with({0xc3, 0x00, 0xc0})};
+
+  recompiler.discover(0x0100);
+  recompiler.discover(0x9000);
+
+  EXPECT_EQ(block_starts(recompiler), std::vector<word>{0x0100});
+}
+
+TEST(Recompiler, StopsDecodingAtTheEndOfTheROM) {
+  Recompiler recompiler{rom_with({0x00, 0x00, 0x01, 0x34}, 0x0100, 0x0104)};
+
+  recompiler.discover(0x0100);
+
+  EXPECT_EQ(recompiler.blocks().at(0x0100).instructions.size(), 2);
+}
+
+TEST(Recompiler, BlocksInTheFixedBankEndWhereItDoes) {
+  // NOP; NOP; then LD A,0x42 and RET in the switchable bank
+  Recompiler recompiler{rom_with({0x00, 0x00, 0x3e, 0x42, 0xc9}, 0x3ffe)};
+
+  recompiler.discover(0x3ffe);
+
+  EXPECT_EQ(block_starts(recompiler), (std::vector<word>{0x3ffe, 0x4000}));
+  EXPECT_EQ(recompiler.blocks().at(0x3ffe).length(), 2);
+  const auto source = emitted(recompiler, "test_rom");
+  EXPECT_NE(source.find("r.pc = word{0x4000};"), std::string::npos);
+  EXPECT_NE(source.find("constexpr byte code_4000[] = {"), std::string::npos);
+}
+
+TEST(Recompiler, InstructionsAcrossTheEndOfTheFixedBankAreLeftOut) {
+  // NOP; then LD A,0x42 with its operand in the switchable bank
+  Recompiler recompiler{rom_with({0x00, 0x3e, 0x42, 0xc9}, 0x3ffe)};
+
+  recompiler.discover(0x3ffe);
+
+  EXPECT_EQ(block_starts(recompiler), std::vector<word>{0x3ffe});
+  EXPECT_EQ(recompiler.blocks().at(0x3ffe).length(), 1);
+  EXPECT_EQ(emitted(recompiler, "test_rom").find("r.set_a(byte{0x42})"),
+            std::string::npos);
+}
+
+TEST(Recompiler, EmitsTheProgramFunctionInTheRequestedNamespace) {
+  Recompiler recompiler{rom_with({0x00})};
+  recompiler.discover(0x0100);
+
+  const auto source = emitted(recompiler, "roms::test_rom");
+
+  EXPECT_NE(source.find("namespace roms {"), std::string::npos);
+  EXPECT_NE(source.find("const greenboy::recompiled::Program &test_rom() "
+                        "noexcept {"),
+            std::string::npos);
+  EXPECT_NE(source.find("cycles block_0100(recompiled::Context &context)"),
+            std::string::npos);
+}
+
+TEST(Recompiler, TranslatesRegisterInstructionsAndInterpretsTheRest) {
+  Recompiler recompiler{rom_with({0x41, 0xcb, 0x37, 0xc9})};
+  recompiler.discover(0x0100);
+
+  const auto source = emitted(recompiler, "test_rom");
+
+  EXPECT_NE(source.find("r.set_b(r.c());"), std::string::npos);
+  EXPECT_NE(source.find("r.pc = word{0x0101};"), std::string::npos);
+  EXPECT_NE(source.find("context.interpreter.execute(byte{0xcb}, operands)"),
+            std::string::npos);
+  EXPECT_NE(source.find("context.interpreter.execute(byte{0xc9}, nullptr)"),
+            std::string::npos);
+}
+
+TEST(Recompiler, KeepsTheCodeOfBlocksInTheSwitchableBank) {
+  Recompiler recompiler{rom_with({0x3c, 0xc9}, 0x4000)};
+  recompiler.discover(0x4000);
+
+  const auto source = emitted(recompiler, "test_rom");
+
+  EXPECT_NE(source.find("constexpr byte code_4000[] = {"), std::string::npos);
+  EXPECT_NE(source.find("{word{0x4000}, block_4000, code_4000, word{0x0002}}"),
+            std::string::npos);
+}
+
+TEST(Recompiler, EmitsAnEmptyProgramWhenNothingWasFound) {
+  Recompiler recompiler{{}};
+
+  const auto source = emitted(recompiler, "test_rom");
+
+  EXPECT_NE(source.find("program{nullptr, 0}"), std::string::npos);
+}
+} // namespace
@@ -0,0 +1,105 @@
+#include "greenboy/switch_cpu.hpp"
+#include "fakes/differential.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <random>
+
+namespace {
+using namespace greenboy;
+
+using Machines = differential::Machines<SwitchCPU>;
+
+std::unique_ptr<Machines>
+random_machines(std::mt19937 &random, bool avoid_terminal = false,
+                FlagEvaluation flags = FlagEvaluation::Eager) {
+  return differential::random_machines<SwitchCPU>(
+      random,
+      [flags](std::unique_ptr<FakeMemoryBus> memory) {
+        return SwitchCPU{std::move(memory), flags};
+      },
+      avoid_terminal ? differential::not_terminal : differential::any_byte);
+}
+
+using differential::expect_same_state;
+
+// Runs a single step on both cores; returns false if the opcode was illegal
+bool step_both(Machines &machines) {
+  cycles expected{};
+  try {
+    expected = machines.reference.update();
+  } catch (const std::runtime_error &) {
+    EXPECT_THROW(machines.cpu.update(), std::runtime_error);
+    return false;
+  }
+  EXPECT_EQ(machines.cpu.update(), expected);
+  return true;
+}
+
+TEST(SwitchCPU, EveryOpcodeMatchesTheFetchExecuteCPU) {
+  std::mt19937 random{0x5eed};
+  for (auto opcode = 0u; opcode < 256u; ++opcode) {
+    for (auto repetition = 0; repetition < 8; ++repetition) {
+      auto machines = random_machines(random);
+      const auto pc = machines->cpu.registers().pc;
+      machines->reference_memory->write(pc, static_cast<byte>(opcode));
+      machines->memory->write(pc, static_cast<byte>(opcode));
+
+      SCOPED_TRACE(opcode);
+      if (step_both(*machines)) {
+        expect_same_state(*machines);
+      }
+    }
+  }
+}
+
+TEST(SwitchCPU, EveryPrefixedOpcodeMatchesTheFetchExecuteCPU) {
+  std::mt19937 random{0xcb};
+  for (auto opcode = 0u; opcode < 256u; ++opcode) {
+    for (auto repetition = 0; repetition < 4; ++repetition) {
+      auto machines = random_machines(random);
+      const auto pc = machines->cpu.registers().pc;
+      const auto operand = static_cast<word>(pc + 1);
+      machines->reference_memory->write(pc, byte{0xcb});
+      machines->memory->write(pc, byte{0xcb});
+      machines->reference_memory->write(operand, static_cast<byte>(opcode));
+      machines->memory->write(operand, static_cast<byte>(opcode));
+
+      SCOPED_TRACE(opcode);
+      ASSERT_TRUE(step_both(*machines));
+      expect_same_state(*machines);
+    }
+  }
+}
+
+TEST(SwitchCPU, RandomProgramsMatchTheFetchExecuteCPU) {
+  std::mt19937 random{0x1234};
+  for (auto program = 0; program < 16; ++program) {
+    auto machines = random_machines(random, true);
+    for (auto step = 0; step < 1000 && step_both(*machines); ++step) {
+      ASSERT_EQ(machines->reference.registers(), machines->cpu.registers());
+      ASSERT_EQ(machines->reference.registers().pc,
+                machines->cpu.registers().pc);
+    }
+    expect_same_state(*machines);
+  }
+}
+
+TEST(SwitchCPU, LazyFlagsMatchTheFetchExecuteCPU) {
+  std::mt19937 random{0x1a2f};
+  for (auto program = 0; program < 16; ++program) {
+    auto machines = random_machines(random, true, FlagEvaluation::Lazy);
+    differential::expect_same_run(*machines, cycles{4000});
+  }
+}
+
+TEST(SwitchCPU, RunExecutesUntilTheBudgetIsSpent) {
+  auto memory = std::make_unique<FakeMemoryBus>();
+  SwitchCPU cpu{std::move(memory)};
+
+  auto time_passed = cpu.run(cycles{10});
+
+  EXPECT_EQ(time_passed, cycles{12});
+  EXPECT_EQ(cpu.registers().pc, word{0x0003});
+}
+} // namespace
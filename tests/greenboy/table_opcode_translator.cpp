@@ -0,0 +1,248 @@
+#include "greenboy/table_opcode_translator.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include "greenboy/instruction.hpp"
+
+#include <algorithm>
+
+namespace {
+using namespace greenboy;
+
+// clang-format off
+constexpr std::array<int, 256> untaken_cycles{
+     4, 12,  8,  8,  4,  4,  8,  4, 20,  8,  8,  8,  4,  4,  8,  4,
+     4, 12,  8,  8,  4,  4,  8,  4, 12,  8,  8,  8,  4,  4,  8,  4,
+     8, 12,  8,  8,  4,  4,  8,  4,  8,  8,  8,  8,  4,  4,  8,  4,
+     8, 12,  8,  8, 12, 12, 12,  4,  8,  8,  8,  8,  4,  4,  8,  4,
+     4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+     4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+     4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+     8,  8,  8,  8,  8,  8,  4,  8,  4,  4,  4,  4,  4,  4,  8,  4,
+     4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+     4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+     4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+     4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+     8, 12, 12, 16, 12, 16,  8, 16,  8, 16, 12,  8, 12, 24,  8, 16,
+     8, 12, 12,  0, 12, 16,  8, 16,  8, 16, 12,  0, 12,  0,  8, 16,
+    12, 12,  8,  0,  0, 16,  8, 16, 16,  4, 16,  0,  0,  0,  8, 16,
+    12, 12,  8,  4,  0, 16,  8, 16, 12,  8, 16,  4,  0,  0,  8, 16,
+};
+// clang-format on
+
+constexpr std::array<int, 11> illegal_opcodes{
+    0xd3, 0xdb, 0xdd, 0xe3, 0xe4, 0xeb, 0xec, 0xed, 0xf4, 0xfc, 0xfd};
+
+bool is_conditional(unsigned opcode) {
+  return (opcode & 0xe7u) == 0x20u || (opcode & 0xe7u) == 0xc0u ||
+         (opcode & 0xe7u) == 0xc2u || (opcode & 0xe7u) == 0xc4u;
+}
+
+CPU::Flags flags_for(unsigned opcode, bool taken) {
+  const auto condition = (opcode >> 3u) & 3u;
+  CPU::Flags f{};
+  const auto satisfied_when_set = (condition & 1u) != 0;
+  if (condition < 2) {
+    f.zero = satisfied_when_set == taken;
+  } else {
+    f.carry = satisfied_when_set == taken;
+  }
+  return f;
+}
+
+cycles execute(byte opcode, CPU::RegisterSet &registers, MemoryBus &memory) {
+  TableOpcodeTranslator translator;
+  return cycles{4} + translator.translate(opcode).execute(registers, memory);
+}
+
+CPU::RegisterSet initial_registers() {
+  CPU::RegisterSet registers{};
+  registers.pc = word{0xc000};
+  registers.sp = word{0xfffe};
+  registers.h = byte{0xd0};
+  return registers;
+}
+
+TEST(TableOpcodeTranslator, UntakenInstructionTimings) {
+  for (auto opcode = 0u; opcode < untaken_cycles.size(); ++opcode) {
+    if (std::find(illegal_opcodes.begin(), illegal_opcodes.end(), opcode) !=
+        illegal_opcodes.end()) {
+      continue;
+    }
+    FakeMemoryBus memory;
+    auto registers = initial_registers();
+    if (is_conditional(opcode)) {
+      registers.f = flags_for(opcode, false);
+    }
+
+    EXPECT_EQ(execute(static_cast<byte>(opcode), registers, memory),
+              cycles{untaken_cycles[opcode]})
+        << "opcode " << opcode;
+  }
+}
+
+TEST(TableOpcodeTranslator, TakenBranchTimings) {
+  for (auto opcode = 0u; opcode < 256u; ++opcode) {
+    if (!is_conditional(opcode)) {
+      continue;
+    }
+    FakeMemoryBus memory;
+    auto registers = initial_registers();
+    registers.f = flags_for(opcode, true);
+
+    const auto is_jump =
+        (opcode & 0xe7u) == 0x20u || (opcode & 0xe7u) == 0xc2u;
+    const auto extra = is_jump ? 4 : 12;
+    EXPECT_EQ(execute(static_cast<byte>(opcode), registers, memory),
+              cycles{untaken_cycles[opcode] + extra})
+        << "opcode " << opcode;
+  }
+}
+
+TEST(TableOpcodeTranslator, PrefixedInstructionTimings) {
+  for (auto opcode = 0u; opcode < 256u; ++opcode) {
+    FakeMemoryBus memory;
+    auto registers = initial_registers();
+    memory.write(registers.pc, static_cast<byte>(opcode));
+
+    auto expected = cycles{8};
+    if ((opcode & 7u) == 6u) {
+      expected = (opcode >> 6u) == 1u ? cycles{12} : cycles{16};
+    }
+    EXPECT_EQ(execute(byte{0xcb}, registers, memory), expected)
+        << "opcode " << opcode;
+  }
+}
+
+TEST(TableOpcodeTranslator, IllegalOpcodesThrow) {
+  for (auto opcode : illegal_opcodes) {
+    FakeMemoryBus memory;
+    auto registers = initial_registers();
+
+    EXPECT_THROW(execute(static_cast<byte>(opcode), registers, memory),
+                 std::runtime_error);
+  }
+}
+
+TEST(TableOpcodeTranslator, TranslatorsShareTheirInstructions) {
+  TableOpcodeTranslator first;
+  TableOpcodeTranslator second;
+
+  for (auto opcode = 0u; opcode < 256u; ++opcode) {
+    EXPECT_EQ(&first.translate(static_cast<byte>(opcode)),
+              &second.translate(static_cast<byte>(opcode)));
+  }
+}
+
+TEST(TableOpcodeTranslator, CallAndReturn) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+  memory.write(word{0xc000}, byte{0x34});
+  memory.write(word{0xc001}, byte{0x12});
+
+  execute(byte{0xcd}, registers, memory);
+
+  EXPECT_EQ(registers.pc, word{0x1234});
+  EXPECT_EQ(registers.sp, word{0xfffc});
+  EXPECT_EQ(memory.read(word{0xfffd}), byte{0xc0});
+  EXPECT_EQ(memory.read(word{0xfffc}), byte{0x02});
+
+  execute(byte{0xc9}, registers, memory);
+
+  EXPECT_EQ(registers.pc, word{0xc002});
+  EXPECT_EQ(registers.sp, word{0xfffe});
+}
+
+TEST(TableOpcodeTranslator, RelativeJumpBackwards) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+  memory.write(word{0xc000}, byte{0xfe});
+
+  execute(byte{0x18}, registers, memory);
+
+  EXPECT_EQ(registers.pc, word{0xbfff});
+}
+
+TEST(TableOpcodeTranslator, PushAndPopAccumulatorAndFlags) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+  registers.a = byte{0x12};
+  registers.f = CPU::Flags{byte{0xa0}};
+
+  execute(byte{0xf5}, registers, memory);
+  registers.a = byte{};
+  registers.f = CPU::Flags{};
+  execute(byte{0xf1}, registers, memory);
+
+  EXPECT_EQ(registers.a, byte{0x12});
+  EXPECT_EQ(registers.f, CPU::Flags{byte{0xa0}});
+  EXPECT_EQ(registers.sp, word{0xfffe});
+}
+
+TEST(TableOpcodeTranslator, IncrementWordRegister) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+  registers.d = byte{0x12};
+  registers.e = byte{0xff};
+
+  execute(byte{0x13}, registers, memory);
+
+  EXPECT_EQ(registers.d, byte{0x13});
+  EXPECT_EQ(registers.e, byte{0x00});
+}
+
+TEST(TableOpcodeTranslator, AddWordRegisterToHL) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+  registers.h = byte{0x8f};
+  registers.l = byte{0xff};
+  registers.b = byte{0x80};
+  registers.c = byte{0x01};
+  registers.f.zero = true;
+
+  execute(byte{0x09}, registers, memory);
+
+  EXPECT_EQ(registers.h, byte{0x10});
+  EXPECT_EQ(registers.l, byte{0x00});
+  EXPECT_TRUE(registers.f.zero);
+  EXPECT_FALSE(registers.f.negate);
+  EXPECT_TRUE(registers.f.half_carry);
+  EXPECT_TRUE(registers.f.carry);
+}
+
+TEST(TableOpcodeTranslator, PrefixedSwapOnMemory) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+  memory.write(word{0xc000}, byte{0x36});
+  memory.write(word{0xd000}, byte{0xa5});
+
+  execute(byte{0xcb}, registers, memory);
+
+  EXPECT_EQ(memory.read(word{0xd000}), byte{0x5a});
+  EXPECT_EQ(registers.pc, word{0xc001});
+}
+
+TEST(TableOpcodeTranslator, PrefixedBitTest) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+  registers.b = byte{0x80};
+  registers.f.carry = true;
+  memory.write(word{0xc000}, byte{0x78});
+
+  execute(byte{0xcb}, registers, memory);
+
+  EXPECT_FALSE(registers.f.zero);
+  EXPECT_FALSE(registers.f.negate);
+  EXPECT_TRUE(registers.f.half_carry);
+  EXPECT_TRUE(registers.f.carry);
+}
+
+TEST(TableOpcodeTranslator, HaltStopsTheProcessor) {
+  FakeMemoryBus memory;
+  auto registers = initial_registers();
+
+  execute(byte{0x76}, registers, memory);
+
+  EXPECT_TRUE(registers.halted);
+}
+} // namespace
@@ -0,0 +1,113 @@
+#include "greenboy/tile_cache.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+using namespace greenboy;
+
+struct System {
+  std::vector<byte> vram = std::vector<byte>(0x2000);
+  PageTableMemoryBus bus;
+  TileCache &tiles;
+
+  System() : tiles(map_vram(bus, vram)) {}
+
+  static TileCache &map_vram(PageTableMemoryBus &bus, std::vector<byte> &vram) {
+    bus.map(0x8000, vram.size(), vram.data());
+    return TileCache::install(bus, vram.data());
+  }
+
+  [[nodiscard]] std::vector<std::uint8_t> row(std::size_t offset,
+                                              bool flipped = false) {
+    const auto *colours = tiles.row(offset, flipped);
+    return {colours, colours + 8};
+  }
+};
+
+TEST(TileCache, DecodesTheRowsOfATile) {
+  System system;
+  system.bus.write(0x8012, byte{0x3c});
+  system.bus.write(0x8013, byte{0x7e});
+
+  EXPECT_EQ(system.row(0x12),
+            (std::vector<std::uint8_t>{0, 2, 3, 3, 3, 3, 2, 0}));
+  EXPECT_EQ(system.row(0x10),
+            (std::vector<std::uint8_t>{0, 0, 0, 0, 0, 0, 0, 0}));
+}
+
+TEST(TileCache, FlippedRowsAreMirrored) {
+  System system;
+  system.bus.write(0x8000, byte{0xc0});
+  system.bus.write(0x8001, byte{0x80});
+
+  EXPECT_EQ(system.row(0x00, true),
+            (std::vector<std::uint8_t>{0, 0, 0, 0, 0, 0, 1, 3}));
+}
+
+TEST(TileCache, ReadsAndWritesReachVRAM) {
+  System system;
+
+  system.bus.write(0x97ff, byte{0x12});
+  system.bus.write(0x9800, byte{0x34});
+
+  EXPECT_EQ(system.vram[0x17ff], byte{0x12});
+  EXPECT_EQ(system.bus.read(0x97ff), byte{0x12});
+  EXPECT_EQ(system.vram[0x1800], byte{0x34});
+}
+
+TEST(TileCache, DecodesEachTileOnlyOnceUntilItIsWritten) {
+  System system;
+  static_cast<void>(system.row(0x00));
+  static_cast<void>(system.row(0x0e, true));
+  static_cast<void>(system.row(0x10));
+  EXPECT_EQ(system.tiles.decodes(), 2);
+
+  system.bus.write(0x8005, byte{0xff});
+  static_cast<void>(system.row(0x10));
+  EXPECT_EQ(system.tiles.decodes(), 2);
+
+  EXPECT_EQ(system.row(0x04),
+            (std::vector<std::uint8_t>{2, 2, 2, 2, 2, 2, 2, 2}));
+  EXPECT_EQ(system.tiles.decodes(), 3);
+}
+
+TEST(TileCache, WritingWhatATileHoldsKeepsItDecoded) {
+  System system;
+  system.bus.write(0x8000, byte{0x12});
+  static_cast<void>(system.row(0x00));
+
+  system.bus.write(0x8000, byte{0x12});
+  static_cast<void>(system.row(0x00));
+
+  EXPECT_EQ(system.tiles.decodes(), 1);
+}
+
+TEST(TileCache, BlockWritesInvalidateEveryTileTheyTouch) {
+  System system;
+  static_cast<void>(system.row(0x00));
+  static_cast<void>(system.row(0x10));
+  const std::vector<byte> block(0x12, byte{0xff});
+
+  system.bus.write_block(0x8000, block.data(), block.size());
+
+  EXPECT_EQ(system.row(0x00),
+            (std::vector<std::uint8_t>{3, 3, 3, 3, 3, 3, 3, 3}));
+  EXPECT_EQ(system.row(0x10),
+            (std::vector<std::uint8_t>{3, 3, 3, 3, 3, 3, 3, 3}));
+  EXPECT_EQ(system.row(0x12),
+            (std::vector<std::uint8_t>{0, 0, 0, 0, 0, 0, 0, 0}));
+  EXPECT_EQ(system.tiles.decodes(), 4);
+}
+
+TEST(TileCache, InvalidateDropsEveryTile) {
+  System system;
+  static_cast<void>(system.row(0x00));
+  system.vram[0x0000] = byte{0xff};
+
+  system.tiles.invalidate();
+
+  EXPECT_EQ(system.row(0x00),
+            (std::vector<std::uint8_t>{1, 1, 1, 1, 1, 1, 1, 1}));
+}
+} // namespace
@@ -0,0 +1,77 @@
+#include "greenboy/tile_decoder.hpp"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+using namespace greenboy;
+using tiles::Kernel;
+
+std::vector<std::uint8_t> decode_bit_by_bit(const std::vector<byte> &planes) {
+  std::vector<std::uint8_t> colours;
+  for (std::size_t row = 0; row < planes.size() / 2; ++row) {
+    const auto low = to_integer<unsigned>(planes[row * 2]);
+    const auto high = to_integer<unsigned>(planes[row * 2 + 1]);
+    for (unsigned bit = 8; bit-- > 0;) {
+      colours.push_back(
+          static_cast<std::uint8_t>((high >> bit & 1u) << 1u |
+                                    (low >> bit & 1u)));
+    }
+  }
+  return colours;
+}
+
+TEST(TileDecoder, DecodesARowLeftmostPixelFirst) {
+  const std::vector<byte> planes{byte{0x3c}, byte{0x7e}};
+  std::vector<std::uint8_t> colours(8);
+
+  tiles::decode(planes.data(), colours.data(), 1);
+
+  EXPECT_EQ(colours, (std::vector<std::uint8_t>{0, 2, 3, 3, 3, 3, 2, 0}));
+}
+
+TEST(TileDecoder, EveryKernelDecodesLikeTheBitByBitDecoder) {
+  std::mt19937 random{42};
+  for (auto kernel : {Kernel::Scalar, Kernel::SSE2, Kernel::AVX2}) {
+    if (!tiles::supported(kernel)) {
+      continue;
+    }
+    const auto decode = tiles::decoder(kernel);
+    // Covers whole blocks of eight rows as well as the rows left over
+    for (std::size_t rows = 0; rows <= 40; ++rows) {
+      std::vector<byte> planes(rows * 2);
+      for (auto &plane : planes) {
+        plane = static_cast<byte>(random());
+      }
+      std::vector<std::uint8_t> colours(rows * 8 + 1, 0xaa);
+
+      decode(planes.data(), colours.data(), rows);
+
+      EXPECT_EQ(colours.back(), 0xaa);
+      colours.pop_back();
+      EXPECT_EQ(colours, decode_bit_by_bit(planes))
+          << static_cast<int>(kernel) << " " << rows;
+    }
+  }
+}
+
+TEST(TileDecoder, TheFastestKernelIsSupported) {
+  EXPECT_TRUE(tiles::supported(Kernel::Scalar));
+  EXPECT_TRUE(tiles::supported(tiles::fastest()));
+}
+
+TEST(TileDecoder, NeverPicksTheSSE2KernelOverTheScalarOne) {
+  EXPECT_NE(tiles::fastest(), Kernel::SSE2);
+}
+
+TEST(TileDecoder, UnsupportedKernelsCannotBeChosen) {
+  for (auto kernel : {Kernel::SSE2, Kernel::AVX2}) {
+    if (!tiles::supported(kernel)) {
+      EXPECT_THROW(static_cast<void>(tiles::decoder(kernel)),
+                   std::runtime_error);
+    }
+  }
+}
+} // namespace
@@ -0,0 +1,140 @@
+#include "greenboy/trace.hpp"
+#include "greenboy/tracing_memory_bus.hpp"
+#include "fakes/memory_bus.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+namespace {
+using namespace greenboy;
+using trace::Access;
+using trace::Record;
+using trace::Region;
+
+TEST(RingBuffer, RecordsComeOutInOrder) {
+  trace::RingBuffer buffer{3};
+  EXPECT_EQ(buffer.capacity(), 4);
+
+  buffer.push(Record{1, 0x1000, 0x0100, byte{0x01}, Access::Read});
+  buffer.push(Record{2, 0x2000, 0x0101, byte{0x02}, Access::Write});
+  std::array<Record, 4> records{};
+
+  ASSERT_EQ(buffer.pop(records.data(), records.size()), 2);
+  EXPECT_EQ(records[0].cycle, 1);
+  EXPECT_EQ(records[1].address, 0x2000);
+  EXPECT_EQ(records[1].access, Access::Write);
+  EXPECT_EQ(buffer.pop(records.data(), records.size()), 0);
+}
+
+TEST(RingBuffer, DropsRecordsWhenFull) {
+  trace::RingBuffer buffer{2};
+
+  EXPECT_TRUE(buffer.push(Record{}));
+  EXPECT_TRUE(buffer.push(Record{}));
+  EXPECT_FALSE(buffer.push(Record{}));
+
+  EXPECT_EQ(buffer.dropped(), 1);
+}
+
+TEST(RingBuffer, PassesEveryRecordBetweenThreads) {
+  constexpr std::uint64_t count = 100'000;
+  trace::RingBuffer buffer{256};
+  std::thread producer{[&] {
+    for (std::uint64_t cycle = 0; cycle < count; ++cycle) {
+      while (!buffer.push(Record{cycle, 0, 0, byte{}, Access::Read})) {
+        std::this_thread::yield();
+      }
+    }
+  }};
+
+  std::uint64_t expected = 0;
+  std::array<Record, 64> records{};
+  while (expected < count) {
+    const auto popped = buffer.pop(records.data(), records.size());
+    for (std::size_t i = 0; i < popped; ++i) {
+      ASSERT_EQ(records[i].cycle, expected++);
+    }
+  }
+  producer.join();
+}
+
+TEST(TracingMemoryBus, RecordsEveryAccessWithItsContext) {
+  trace::RingBuffer buffer{16};
+  TracingMemoryBus bus{std::make_unique<FakeMemoryBus>(), buffer};
+  bus.at(100, 0x0150);
+
+  bus.write(0xc000, byte{0x12});
+  bus.at(104, 0x0152);
+  EXPECT_EQ(bus.read_word(0xc000), word{0x0012});
+
+  std::array<Record, 4> records{};
+  ASSERT_EQ(buffer.pop(records.data(), records.size()), 3);
+  EXPECT_EQ(records[0].cycle, 100);
+  EXPECT_EQ(records[0].pc, 0x0150);
+  EXPECT_EQ(records[0].value, byte{0x12});
+  EXPECT_EQ(records[0].access, Access::Write);
+  EXPECT_EQ(records[2].address, 0xc001);
+  EXPECT_EQ(records[2].pc, 0x0152);
+}
+
+TEST(Trace, TheWriterProducesAFileTheHistogramCanRead) {
+  const auto path = testing::TempDir() + "greenboy_trace.bin";
+  trace::RingBuffer buffer{1024};
+  {
+    trace::Writer writer{buffer, path};
+    buffer.push(Record{1, 0x0100, 0x0100, byte{0x00}, Access::Read});
+    buffer.push(Record{2, 0xc000, 0x0100, byte{0x01}, Access::Write});
+    buffer.push(Record{3, 0xff44, 0x0101, byte{0x90}, Access::Read});
+    buffer.push(Record{4, 0xff80, 0x0101, byte{0x02}, Access::Write});
+    writer.stop();
+    EXPECT_EQ(writer.written(), 4);
+  }
+
+  std::ifstream input{path, std::ios::binary};
+  const auto counts = trace::histogram(input);
+
+  EXPECT_EQ(counts[static_cast<std::size_t>(Region::Rom0)].reads, 1);
+  EXPECT_EQ(counts[static_cast<std::size_t>(Region::Wram)].writes, 1);
+  EXPECT_EQ(counts[static_cast<std::size_t>(Region::Io)].reads, 1);
+  EXPECT_EQ(counts[static_cast<std::size_t>(Region::HighRam)].writes, 1);
+  std::remove(path.c_str());
+}
+
+TEST(Trace, RecordsSurviveTheFileFormat) {
+  std::stringstream stream;
+  {
+    const auto path = testing::TempDir() + "greenboy_round_trip.bin";
+    trace::RingBuffer buffer{4};
+    buffer.push(
+        Record{0x123456789a, 0xfedc, 0xba98, byte{0x76}, Access::Write});
+    trace::Writer writer{buffer, path};
+    writer.stop();
+    std::ifstream input{path, std::ios::binary};
+    stream << input.rdbuf();
+    std::remove(path.c_str());
+  }
+
+  Record record{};
+  ASSERT_TRUE(trace::read(stream, record));
+  EXPECT_EQ(record.cycle, 0x123456789a);
+  EXPECT_EQ(record.address, 0xfedc);
+  EXPECT_EQ(record.pc, 0xba98);
+  EXPECT_EQ(record.value, byte{0x76});
+  EXPECT_EQ(record.access, Access::Write);
+  EXPECT_FALSE(trace::read(stream, record));
+}
+
+TEST(Trace, AddressesAreSortedIntoRegions) {
+  EXPECT_EQ(trace::region_of(0x3fff), Region::Rom0);
+  EXPECT_EQ(trace::region_of(0x4000), Region::RomX);
+  EXPECT_EQ(trace::region_of(0x9fff), Region::Vram);
+  EXPECT_EQ(trace::region_of(0xa000), Region::ExternalRam);
+  EXPECT_EQ(trace::region_of(0xe000), Region::Echo);
+  EXPECT_EQ(trace::region_of(0xfe9f), Region::Oam);
+  EXPECT_EQ(trace::region_of(0xfea0), Region::Unusable);
+  EXPECT_EQ(trace::region_of(0xffff), Region::InterruptEnable);
+  EXPECT_STREQ(trace::name(Region::HighRam), "HRAM");
+}
+} // namespace
@@ -0,0 +1,16 @@
+#include <fstream>
+#include <iostream>
+
+#include "recompiled_rom.hpp"
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    std::cerr << "usage: WriteRecompiledROM OUTPUT\n";
+    return 2;
+  }
+  const auto rom = recompiled_rom_image();
+  std::ofstream output{argv[1], std::ios::binary};
+  output.write(reinterpret_cast<const char *>(rom.data()),
+               static_cast<std::streamsize>(rom.size()));
+  return output ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+// Compiles the code reachable in a ROM to a C++ translation unit for
+// greenboy::RecompiledCPU.
+//
+//   greenboy-recompile [--name NAME] [--entry ADDRESS]... ROM OUTPUT
+//
+// The translation unit defines `const greenboy::recompiled::Program &NAME()
+// noexcept`. Entry points are added to the cartridge entry point and the
+// restart and interrupt vectors.
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "greenboy/recompiler.hpp"
+
+namespace {
+int usage() {
+  std::cerr << "usage: greenboy-recompile [--name NAME] [--entry ADDRESS]... "
+               "ROM OUTPUT\n";
+  return 2;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const std::vector<std::string> arguments(argv + 1, argv + argc);
+  std::string name = "recompiled_program";
+  auto entry_points = greenboy::Recompiler::default_entry_points();
+  std::vector<std::string> files;
+  for (std::size_t i = 0; i < arguments.size(); ++i) {
+    if (arguments[i] == "--name" && i + 1 < arguments.size()) {
+      name = arguments[++i];
+    } else if (arguments[i] == "--entry" && i + 1 < arguments.size()) {
+      std::size_t parsed = 0;
+      unsigned long address = 0;
+      try {
+        address = std::stoul(arguments[++i], &parsed, 0);
+      } catch (const std::exception &) {
+        return usage();
+      }
+      if (parsed != arguments[i].size() || address > 0xffff) {
+        return usage();
+      }
+      entry_points.push_back(static_cast<greenboy::word>(address));
+    } else {
+      files.push_back(arguments[i]);
+    }
+  }
+  if (files.size() != 2) {
+    return usage();
+  }
+
+  std::ifstream input{files[0], std::ios::binary};
+  if (!input) {
+    std::cerr << "greenboy-recompile: cannot read " << files[0] << "\n";
+    return 1;
+  }
+  std::vector<greenboy::byte> rom;
+  for (auto it = std::istreambuf_iterator<char>{input};
+       it != std::istreambuf_iterator<char>{}; ++it) {
+    rom.push_back(static_cast<greenboy::byte>(*it));
+  }
+
+  greenboy::Recompiler recompiler{std::move(rom)};
+  for (const auto entry_point : entry_points) {
+    recompiler.discover(entry_point);
+  }
+
+  std::ofstream output{files[1]};
+  recompiler.emit(output, name);
+  if (!output) {
+    std::cerr << "greenboy-recompile: cannot write " << files[1] << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,32 @@
+// Counts the reads and writes per memory region in a bus trace written by
+// greenboy::trace::Writer.
+//
+//   greenboy-trace-histogram TRACE
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "greenboy/trace.hpp"
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    std::cerr << "usage: greenboy-trace-histogram TRACE\n";
+    return 2;
+  }
+  std::ifstream input{argv[1], std::ios::binary};
+  if (!input) {
+    std::cerr << "greenboy-trace-histogram: cannot read " << argv[1] << "\n";
+    return 1;
+  }
+
+  const auto counts = greenboy::trace::histogram(input);
+  std::cout << std::left << std::setw(14) << "region" << std::right
+            << std::setw(14) << "reads" << std::setw(14) << "writes" << "\n";
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    const auto region = static_cast<greenboy::trace::Region>(i);
+    std::cout << std::left << std::setw(14) << greenboy::trace::name(region)
+              << std::right << std::setw(14) << counts[i].reads
+              << std::setw(14) << counts[i].writes << "\n";
+  }
+  return 0;
+}